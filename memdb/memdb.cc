@@ -0,0 +1,537 @@
+#include "memdb.h"
+#include "utils.h"
+#include "stripe_locks.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+namespace benchmark {
+
+namespace {
+
+using EdgeKey = std::tuple<int64_t, int64_t, int64_t>;
+
+constexpr int NUM_STRIPES = 256;
+constexpr int64_t MIN_ID = std::numeric_limits<int64_t>::min();
+
+struct ObjectStripe {
+  std::shared_mutex mutex;
+  std::unordered_map<int64_t, DB::TimestampValue> rows;
+};
+
+struct EdgeStripe {
+  std::shared_mutex mutex;
+  std::map<EdgeKey, DB::TimestampValue> rows;
+};
+
+struct Store {
+  ObjectStripe objects[NUM_STRIPES];
+  EdgeStripe edges[NUM_STRIPES];
+};
+
+// Outlives every MemDB, so a load phase and a run phase in the same process
+// (taobench -load -run) see the same data.
+Store &GlobalStore() {
+  static Store store;
+  return store;
+}
+
+inline int StripeOf(int64_t id) {
+  return utils::Hash(static_cast<uint64_t>(id)) % NUM_STRIPES;
+}
+
+// Edges are stored under id1, so an insert also has to lock the stripe of
+// id2 to check the reverse-direction keys from GetIncompatibleKeys.
+inline void AddLocks(Store &store, DataTable table, std::vector<DB::Field> const &key,
+                     Operation op, std::vector<std::shared_mutex *> &locks) {
+  if (table == DataTable::Objects) {
+    locks.push_back(&store.objects[StripeOf(key[0].value)].mutex);
+    return;
+  }
+  locks.push_back(&store.edges[StripeOf(key[0].value)].mutex);
+  if (op == Operation::INSERT) {
+    locks.push_back(&store.edges[StripeOf(key[1].value)].mutex);
+  }
+}
+
+inline EdgeKey ToEdgeKey(std::vector<DB::Field> const &key) {
+  assert(key.size() == 3);
+  assert(key[0].name == "id1");
+  assert(key[1].name == "id2");
+  assert(key[2].name == "type");
+  return {key[0].value, key[1].value, key[2].value};
+}
+
+inline std::map<EdgeKey, DB::TimestampValue> &EdgeRows(Store &store, int64_t id1) {
+  return store.edges[StripeOf(id1)].rows;
+}
+
+inline std::unordered_map<int64_t, DB::TimestampValue> &ObjectRows(Store &store, int64_t id) {
+  return store.objects[StripeOf(id)].rows;
+}
+
+// A write applied inside a transaction; previous is empty if the row was absent.
+struct Undo {
+  DataTable table;
+  EdgeKey key; // objects only use the first element
+  std::optional<DB::TimestampValue> previous;
+};
+
+void RollBack(Store &store, std::vector<Undo> const &undo_log) {
+  for (auto it = undo_log.rbegin(); it != undo_log.rend(); ++it) {
+    int64_t id = std::get<0>(it->key);
+    if (it->table == DataTable::Edges) {
+      auto &rows = EdgeRows(store, id);
+      if (it->previous) {
+        rows.insert_or_assign(it->key, *it->previous);
+      } else {
+        rows.erase(it->key);
+      }
+    } else {
+      auto &rows = ObjectRows(store, id);
+      if (it->previous) {
+        rows.insert_or_assign(id, *it->previous);
+      } else {
+        rows.erase(id);
+      }
+    }
+  }
+}
+
+// True if any stored edge matches pattern, a key from GetIncompatibleKeys:
+// id1, optionally narrowed by id2 and/or type.
+bool AnyEdgeMatches(Store &store, std::vector<DB::Field> const &pattern) {
+  int64_t id1 = 0, id2 = 0, type = 0;
+  bool has_id2 = false, has_type = false;
+  for (auto const &field : pattern) {
+    if (field.name == "id1") {
+      id1 = field.value;
+    } else if (field.name == "id2") {
+      id2 = field.value;
+      has_id2 = true;
+    } else if (field.name == "type") {
+      type = field.value;
+      has_type = true;
+    }
+  }
+  auto &rows = EdgeRows(store, id1);
+  if (has_id2 && has_type) {
+    return rows.find({id1, id2, type}) != rows.end();
+  }
+  for (auto it = rows.lower_bound({id1, has_id2 ? id2 : MIN_ID, MIN_ID});
+       it != rows.end() && std::get<0>(it->first) == id1; ++it) {
+    if (has_id2 && std::get<1>(it->first) != id2) {
+      return false;
+    }
+    if (!has_type || std::get<2>(it->first) == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The Do* functions expect the caller to hold the locks from AddLocks.
+
+Status DoRead(Store &store, DataTable table, std::vector<DB::Field> const &key,
+              std::vector<DB::TimestampValue> &buffer) {
+  if (table == DataTable::Edges) {
+    auto &rows = EdgeRows(store, key[0].value);
+    auto it = rows.find(ToEdgeKey(key));
+    if (it == rows.end()) {
+      return Status::kNotFound;
+    }
+    buffer.push_back(it->second);
+  } else {
+    auto &rows = ObjectRows(store, key[0].value);
+    auto it = rows.find(key[0].value);
+    if (it == rows.end()) {
+      return Status::kNotFound;
+    }
+    buffer.push_back(it->second);
+  }
+  return Status::kOK;
+}
+
+Status DoInsert(Store &store, DataTable table, std::vector<DB::Field> const &key,
+                DB::TimestampValue const &value, std::vector<Undo> *undo_log,
+                bool *written = nullptr) {
+  if (written) {
+    *written = true;
+  }
+  if (table == DataTable::Objects) {
+    int64_t id = key[0].value;
+    if (!ObjectRows(store, id).emplace(id, value).second) {
+      return Status::kError; // duplicate primary key
+    }
+    if (undo_log) {
+      undo_log->push_back({table, {id, 0, 0}, std::nullopt});
+    }
+    return Status::kOK;
+  }
+  // like INSERT ... WHERE NOT EXISTS, a blocked insert succeeds without effect
+  for (auto const &incompatible : GetIncompatibleKeys(key)) {
+    if (AnyEdgeMatches(store, incompatible)) {
+      if (written) {
+        *written = false;
+      }
+      return Status::kOK;
+    }
+  }
+  EdgeKey edge = ToEdgeKey(key);
+  if (!EdgeRows(store, key[0].value).emplace(edge, value).second) {
+    return Status::kError;
+  }
+  if (undo_log) {
+    undo_log->push_back({table, edge, std::nullopt});
+  }
+  return Status::kOK;
+}
+
+// Updates and deletes only apply over an older timestamp; otherwise, or if the
+// row is missing, they succeed without effect.
+Status DoUpdate(Store &store, DataTable table, std::vector<DB::Field> const &key,
+                DB::TimestampValue const &value, std::vector<Undo> *undo_log) {
+  if (table == DataTable::Edges) {
+    auto &rows = EdgeRows(store, key[0].value);
+    auto it = rows.find(ToEdgeKey(key));
+    if (it == rows.end() || it->second.timestamp >= value.timestamp) {
+      return Status::kOK;
+    }
+    if (undo_log) {
+      undo_log->push_back({table, it->first, it->second});
+    }
+    it->second = value;
+  } else {
+    auto &rows = ObjectRows(store, key[0].value);
+    auto it = rows.find(key[0].value);
+    if (it == rows.end() || it->second.timestamp >= value.timestamp) {
+      return Status::kOK;
+    }
+    if (undo_log) {
+      undo_log->push_back({table, {it->first, 0, 0}, it->second});
+    }
+    it->second = value;
+  }
+  return Status::kOK;
+}
+
+Status DoDelete(Store &store, DataTable table, std::vector<DB::Field> const &key,
+                DB::TimestampValue const &value, std::vector<Undo> *undo_log) {
+  if (table == DataTable::Edges) {
+    auto &rows = EdgeRows(store, key[0].value);
+    auto it = rows.find(ToEdgeKey(key));
+    if (it == rows.end() || it->second.timestamp >= value.timestamp) {
+      return Status::kOK;
+    }
+    if (undo_log) {
+      undo_log->push_back({table, it->first, it->second});
+    }
+    rows.erase(it);
+  } else {
+    auto &rows = ObjectRows(store, key[0].value);
+    auto it = rows.find(key[0].value);
+    if (it == rows.end() || it->second.timestamp >= value.timestamp) {
+      return Status::kOK;
+    }
+    if (undo_log) {
+      undo_log->push_back({table, {it->first, 0, 0}, it->second});
+    }
+    rows.erase(it);
+  }
+  return Status::kOK;
+}
+
+// Edges of id1 in key order.
+template <typename Visit>
+void ForEachEdge(Store &store, int64_t id1, Visit visit) {
+  auto &rows = EdgeRows(store, id1);
+  for (auto it = rows.lower_bound({id1, MIN_ID, MIN_ID});
+       it != rows.end() && std::get<0>(it->first) == id1 && visit(it->first, it->second); ++it) {
+  }
+}
+
+Status DoRangeRead(Store &store, int64_t id1, int limit, std::vector<DB::TimestampValue> &buffer) {
+  int found = 0;
+  ForEachEdge(store, id1, [&](EdgeKey const &, DB::TimestampValue const &value) {
+    if (found++ >= limit) {
+      return false;
+    }
+    buffer.push_back(value);
+    return true;
+  });
+  return Status::kOK;
+}
+
+Status DoCountRead(Store &store, int64_t id1, int64_t type, int64_t &count) {
+  count = 0;
+  ForEachEdge(store, id1, [&](EdgeKey const &key, DB::TimestampValue const &) {
+    count += std::get<2>(key) == type;
+    return true;
+  });
+  return Status::kOK;
+}
+
+// Edges are not indexed by timestamp, so this sorts the matches of id1.
+Status DoTimeRangeRead(Store &store, int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<DB::TimestampValue> &buffer) {
+  std::vector<DB::TimestampValue const *> matches;
+  ForEachEdge(store, id1, [&](EdgeKey const &key, DB::TimestampValue const &value) {
+    if (std::get<2>(key) == type && value.timestamp >= min_timestamp
+        && value.timestamp <= max_timestamp) {
+      matches.push_back(&value);
+    }
+    return true;
+  });
+  auto newer = [](DB::TimestampValue const *a, DB::TimestampValue const *b) {
+    return a->timestamp > b->timestamp;
+  };
+  size_t n = std::min(matches.size(), static_cast<size_t>(std::max(limit, 0)));
+  std::partial_sort(matches.begin(), matches.begin() + n, matches.end(), newer);
+  for (size_t i = 0; i < n; ++i) {
+    buffer.push_back(*matches[i]);
+  }
+  return Status::kOK;
+}
+
+// Same as ExecuteEdgeQuery, on a store whose locks are held.
+Status DoEdgeQuery(Store &store, DB::DB_Operation const &op,
+                   std::vector<DB::TimestampValue> &buffer) {
+  int64_t id1 = op.key[0].value;
+  switch (op.operation) {
+    case Operation::RANGEREAD:
+      return DoRangeRead(store, id1, op.limit, buffer);
+    case Operation::COUNTREAD: {
+      int64_t count = 0;
+      DoCountRead(store, id1, op.key[1].value, count);
+      buffer.emplace_back(count, "");
+      return Status::kOK;
+    }
+    case Operation::TIMERANGEREAD:
+      return DoTimeRangeRead(store, id1, op.key[1].value, op.min_timestamp, op.max_timestamp,
+                             op.limit, buffer);
+    default:
+      return Status::kNotImplemented;
+  }
+}
+
+inline std::vector<std::shared_mutex *> LocksFor(Store &store, DataTable table,
+                                                 std::vector<DB::Field> const &key, Operation op) {
+  std::vector<std::shared_mutex *> locks;
+  AddLocks(store, table, key, op, locks);
+  return locks;
+}
+
+} // namespace
+
+void MemDB::Init() {
+  GlobalStore();
+}
+
+void MemDB::Cleanup() {
+}
+
+Status MemDB::Read(DataTable table, const std::vector<Field> &key,
+                   std::vector<TimestampValue> &buffer) {
+  Store &store = GlobalStore();
+  StripeLocks locks(LocksFor(store, table, key, Operation::READ), false);
+  return DoRead(store, table, key, buffer);
+}
+
+Status MemDB::Scan(DataTable table, const std::vector<Field> &key, int n,
+                   std::vector<TimestampValue> &buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  Store &store = GlobalStore();
+  StripeLocks locks(LocksFor(store, table, key, Operation::SCAN), false);
+  auto &rows = EdgeRows(store, key[0].value);
+  int found = 0;
+  for (auto it = rows.lower_bound(ToEdgeKey(key));
+       found < n && it != rows.end() && std::get<0>(it->first) == key[0].value;
+       ++it, ++found) {
+    buffer.push_back(it->second);
+  }
+  return Status::kOK;
+}
+
+Status MemDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  Store &store = GlobalStore();
+  StripeLocks locks({&store.edges[StripeOf(id1)].mutex}, false);
+  return DoRangeRead(store, id1, limit, buffer);
+}
+
+Status MemDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  Store &store = GlobalStore();
+  StripeLocks locks({&store.edges[StripeOf(id1)].mutex}, false);
+  return DoCountRead(store, id1, type, count);
+}
+
+Status MemDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                            int64_t max_timestamp, int limit,
+                            std::vector<TimestampValue> &buffer) {
+  Store &store = GlobalStore();
+  StripeLocks locks({&store.edges[StripeOf(id1)].mutex}, false);
+  return DoTimeRangeRead(store, id1, type, min_timestamp, max_timestamp, limit, buffer);
+}
+
+Status MemDB::Update(DataTable table, const std::vector<Field> &key,
+                     TimestampValue const &value) {
+  Store &store = GlobalStore();
+  StripeLocks locks(LocksFor(store, table, key, Operation::UPDATE), true);
+  return DoUpdate(store, table, key, value, nullptr);
+}
+
+Status MemDB::Insert(DataTable table, const std::vector<Field> &key,
+                     TimestampValue const &value) {
+  Store &store = GlobalStore();
+  StripeLocks locks(LocksFor(store, table, key, Operation::INSERT), true);
+  return DoInsert(store, table, key, value, nullptr);
+}
+
+Status MemDB::Delete(DataTable table, const std::vector<Field> &key,
+                     TimestampValue const &value) {
+  Store &store = GlobalStore();
+  StripeLocks locks(LocksFor(store, table, key, Operation::DELETE), true);
+  return DoDelete(store, table, key, value, nullptr);
+}
+
+Status MemDB::Execute(const DB_Operation &operation,
+                      std::vector<TimestampValue> &read_buffer,
+                      bool txn_op) {
+  switch (operation.operation) {
+    case Operation::READ:
+      return Read(operation.table, operation.key, read_buffer);
+    case Operation::INSERT: {
+      Store &store = GlobalStore();
+      StripeLocks locks(LocksFor(store, operation.table, operation.key, Operation::INSERT), true);
+      return DoInsert(store, operation.table, operation.key, operation.time_and_value, nullptr,
+                      &operation.written);
+    }
+    case Operation::UPDATE:
+      return Update(operation.table, operation.key, operation.time_and_value);
+    case Operation::DELETE:
+      return Delete(operation.table, operation.key, operation.time_and_value);
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD:
+      return ExecuteEdgeQuery(*this, operation, read_buffer);
+    default:
+      std::cerr << "invalid operation" << std::endl;
+      return Status::kNotImplemented;
+  }
+}
+
+Status MemDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                 std::vector<TimestampValue> &read_buffer,
+                                 bool read_only) {
+  Store &store = GlobalStore();
+  std::vector<std::shared_mutex *> lock_ids;
+  for (auto const &op : operations) {
+    AddLocks(store, op.table, op.key, op.operation, lock_ids);
+  }
+  StripeLocks locks(std::move(lock_ids), !read_only);
+
+  std::vector<Undo> undo_log;
+  for (auto const &op : operations) {
+    Status s;
+    switch (op.operation) {
+      case Operation::READ:
+        s = DoRead(store, op.table, op.key, read_buffer);
+        if (s == Status::kNotFound) {
+          s = Status::kOK;
+        }
+        break;
+      case Operation::INSERT:
+        s = DoInsert(store, op.table, op.key, op.time_and_value, &undo_log, &op.written);
+        break;
+      case Operation::UPDATE:
+        s = DoUpdate(store, op.table, op.key, op.time_and_value, &undo_log);
+        break;
+      case Operation::DELETE:
+        s = DoDelete(store, op.table, op.key, op.time_and_value, &undo_log);
+        break;
+      case Operation::RANGEREAD:
+      case Operation::COUNTREAD:
+      case Operation::TIMERANGEREAD:
+        s = DoEdgeQuery(store, op, read_buffer);
+        break;
+      default:
+        std::cerr << "invalid operation" << std::endl;
+        s = Status::kNotImplemented;
+    }
+    if (s != Status::kOK) {
+      RollBack(store, undo_log);
+      return s;
+    }
+  }
+  return Status::kOK;
+}
+
+Status MemDB::BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                          std::vector<TimestampValue> const &values) {
+  Store &store = GlobalStore();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    int64_t id = keys[i][0].value;
+    if (table == DataTable::Edges) {
+      StripeLocks locks({&store.edges[StripeOf(id)].mutex}, true);
+      EdgeRows(store, id).emplace(ToEdgeKey(keys[i]), values[i]);
+    } else {
+      StripeLocks locks({&store.objects[StripeOf(id)].mutex}, true);
+      ObjectRows(store, id).emplace(id, values[i]);
+    }
+  }
+  return Status::kOK;
+}
+
+Status MemDB::BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                        const std::vector<Field> &ceiling_key, int n,
+                        std::vector<std::vector<Field>> &key_buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  Store &store = GlobalStore();
+  EdgeKey floor = ToEdgeKey(floor_key);
+  EdgeKey ceiling = ToEdgeKey(ceiling_key);
+
+  std::vector<std::shared_mutex *> lock_ids;
+  for (auto &stripe : store.edges) {
+    lock_ids.push_back(&stripe.mutex);
+  }
+  StripeLocks locks(std::move(lock_ids), false);
+
+  // k-way merge of the stripes, which are each sorted but interleave in key order
+  using Cursor = std::pair<std::map<EdgeKey, TimestampValue>::const_iterator,
+                           std::map<EdgeKey, TimestampValue>::const_iterator>;
+  auto later = [](Cursor const &a, Cursor const &b) { return a.first->first > b.first->first; };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> cursors(later);
+  for (auto &stripe : store.edges) {
+    auto it = stripe.rows.upper_bound(floor);
+    if (it != stripe.rows.end() && it->first < ceiling) {
+      cursors.push({it, stripe.rows.cend()});
+    }
+  }
+  for (int read = 0; read < n && !cursors.empty(); ++read) {
+    Cursor cursor = cursors.top();
+    cursors.pop();
+    auto const &[id1, id2, type] = cursor.first->first;
+    key_buffer.push_back({{"id1", id1}, {"id2", id2}, {"type", type}});
+    if (++cursor.first != cursor.second && cursor.first->first < ceiling) {
+      cursors.push(cursor);
+    }
+  }
+  return Status::kOK;
+}
+
+DB *NewMemDB() {
+  return new MemDB;
+}
+
+const bool registered = DBFactory::RegisterDB("memdb", NewMemDB);
+
+} // benchmark
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "db.h"
+#include "properties.h"
+#include "db_factory.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+///
+/// In-process graph store with no external dependencies, for measuring the
+/// harness's own ceiling and for running the benchmark locally.
+///
+/// All MemDB instances share one process-wide store, lock-striped by key hash.
+/// Edges are kept ordered by (id1, id2, type) within each stripe, so BatchRead
+/// and Scan iterate in key order. Edge inserts enforce GetIncompatibleKeys,
+/// and updates and deletes only apply over an older timestamp, as in the SQL
+/// drivers. Transactions lock every stripe they touch up front and are
+/// therefore serializable; a failed write rolls back the ones before it.
+///
+class MemDB : public DB {
+ public:
+  void Init();
+
+  void Cleanup();
+
+  Status Read(DataTable table, const std::vector<Field> &key,
+              std::vector<TimestampValue> &buffer);
+
+  // Returns up to n edges with the id1 of key, starting at key, in key order.
+  Status Scan(DataTable table, const std::vector<Field> &key, int n,
+              std::vector<TimestampValue> &buffer);
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer);
+
+  Status Update(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer,
+                            bool read_only);
+
+  // Inserts keys that are not present yet, without constraint checks, like
+  // the bulk inserts of the other drivers.
+  Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                     std::vector<TimestampValue> const &values);
+
+  Status BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                   const std::vector<Field> &ceiling_key, int n,
+                   std::vector<std::vector<Field>> &key_buffer);
+};
+
+DB *NewMemDB();
+
+} // benchmark
@@ -0,0 +1,631 @@
+#include "mvcc_db.h"
+#include "utils.h"
+#include "stripe_locks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+namespace benchmark {
+
+namespace {
+
+using EdgeKey = std::tuple<int64_t, int64_t, int64_t>;
+
+constexpr int NUM_STRIPES = 256;
+constexpr int64_t MIN_ID = std::numeric_limits<int64_t>::min();
+constexpr uint64_t LATEST = std::numeric_limits<uint64_t>::max();
+
+const std::string COMMIT_LATENCY_US = "mvccdb.commit_latency_us";
+const std::string LOCK_HOLD_US = "mvccdb.lock_hold_us";
+const std::string MAX_VERSIONS = "mvccdb.max_versions";
+const int DEFAULT_MAX_VERSIONS = 16;
+
+struct Version {
+  uint64_t commit_ts;
+  std::optional<DB::TimestampValue> value; // empty for a delete
+};
+
+// Committed versions of one key, oldest first.
+struct Chain {
+  std::vector<Version> versions;
+  // Set once old versions have been dropped; snapshots older than the first
+  // remaining version can no longer be served from this chain.
+  bool pruned = false;
+};
+
+struct ObjectStripe {
+  std::shared_mutex mutex;
+  std::unordered_map<int64_t, Chain> rows;
+};
+
+struct EdgeStripe {
+  std::shared_mutex mutex;
+  std::map<EdgeKey, Chain> rows;
+};
+
+struct Store {
+  ObjectStripe objects[NUM_STRIPES];
+  EdgeStripe edges[NUM_STRIPES];
+  // Timestamp of the latest commit. A commit takes its timestamp while holding
+  // the stripes it writes, so a reader whose snapshot includes the commit
+  // either waits for those stripes or finds the new versions installed.
+  std::atomic<uint64_t> clock{0};
+  std::atomic<size_t> max_versions{DEFAULT_MAX_VERSIONS};
+};
+
+// Outlives every MvccDB, so that load and run phases in one process share data.
+Store &GlobalStore() {
+  static Store store;
+  return store;
+}
+
+// Raised when a snapshot needs a version that has been pruned, and reported
+// as a contention error so the client retries with a fresh snapshot.
+struct SnapshotTooOld {};
+
+inline int StripeOf(int64_t id) {
+  return utils::Hash(static_cast<uint64_t>(id)) % NUM_STRIPES;
+}
+
+inline std::shared_mutex &StripeMutex(Store &store, DataTable table, int64_t id) {
+  return table == DataTable::Edges ? store.edges[StripeOf(id)].mutex
+                                   : store.objects[StripeOf(id)].mutex;
+}
+
+inline EdgeKey ToEdgeKey(DataTable table, std::vector<DB::Field> const &key) {
+  if (table == DataTable::Objects) {
+    assert(key.size() == 1);
+    return {key[0].value, 0, 0};
+  }
+  assert(key.size() == 3);
+  assert(key[0].name == "id1");
+  assert(key[1].name == "id2");
+  assert(key[2].name == "type");
+  return {key[0].value, key[1].value, key[2].value};
+}
+
+// The caller holds the stripe of key. Returns nullptr if the key was never written.
+Chain *FindChain(Store &store, DataTable table, EdgeKey const &key) {
+  int64_t id = std::get<0>(key);
+  if (table == DataTable::Edges) {
+    auto &rows = store.edges[StripeOf(id)].rows;
+    auto it = rows.find(key);
+    return it == rows.end() ? nullptr : &it->second;
+  }
+  auto &rows = store.objects[StripeOf(id)].rows;
+  auto it = rows.find(id);
+  return it == rows.end() ? nullptr : &it->second;
+}
+
+Chain &ChainFor(Store &store, DataTable table, EdgeKey const &key) {
+  int64_t id = std::get<0>(key);
+  if (table == DataTable::Edges) {
+    return store.edges[StripeOf(id)].rows[key];
+  }
+  return store.objects[StripeOf(id)].rows[id];
+}
+
+// The value of chain as of snapshot, or nullptr if the key was absent or deleted.
+DB::TimestampValue const *Visible(Chain const &chain, uint64_t snapshot) {
+  for (auto it = chain.versions.rbegin(); it != chain.versions.rend(); ++it) {
+    if (it->commit_ts <= snapshot) {
+      return it->value ? &*it->value : nullptr;
+    }
+  }
+  if (chain.pruned) {
+    throw SnapshotTooOld{};
+  }
+  return nullptr;
+}
+
+void Install(Chain &chain, uint64_t commit_ts, std::optional<DB::TimestampValue> value,
+             size_t max_versions) {
+  chain.versions.push_back(Version{commit_ts, std::move(value)});
+  if (chain.versions.size() > max_versions) {
+    chain.versions.erase(chain.versions.begin(),
+                         chain.versions.end() - max_versions);
+    chain.pruned = true;
+  }
+}
+
+// A key from GetIncompatibleKeys: id1, optionally narrowed by id2 and/or type.
+struct EdgePattern {
+  explicit EdgePattern(std::vector<DB::Field> const &pattern) {
+    for (auto const &field : pattern) {
+      if (field.name == "id1") {
+        id1 = field.value;
+      } else if (field.name == "id2") {
+        id2 = field.value;
+        has_id2 = true;
+      } else if (field.name == "type") {
+        type = field.value;
+        has_type = true;
+      }
+    }
+  }
+
+  bool Matches(EdgeKey const &key) const {
+    return std::get<0>(key) == id1
+        && (!has_id2 || std::get<1>(key) == id2)
+        && (!has_type || std::get<2>(key) == type);
+  }
+
+  // Calls f on each stored key matching the pattern until it returns true.
+  // The caller holds the stripe of id1.
+  template <typename F>
+  bool AnyStored(Store &store, F f) const {
+    auto &rows = store.edges[StripeOf(id1)].rows;
+    for (auto it = rows.lower_bound({id1, has_id2 ? id2 : MIN_ID, MIN_ID});
+         it != rows.end() && std::get<0>(it->first) == id1; ++it) {
+      if (has_id2 && std::get<1>(it->first) != id2) {
+        break;
+      }
+      if (Matches(it->first) && f(it->first, it->second)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int64_t id1 = 0, id2 = 0, type = 0;
+  bool has_id2 = false, has_type = false;
+};
+
+struct PendingWrite {
+  std::optional<DB::TimestampValue> value; // empty for a delete
+  // Inserted edges re-check GetIncompatibleKeys at commit.
+  bool insert = false;
+};
+
+///
+/// Reads at the snapshot taken on construction and buffers writes until
+/// Commit. Reads see the transaction's own writes.
+///
+class Transaction {
+ public:
+  explicit Transaction(Store &store)
+    : store_(store)
+    , snapshot_(store.clock.load())
+  {
+  }
+
+  Status Read(DataTable table, std::vector<DB::Field> const &key,
+              std::vector<DB::TimestampValue> &buffer) {
+    std::optional<DB::TimestampValue> value = Get(table, ToEdgeKey(table, key));
+    if (!value) {
+      return Status::kNotFound;
+    }
+    buffer.push_back(std::move(*value));
+    return Status::kOK;
+  }
+
+  // RANGEREAD, COUNTREAD or TIMERANGEREAD over the edges of one id1, with
+  // the same results as MemDB. Like Scan, these reads are not validated at
+  // commit.
+  Status EdgeQuery(DB::DB_Operation const &op, std::vector<DB::TimestampValue> &buffer) {
+    std::map<EdgeKey, DB::TimestampValue> edges = Edges(op.key[0].value);
+    switch (op.operation) {
+      case Operation::RANGEREAD: {
+        int found = 0;
+        for (auto it = edges.begin(); it != edges.end() && found < op.limit; ++it, ++found) {
+          buffer.push_back(it->second);
+        }
+        return Status::kOK;
+      }
+      case Operation::COUNTREAD: {
+        int64_t count = 0;
+        for (auto const &[key, value] : edges) {
+          count += std::get<2>(key) == op.key[1].value;
+        }
+        buffer.emplace_back(count, "");
+        return Status::kOK;
+      }
+      case Operation::TIMERANGEREAD: {
+        std::vector<DB::TimestampValue> matches;
+        for (auto const &[key, value] : edges) {
+          if (std::get<2>(key) == op.key[1].value && value.timestamp >= op.min_timestamp
+              && value.timestamp <= op.max_timestamp) {
+            matches.push_back(value);
+          }
+        }
+        size_t n = std::min(matches.size(), static_cast<size_t>(std::max(op.limit, 0)));
+        std::partial_sort(matches.begin(), matches.begin() + n, matches.end(),
+                          [](DB::TimestampValue const &a, DB::TimestampValue const &b) {
+                            return a.timestamp > b.timestamp;
+                          });
+        buffer.insert(buffer.end(), matches.begin(), matches.begin() + n);
+        return Status::kOK;
+      }
+      default:
+        return Status::kNotImplemented;
+    }
+  }
+
+  // Same outcomes as MemDB: a blocked edge insert succeeds without effect,
+  // clearing @param written, and a duplicate primary key is an error.
+  Status Insert(DataTable table, std::vector<DB::Field> const &key,
+                DB::TimestampValue const &value, bool &written) {
+    EdgeKey k = ToEdgeKey(table, key);
+    written = true;
+    if (table == DataTable::Edges) {
+      for (auto const &incompatible : GetIncompatibleKeys(key)) {
+        if (AnyEdgeMatches(EdgePattern(incompatible))) {
+          written = false;
+          return Status::kOK;
+        }
+      }
+    }
+    if (Get(table, k)) {
+      return Status::kError;
+    }
+    PendingWrite &write = writes_[{table, k}];
+    write.value = value;
+    write.insert = true;
+    return Status::kOK;
+  }
+
+  // Updates and deletes only apply over an older timestamp.
+  Status Write(DataTable table, std::vector<DB::Field> const &key,
+               DB::TimestampValue const &value, bool remove) {
+    EdgeKey k = ToEdgeKey(table, key);
+    std::optional<DB::TimestampValue> current = Get(table, k);
+    if (!current || current->timestamp >= value.timestamp) {
+      return Status::kOK;
+    }
+    PendingWrite &write = writes_[{table, k}];
+    if (remove) {
+      write.value.reset();
+    } else {
+      write.value = value;
+    }
+    return Status::kOK;
+  }
+
+  // Validates and installs the buffered writes, or returns
+  // Status::kContentionError if another transaction committed first.
+  Status Commit(std::chrono::microseconds latency, std::chrono::microseconds hold) {
+    if (writes_.empty()) {
+      return Status::kOK;
+    }
+    if (latency.count() > 0) {
+      std::this_thread::sleep_for(latency);
+    }
+    std::vector<std::shared_mutex *> mutexes;
+    for (auto const &[key, write] : writes_) {
+      mutexes.push_back(&StripeMutex(store_, key.first, std::get<0>(key.second)));
+      if (write.insert && key.first == DataTable::Edges) {
+        mutexes.push_back(&StripeMutex(store_, key.first, std::get<1>(key.second)));
+      }
+    }
+    StripeLocks locks(std::move(mutexes), true);
+
+    for (auto const &[key, write] : writes_) {
+      Chain const *chain = FindChain(store_, key.first, key.second);
+      if (chain && !chain->versions.empty() && chain->versions.back().commit_ts > snapshot_) {
+        return Status::kContentionError;
+      }
+      if (write.insert && key.first == DataTable::Edges && write.value) {
+        auto const &[id1, id2, type] = key.second;
+        for (auto const &incompatible : GetIncompatibleKeys({{"id1", id1}, {"id2", id2}, {"type", type}})) {
+          if (CommittedSinceSnapshot(EdgePattern(incompatible))) {
+            return Status::kContentionError;
+          }
+        }
+      }
+    }
+
+    uint64_t commit_ts = store_.clock.fetch_add(1) + 1;
+    size_t max_versions = store_.max_versions.load();
+    for (auto &[key, write] : writes_) {
+      Install(ChainFor(store_, key.first, key.second), commit_ts, std::move(write.value),
+              max_versions);
+    }
+    if (hold.count() > 0) {
+      std::this_thread::sleep_for(hold);
+    }
+    return Status::kOK;
+  }
+
+ private:
+  using WriteKey = std::pair<DataTable, EdgeKey>;
+
+  std::optional<DB::TimestampValue> Get(DataTable table, EdgeKey const &key) {
+    auto pending = writes_.find({table, key});
+    if (pending != writes_.end()) {
+      return pending->second.value;
+    }
+    std::shared_lock<std::shared_mutex> lock(StripeMutex(store_, table, std::get<0>(key)));
+    Chain const *chain = FindChain(store_, table, key);
+    DB::TimestampValue const *value = chain ? Visible(*chain, snapshot_) : nullptr;
+    return value ? std::optional<DB::TimestampValue>(*value) : std::nullopt;
+  }
+
+  // The edges of id1 as of the snapshot, with this transaction's writes applied.
+  std::map<EdgeKey, DB::TimestampValue> Edges(int64_t id1) {
+    std::map<EdgeKey, DB::TimestampValue> edges;
+    {
+      std::shared_lock<std::shared_mutex> lock(StripeMutex(store_, DataTable::Edges, id1));
+      EdgePattern({{"id1", id1}}).AnyStored(store_, [&](EdgeKey const &key, Chain const &chain) {
+        if (DB::TimestampValue const *value = Visible(chain, snapshot_)) {
+          edges.emplace(key, *value);
+        }
+        return false;
+      });
+    }
+    for (auto it = writes_.lower_bound({DataTable::Edges, {id1, MIN_ID, MIN_ID}});
+         it != writes_.end() && it->first.first == DataTable::Edges
+             && std::get<0>(it->first.second) == id1;
+         ++it) {
+      if (it->second.value) {
+        edges.insert_or_assign(it->first.second, *it->second.value);
+      } else {
+        edges.erase(it->first.second);
+      }
+    }
+    return edges;
+  }
+
+  bool AnyEdgeMatches(EdgePattern const &pattern) {
+    for (auto const &[key, write] : writes_) {
+      if (key.first == DataTable::Edges && write.value && pattern.Matches(key.second)) {
+        return true;
+      }
+    }
+    std::shared_lock<std::shared_mutex> lock(StripeMutex(store_, DataTable::Edges, pattern.id1));
+    return pattern.AnyStored(store_, [&](EdgeKey const &key, Chain const &chain) {
+      return writes_.count({DataTable::Edges, key}) == 0 && Visible(chain, snapshot_);
+    });
+  }
+
+  // Whether another transaction has committed a live edge matching pattern
+  // since the snapshot. Older ones were already seen by AnyEdgeMatches.
+  bool CommittedSinceSnapshot(EdgePattern const &pattern) {
+    return pattern.AnyStored(store_, [&](EdgeKey const &key, Chain const &chain) {
+      return writes_.count({DataTable::Edges, key}) == 0
+          && !chain.versions.empty()
+          && chain.versions.back().commit_ts > snapshot_
+          && chain.versions.back().value;
+    });
+  }
+
+  Store &store_;
+  uint64_t snapshot_;
+  std::map<WriteKey, PendingWrite> writes_;
+};
+
+} // namespace
+
+void MvccDB::Init() {
+  Store &store = GlobalStore();
+  commit_latency_ = std::chrono::microseconds(
+      std::stoll(props_->GetProperty(COMMIT_LATENCY_US, "0")));
+  lock_hold_ = std::chrono::microseconds(
+      std::stoll(props_->GetProperty(LOCK_HOLD_US, "0")));
+  int max_versions = std::stoi(props_->GetProperty(MAX_VERSIONS,
+                                                   std::to_string(DEFAULT_MAX_VERSIONS)));
+  if (max_versions < 1) {
+    throw std::invalid_argument(MAX_VERSIONS + " must be at least 1");
+  }
+  store.max_versions = max_versions;
+}
+
+void MvccDB::Cleanup() {
+}
+
+Status MvccDB::Read(DataTable table, const std::vector<Field> &key,
+                    std::vector<TimestampValue> &buffer) {
+  return Run({DB_Operation(table, key, TimestampValue(0, ""), Operation::READ)}, buffer, false);
+}
+
+Status MvccDB::Scan(DataTable table, const std::vector<Field> &key, int n,
+                    std::vector<TimestampValue> &buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  Store &store = GlobalStore();
+  uint64_t snapshot = store.clock.load();
+  std::shared_lock<std::shared_mutex> lock(StripeMutex(store, table, key[0].value));
+  auto &rows = store.edges[StripeOf(key[0].value)].rows;
+  int found = 0;
+  try {
+    for (auto it = rows.lower_bound(ToEdgeKey(table, key));
+         found < n && it != rows.end() && std::get<0>(it->first) == key[0].value; ++it) {
+      if (TimestampValue const *value = Visible(it->second, snapshot)) {
+        buffer.push_back(*value);
+        ++found;
+      }
+    }
+  } catch (SnapshotTooOld const &) {
+    return Status::kContentionError;
+  }
+  return Status::kOK;
+}
+
+Status MvccDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}}, TimestampValue(0, ""), Operation::RANGEREAD);
+  op.limit = limit;
+  return Run({op}, buffer, false);
+}
+
+Status MvccDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  std::vector<TimestampValue> result;
+  Status s = Run({DB_Operation(DataTable::Edges, {{"id1", id1}, {"type", type}},
+                               TimestampValue(0, ""), Operation::COUNTREAD)},
+                 result, false);
+  if (s == Status::kOK) {
+    count = result[0].timestamp;
+  }
+  return s;
+}
+
+Status MvccDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                             int64_t max_timestamp, int limit,
+                             std::vector<TimestampValue> &buffer) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}, {"type", type}}, TimestampValue(0, ""),
+                  Operation::TIMERANGEREAD);
+  op.limit = limit;
+  op.min_timestamp = min_timestamp;
+  op.max_timestamp = max_timestamp;
+  return Run({op}, buffer, false);
+}
+
+Status MvccDB::Update(DataTable table, const std::vector<Field> &key,
+                      TimestampValue const &value) {
+  std::vector<TimestampValue> unused;
+  return Run({DB_Operation(table, key, value, Operation::UPDATE)}, unused, false);
+}
+
+Status MvccDB::Insert(DataTable table, const std::vector<Field> &key,
+                      TimestampValue const &value) {
+  std::vector<TimestampValue> unused;
+  return Run({DB_Operation(table, key, value, Operation::INSERT)}, unused, false);
+}
+
+Status MvccDB::Delete(DataTable table, const std::vector<Field> &key,
+                      TimestampValue const &value) {
+  std::vector<TimestampValue> unused;
+  return Run({DB_Operation(table, key, value, Operation::DELETE)}, unused, false);
+}
+
+Status MvccDB::Execute(const DB_Operation &operation,
+                       std::vector<TimestampValue> &read_buffer,
+                       bool txn_op) {
+  switch (operation.operation) {
+    case Operation::READ:
+    case Operation::INSERT:
+    case Operation::UPDATE:
+    case Operation::DELETE:
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD: {
+      std::vector<DB_Operation> operations{operation};
+      Status s = Run(operations, read_buffer, false);
+      operation.written = operations[0].written;
+      return s;
+    }
+    default:
+      std::cerr << "invalid operation" << std::endl;
+      return Status::kNotImplemented;
+  }
+}
+
+Status MvccDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                  std::vector<TimestampValue> &read_buffer,
+                                  bool read_only) {
+  return Run(operations, read_buffer, true);
+}
+
+Status MvccDB::Run(std::vector<DB_Operation> const &operations,
+                   std::vector<TimestampValue> &read_buffer,
+                   bool in_transaction) {
+  Transaction txn(GlobalStore());
+  try {
+    for (auto const &op : operations) {
+      Status s;
+      switch (op.operation) {
+        case Operation::READ:
+          s = txn.Read(op.table, op.key, read_buffer);
+          if (s == Status::kNotFound && in_transaction) {
+            s = Status::kOK;
+          }
+          break;
+        case Operation::INSERT:
+          s = txn.Insert(op.table, op.key, op.time_and_value, op.written);
+          break;
+        case Operation::UPDATE:
+          s = txn.Write(op.table, op.key, op.time_and_value, false);
+          break;
+        case Operation::DELETE:
+          s = txn.Write(op.table, op.key, op.time_and_value, true);
+          break;
+        case Operation::RANGEREAD:
+        case Operation::COUNTREAD:
+        case Operation::TIMERANGEREAD:
+          s = txn.EdgeQuery(op, read_buffer);
+          break;
+        default:
+          std::cerr << "invalid operation" << std::endl;
+          s = Status::kNotImplemented;
+      }
+      if (s != Status::kOK) {
+        return s; // nothing is installed before Commit
+      }
+    }
+  } catch (SnapshotTooOld const &) {
+    return Status::kContentionError;
+  }
+  return txn.Commit(commit_latency_, lock_hold_);
+}
+
+Status MvccDB::BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                           std::vector<TimestampValue> const &values) {
+  Store &store = GlobalStore();
+  size_t max_versions = store.max_versions.load();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EdgeKey key = ToEdgeKey(table, keys[i]);
+    std::unique_lock<std::shared_mutex> lock(StripeMutex(store, table, std::get<0>(key)));
+    Chain &chain = ChainFor(store, table, key);
+    if (chain.versions.empty() || !chain.versions.back().value) {
+      Install(chain, store.clock.fetch_add(1) + 1, values[i], max_versions);
+    }
+  }
+  return Status::kOK;
+}
+
+Status MvccDB::BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                         const std::vector<Field> &ceiling_key, int n,
+                         std::vector<std::vector<Field>> &key_buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  Store &store = GlobalStore();
+  EdgeKey floor = ToEdgeKey(table, floor_key);
+  EdgeKey ceiling = ToEdgeKey(table, ceiling_key);
+
+  std::vector<std::shared_mutex *> mutexes;
+  for (auto &stripe : store.edges) {
+    mutexes.push_back(&stripe.mutex);
+  }
+  StripeLocks locks(std::move(mutexes), false);
+
+  // k-way merge of the stripes, as in MemDB; deleted keys are skipped
+  using Cursor = std::pair<std::map<EdgeKey, Chain>::const_iterator,
+                           std::map<EdgeKey, Chain>::const_iterator>;
+  auto later = [](Cursor const &a, Cursor const &b) { return a.first->first > b.first->first; };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> cursors(later);
+  for (auto &stripe : store.edges) {
+    auto it = stripe.rows.upper_bound(floor);
+    if (it != stripe.rows.end() && it->first < ceiling) {
+      cursors.push({it, stripe.rows.cend()});
+    }
+  }
+  int read = 0;
+  while (read < n && !cursors.empty()) {
+    Cursor cursor = cursors.top();
+    cursors.pop();
+    if (Visible(cursor.first->second, LATEST)) {
+      auto const &[id1, id2, type] = cursor.first->first;
+      key_buffer.push_back({{"id1", id1}, {"id2", id2}, {"type", type}});
+      ++read;
+    }
+    if (++cursor.first != cursor.second && cursor.first->first < ceiling) {
+      cursors.push(cursor);
+    }
+  }
+  return Status::kOK;
+}
+
+DB *NewMvccDB() {
+  return new MvccDB;
+}
+
+const bool registered = DBFactory::RegisterDB("mvccdb", NewMvccDB);
+
+} // benchmark
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "db.h"
+#include "properties.h"
+#include "db_factory.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+///
+/// In-process multi-version store with snapshot isolation and optimistic
+/// concurrency control, for exercising contention handling without a cluster.
+///
+/// Every key keeps a short chain of committed versions. A transaction reads at
+/// the snapshot taken when it starts and buffers its writes; at commit it locks
+/// the stripes it writes and aborts with Status::kContentionError if any of its
+/// keys was committed by someone else after its snapshot (first committer
+/// wins). Edge inserts also re-check GetIncompatibleKeys at commit, so two
+/// racing inserts of conflicting edges cannot both succeed.
+///
+/// Single operations run as one-operation transactions. Read-only
+/// transactions never abort, unless their snapshot has been pruned from a
+/// version chain they read.
+///
+class MvccDB : public DB {
+ public:
+  void Init();
+
+  void Cleanup();
+
+  Status Read(DataTable table, const std::vector<Field> &key,
+              std::vector<TimestampValue> &buffer);
+
+  // Returns up to n edges with the id1 of key, starting at key, in key order.
+  Status Scan(DataTable table, const std::vector<Field> &key, int n,
+              std::vector<TimestampValue> &buffer);
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer);
+
+  Status Update(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key,
+                TimestampValue const &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer,
+                            bool read_only);
+
+  // Inserts keys that are not present yet, without constraint checks.
+  Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                     std::vector<TimestampValue> const &values);
+
+  Status BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                   const std::vector<Field> &ceiling_key, int n,
+                   std::vector<std::vector<Field>> &key_buffer);
+
+ private:
+  // Runs operations as one transaction. Outside a transaction a missing read
+  // is reported as Status::kNotFound.
+  Status Run(std::vector<DB_Operation> const &operations,
+             std::vector<TimestampValue> &read_buffer, bool in_transaction);
+
+  // Time between a transaction finishing its reads and validating, as if the
+  // commit had to travel to a remote leader. Widens the window for conflicts.
+  std::chrono::microseconds commit_latency_{0};
+  // Time a committing transaction keeps its stripes locked after installing
+  // its writes. Readers and writers of those stripes wait behind it.
+  std::chrono::microseconds lock_hold_{0};
+};
+
+DB *NewMvccDB();
+
+} // benchmark
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <shared_mutex>
+#include <vector>
+
+namespace benchmark {
+
+// Holds a set of stripe mutexes, shared or exclusive, for its lifetime.
+// Mutexes are taken in address order so that callers locking overlapping sets
+// cannot deadlock; duplicates are locked once.
+class StripeLocks {
+ public:
+  StripeLocks(std::vector<std::shared_mutex *> mutexes, bool exclusive)
+    : mutexes_(std::move(mutexes))
+    , exclusive_(exclusive)
+  {
+    std::sort(mutexes_.begin(), mutexes_.end());
+    mutexes_.erase(std::unique(mutexes_.begin(), mutexes_.end()), mutexes_.end());
+    for (std::shared_mutex *mutex : mutexes_) {
+      if (exclusive_) {
+        mutex->lock();
+      } else {
+        mutex->lock_shared();
+      }
+    }
+  }
+
+  ~StripeLocks() {
+    for (auto it = mutexes_.rbegin(); it != mutexes_.rend(); ++it) {
+      if (exclusive_) {
+        (*it)->unlock();
+      } else {
+        (*it)->unlock_shared();
+      }
+    }
+  }
+
+  StripeLocks(StripeLocks const &) = delete;
+  StripeLocks &operator=(StripeLocks const &) = delete;
+
+ private:
+  std::vector<std::shared_mutex *> mutexes_;
+  bool exclusive_;
+};
+
+} // benchmark
@@ -0,0 +1,251 @@
+#include "mysql_async.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace {
+// Reported to callbacks of queries that never reached the server.
+const unsigned int CLIENT_ERROR = 2000; // CR_UNKNOWN_ERROR
+const std::string ROLLBACK = "ROLLBACK";
+
+// Whether a send on fd would not block now.
+bool Writable(int fd) {
+  pollfd pfd{fd, POLLOUT, 0};
+  return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLOUT) != 0;
+}
+} // namespace
+
+namespace benchmark {
+
+MySqlEventLoop::MySqlEventLoop(std::string const &dbname, std::string const &user,
+                               std::string const &password, std::string const &host,
+                               unsigned int port, int num_connections)
+    : stopping_(false) {
+  if (num_connections <= 0) {
+    throw std::invalid_argument("MySqlEventLoop needs at least one connection");
+  }
+  if (pipe(wake_pipe_) != 0) {
+    throw std::runtime_error("Failed to create event loop wake pipe");
+  }
+  fcntl(wake_pipe_[0], F_SETFL, O_NONBLOCK);
+  fcntl(wake_pipe_[1], F_SETFL, O_NONBLOCK);
+
+  for (int i = 0; i < num_connections; ++i) {
+    MYSQL *mysql = mysql_init(nullptr);
+    if (mysql_real_connect(mysql, host.c_str(), user.c_str(), password.c_str(),
+                           dbname.c_str(), port, nullptr,
+                           CLIENT_MULTI_STATEMENTS) == nullptr) {
+      std::string error = mysql_error(mysql);
+      mysql_close(mysql);
+      for (Connection &conn : connections_) {
+        mysql_close(conn.mysql);
+      }
+      throw std::runtime_error("Async connection failed: " + error);
+    }
+    connections_.push_back(Connection{mysql, mysql_get_socket_descriptor(mysql), State::kIdle,
+                                      false, {}, {}, 0});
+  }
+  thread_ = std::thread(&MySqlEventLoop::Run, this);
+}
+
+MySqlEventLoop::~MySqlEventLoop() {
+  stopping_ = true;
+  char c = 0;
+  (void) write(wake_pipe_[1], &c, 1);
+  thread_.join();
+  for (Connection &conn : connections_) {
+    mysql_close(conn.mysql);
+  }
+  close(wake_pipe_[0]);
+  close(wake_pipe_[1]);
+}
+
+void MySqlEventLoop::Submit(std::string query, bool rollback_on_error, Callback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(Task{std::move(query), rollback_on_error, std::move(callback)});
+  }
+  char c = 0;
+  (void) write(wake_pipe_[1], &c, 1); // a full pipe already guarantees a wakeup
+}
+
+void MySqlEventLoop::Run() {
+  std::vector<pollfd> fds;
+  std::vector<Connection *> polled;
+  while (true) {
+    // hand queued tasks to idle connections
+    std::vector<Connection *> started;
+    bool queue_empty;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (Connection &conn : connections_) {
+        if (queue_.empty()) {
+          break;
+        }
+        if (conn.state == State::kIdle) {
+          conn.task = std::move(queue_.front());
+          queue_.pop_front();
+          conn.state = State::kQuery;
+          conn.rows.clear();
+          conn.error = 0;
+          started.push_back(&conn);
+        }
+      }
+      queue_empty = queue_.empty();
+    }
+    for (Connection *conn : started) {
+      Step(*conn);
+    }
+
+    fds.clear();
+    polled.clear();
+    fds.push_back({wake_pipe_[0], POLLIN, 0});
+    for (Connection &conn : connections_) {
+      if (conn.state != State::kIdle) {
+        fds.push_back({conn.fd, static_cast<short>(conn.blocked_on_write ? POLLOUT : POLLIN), 0});
+        polled.push_back(&conn);
+      }
+    }
+    if (polled.empty() && queue_empty && stopping_) {
+      return;
+    }
+
+    int ready = poll(fds.data(), fds.size(), -1);
+    if (ready < 0 && errno != EINTR) {
+      std::cerr << "poll failed in MySQL event loop" << std::endl;
+      std::abort();
+    }
+    if (fds[0].revents & POLLIN) {
+      char drain[256];
+      while (read(wake_pipe_[0], drain, sizeof(drain)) > 0);
+    }
+    for (size_t i = 0; i < polled.size(); ++i) {
+      if (ready > 0 && fds[i + 1].revents != 0) {
+        Step(*polled[i]);
+      }
+    }
+  }
+}
+
+void MySqlEventLoop::Step(Connection &conn) {
+  MYSQL *mysql = conn.mysql;
+  // A query that is not ready is either still sending or waiting for the reply,
+  // which the client library does not tell apart. A send can only block while
+  // the socket's send buffer is full, so a query on a writable socket is taken
+  // to wait for the reply, after one retry in case the buffer drained after the
+  // send blocked. Returns whether to retry.
+  bool retried = false;
+  auto retry_query = [&conn, &retried] {
+    conn.blocked_on_write = !Writable(conn.fd);
+    if (conn.blocked_on_write || retried) {
+      return false;
+    }
+    retried = true;
+    return true;
+  };
+  conn.blocked_on_write = false;
+  while (true) {
+    net_async_status status;
+    switch (conn.state) {
+    case State::kIdle:
+      return;
+    case State::kQuery:
+      status = mysql_real_query_nonblocking(mysql, conn.task.query.data(),
+                                            conn.task.query.size());
+      if (status == NET_ASYNC_NOT_READY) {
+        if (retry_query()) {
+          break;
+        }
+        return;
+      } else if (status == NET_ASYNC_ERROR) {
+        Fail(conn);
+      } else {
+        conn.state = State::kStoreResult;
+      }
+      break;
+    case State::kStoreResult: {
+      MYSQL_RES *result = nullptr;
+      status = mysql_store_result_nonblocking(mysql, &result);
+      if (status == NET_ASYNC_NOT_READY) {
+        return;
+      } else if (status == NET_ASYNC_ERROR) {
+        Fail(conn);
+        break;
+      }
+      if (result != nullptr) {
+        // the result set is already client-side, so fetching cannot block
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(result)) != nullptr) {
+          if (mysql_num_fields(result) == 2 && row[0] != nullptr && row[1] != nullptr) {
+            conn.rows.emplace_back(std::strtoll(row[0], nullptr, 10), row[1]);
+          }
+        }
+        mysql_free_result(result);
+      } else if (mysql_field_count(mysql) != 0) {
+        Fail(conn);
+        break;
+      }
+      if (mysql_more_results(mysql)) {
+        conn.state = State::kNextResult;
+      } else {
+        Finish(conn);
+      }
+      break;
+    }
+    case State::kNextResult:
+      status = mysql_next_result_nonblocking(mysql);
+      if (status == NET_ASYNC_NOT_READY) {
+        return;
+      } else if (status == NET_ASYNC_ERROR) {
+        Fail(conn);
+      } else if (status == NET_ASYNC_COMPLETE_NO_MORE_RESULTS) {
+        Finish(conn);
+      } else {
+        conn.state = State::kStoreResult;
+      }
+      break;
+    case State::kRollback:
+      status = mysql_real_query_nonblocking(mysql, ROLLBACK.data(), ROLLBACK.size());
+      if (status == NET_ASYNC_NOT_READY) {
+        if (retry_query()) {
+          break;
+        }
+        return;
+      } else if (status == NET_ASYNC_ERROR) {
+        std::cerr << "failed to rollback: " << mysql_error(mysql) << std::endl;
+      }
+      Finish(conn);
+      break;
+    }
+  }
+}
+
+void MySqlEventLoop::Fail(Connection &conn) {
+  conn.error = mysql_errno(conn.mysql);
+  if (conn.error == 0) {
+    conn.error = CLIENT_ERROR;
+  }
+  std::cerr << "async query failed: " << mysql_error(conn.mysql) << std::endl;
+  if (conn.task.rollback_on_error) {
+    conn.state = State::kRollback;
+  } else {
+    Finish(conn);
+  }
+}
+
+void MySqlEventLoop::Finish(Connection &conn) {
+  Task task = std::move(conn.task);
+  std::vector<DB::TimestampValue> rows = std::move(conn.rows);
+  unsigned int error = conn.error;
+  conn.state = State::kIdle;
+  conn.task = {};
+  conn.rows.clear();
+  task.callback(error, std::move(rows));
+}
+
+} // benchmark
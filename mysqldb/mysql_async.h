@@ -0,0 +1,82 @@
+#pragma once
+
+#include "db.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mysql/mysql.h>
+
+namespace benchmark {
+
+///
+/// Multiplexes text-protocol queries over a pool of MySQL connections from a
+/// single thread, using the non-blocking C API (libmysqlclient 8.0.16+).
+///
+/// Submit queues a query; the loop hands it to the next idle connection and
+/// drives it with mysql_real_query_nonblocking / mysql_store_result_nonblocking
+/// / mysql_next_result_nonblocking, polling the connection sockets while the
+/// server works. Every (timestamp, value) row of every result set is collected
+/// and passed to the callback, which runs on the event-loop thread.
+///
+class MySqlEventLoop {
+ public:
+  /// @param error is mysql_errno() of the failing statement, or 0 on success.
+  using Callback = std::function<void(unsigned int error,
+                                      std::vector<DB::TimestampValue> &&rows)>;
+
+  /// Opens @param num_connections connections (blocking) with multi-statement
+  /// support enabled and starts the loop thread.
+  MySqlEventLoop(std::string const &dbname, std::string const &user,
+                 std::string const &password, std::string const &host,
+                 unsigned int port, int num_connections);
+
+  /// Waits for queued and in-flight queries to finish, then closes the pool.
+  ~MySqlEventLoop();
+
+  /// @param rollback_on_error send ROLLBACK on the same connection before
+  /// completing if any statement of @param query fails, so a half-applied
+  /// multi-statement transaction is not left open.
+  void Submit(std::string query, bool rollback_on_error, Callback callback);
+
+ private:
+  enum class State { kIdle, kQuery, kStoreResult, kNextResult, kRollback };
+
+  struct Task {
+    std::string query;
+    bool rollback_on_error;
+    Callback callback;
+  };
+
+  struct Connection {
+    MYSQL *mysql;
+    int fd;
+    State state;
+    // whether the query is waiting to send rather than for the reply
+    bool blocked_on_write;
+    Task task;
+    std::vector<DB::TimestampValue> rows;
+    unsigned int error;
+  };
+
+  void Run();
+
+  // Advances conn as far as possible without blocking.
+  void Step(Connection &conn);
+
+  void Fail(Connection &conn);
+
+  void Finish(Connection &conn);
+
+  std::vector<Connection> connections_;
+  std::deque<Task> queue_;
+  std::mutex mutex_;
+  int wake_pipe_[2];
+  std::atomic<bool> stopping_;
+  std::thread thread_;
+};
+
+} // benchmark
@@ -1,5 +1,8 @@
 #include "mysql_db.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace {
 const std::string DATABASE_NAME = "mysqldb.dbname";
 const std::string DATABASE_URL = "mysqldb.url";
@@ -7,12 +10,28 @@ const std::string DATABASE_USERNAME = "mysqldb.username";
 const std::string DATABASE_PASSWORD = "mysqldb.password";
 const std::string DATABASE_PORT = "mysqldb.dbport";
 const std::string DATABASE_PORT_DEFAULT = "4000";
+const std::string TXN_METHOD = "mysqldb.txn_method";
+const std::string TXN_METHOD_DEFAULT = "prepared";
+const std::string SCAN_PAGE_SIZE = "mysqldb.scan_page_size";
+const std::string ASYNC_CONNECTIONS = "mysqldb.async_connections";
 } // namespace
 
 namespace sql = SuperiorMySqlpp;
 
 namespace benchmark {
 
+// Deadlocks and lock wait timeouts (MySQL), write conflicts and retryable
+// commit failures (TiDB) mean the transaction lost a race and can be retried.
+inline bool IsContentionErrorCode(int code) {
+  return code == 1213 || code == 1205 || code == 9007 || code == 8022 || code == 8002;
+}
+
+inline Status MySqlErrorStatus(sql::MysqlInternalError const &e) {
+  std::cerr << e.getMysqlError() << std::endl;
+  return IsContentionErrorCode(e.getErrorCode()) ? Status::kContentionError
+                                                 : Status::kError;
+}
+
 inline std::string ReadObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
   auto id = key[0].value;
@@ -32,6 +51,31 @@ inline std::string ReadEdgeSQL(const DB::DB_Operation &op) {
   return stmt.str();
 }
 
+inline std::string RangeReadEdgesSQL(const DB::DB_Operation &op) {
+  std::ostringstream stmt;
+  stmt << "SELECT timestamp, value FROM edges WHERE id1=" << op.key[0].value
+       << " ORDER BY id2, type LIMIT " << op.limit;
+  return stmt.str();
+}
+
+// The count comes back in the timestamp column; the empty value keeps the
+// row two columns wide like every other read.
+inline std::string CountEdgesSQL(const DB::DB_Operation &op) {
+  std::ostringstream stmt;
+  stmt << "SELECT COUNT(*), '' FROM edges WHERE id1=" << op.key[0].value
+       << " AND type=" << op.key[1].value;
+  return stmt.str();
+}
+
+inline std::string TimeRangeReadEdgesSQL(const DB::DB_Operation &op) {
+  std::ostringstream stmt;
+  stmt << "SELECT timestamp, value FROM edges WHERE id1=" << op.key[0].value
+       << " AND type=" << op.key[1].value << " AND timestamp BETWEEN "
+       << op.min_timestamp << " AND " << op.max_timestamp
+       << " ORDER BY timestamp DESC LIMIT " << op.limit;
+  return stmt.str();
+}
+
 inline std::string InsertObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
   auto id = key[0].value;
@@ -88,8 +132,8 @@ inline std::string InsertBidrectionalSQL(const DB::DB_Operation &op) {
        << "' WHERE NOT EXISTS (SELECT 1 FROM edges WHERE id1=" << id1
        << " AND type=0 OR id1=" << id1 << " AND type=2 OR id1=" << id1
        << " AND id2=" << id2 << " AND type=3 OR id1=" << id2
-       << " AND id2=" << id1 << " AND type=3 OR id1=" << id1
-       << " AND id2=" << id2 << " AND type=0)";
+       << " AND id2=" << id1 << " AND type=3 OR id1=" << id2
+       << " AND id2=" << id1 << " AND type=0)";
   return stmt.str();
 }
 
@@ -156,6 +200,53 @@ inline std::string UpdateEdgeSQL(const DB::DB_Operation &op) {
   return stmt.str();
 }
 
+// Text SQL for a single operation, or an empty string if it is not supported.
+inline std::string OperationSQL(const DB::DB_Operation &op) {
+  switch (op.operation) {
+  case Operation::READ:
+    return op.table == DataTable::Edges ? ReadEdgeSQL(op) : ReadObjectSQL(op);
+  case Operation::RANGEREAD:
+    return RangeReadEdgesSQL(op);
+  case Operation::COUNTREAD:
+    return CountEdgesSQL(op);
+  case Operation::TIMERANGEREAD:
+    return TimeRangeReadEdgesSQL(op);
+  case Operation::DELETE:
+    return op.table == DataTable::Edges ? DeleteEdgeSQL(op) : DeleteObjectSQL(op);
+  case Operation::UPDATE:
+    return op.table == DataTable::Edges ? UpdateEdgeSQL(op) : UpdateObjectSQL(op);
+  case Operation::INSERT:
+    if (op.table == DataTable::Objects) {
+      return InsertObjectSQL(op);
+    }
+    switch (static_cast<EdgeType>(op.key[2].value)) {
+    case EdgeType::Other:
+      return InsertOtherSQL(op);
+    case EdgeType::Unique:
+      return InsertUniqueSQL(op);
+    case EdgeType::Bidirectional:
+      return InsertBidrectionalSQL(op);
+    case EdgeType::UniqueAndBidirectional:
+      return InsertUniqueAndBidirectionalSQL(op);
+    }
+    return "";
+  default:
+    return "";
+  }
+}
+
+// Status of a query completed by the MySqlEventLoop.
+inline Status AsyncStatus(unsigned int error) {
+  if (error == 0) {
+    return Status::kOK;
+  }
+  return IsContentionErrorCode(error) ? Status::kContentionError : Status::kError;
+}
+
+// One event loop (and connection pool) per process, shared by all client threads.
+static std::mutex event_loop_mutex;
+static std::weak_ptr<MySqlEventLoop> shared_event_loop;
+
 inline PreparedStatement BuildReadObject(sql::Connection &conn) {
   std::string object_string = "SELECT timestamp, value FROM objects WHERE id=?";
   return conn.makeDynamicPreparedStatement(object_string);
@@ -167,6 +258,24 @@ inline PreparedStatement BuildReadEdge(sql::Connection &conn) {
   return conn.makeDynamicPreparedStatement(edge_string);
 }
 
+inline PreparedStatement BuildRangeReadEdges(sql::Connection &conn) {
+  std::string edge_string =
+      "SELECT timestamp, value FROM edges WHERE id1=? ORDER BY id2, type LIMIT ?";
+  return conn.makeDynamicPreparedStatement(edge_string);
+}
+
+inline PreparedStatement BuildCountEdges(sql::Connection &conn) {
+  std::string edge_string = "SELECT COUNT(*) FROM edges WHERE id1=? AND type=?";
+  return conn.makeDynamicPreparedStatement(edge_string);
+}
+
+inline PreparedStatement BuildTimeRangeReadEdges(sql::Connection &conn) {
+  std::string edge_string =
+      "SELECT timestamp, value FROM edges WHERE id1=? AND type=? AND "
+      "timestamp BETWEEN ? AND ? ORDER BY timestamp DESC LIMIT ?";
+  return conn.makeDynamicPreparedStatement(edge_string);
+}
+
 inline PreparedStatement BuildInsertObject(sql::Connection &conn) {
   std::string object_string =
       "INSERT INTO objects (id, timestamp, value) VALUES "
@@ -240,6 +349,18 @@ inline PreparedStatement BuildUpdateEdge(sql::Connection &conn) {
   return conn.makeDynamicPreparedStatement(edge_string.c_str());
 }
 
+inline StreamingPreparedStatement BuildBatchRead(sql::Connection &conn) {
+  // The leading id1 bounds give every optimizer a plain range on the primary
+  // key; the row comparisons then trim the edges of that range exactly.
+  std::string edge_string =
+      "SELECT id1, id2, type FROM edges WHERE id1>=? AND id1<=? AND "
+      "(id1, id2, type) > (?, ?, ?) AND (id1, id2, type) < (?, ?, ?) "
+      "ORDER BY id1, id2, type LIMIT ?";
+  return conn.makeDynamicPreparedStatement<false,
+      sql::ValidateMetadataMode::ArithmeticPromotions,
+      sql::ValidateMetadataMode::Same, false>(edge_string.c_str());
+}
+
 MySqlDB::PreparedStatements::PreparedStatements(utils::Properties const &props)
     : sql_connection_{props.GetProperty(DATABASE_NAME),
                       props.GetProperty(DATABASE_USERNAME),
@@ -249,6 +370,9 @@ MySqlDB::PreparedStatements::PreparedStatements(utils::Properties const &props)
                           std::stoi(props.GetProperty(DATABASE_PORT)))},
       read_object(BuildReadObject(sql_connection_)),
       read_edge(BuildReadEdge(sql_connection_)),
+      range_read_edges(BuildRangeReadEdges(sql_connection_)),
+      count_edges(BuildCountEdges(sql_connection_)),
+      time_range_read_edges(BuildTimeRangeReadEdges(sql_connection_)),
       insert_object(BuildInsertObject(sql_connection_)),
       insert_other(BuildInsertOther(sql_connection_)),
       insert_unique(BuildInsertUnique(sql_connection_)),
@@ -258,21 +382,40 @@ MySqlDB::PreparedStatements::PreparedStatements(utils::Properties const &props)
       delete_object(BuildDeleteObject(sql_connection_)),
       delete_edge(BuildDeleteEdge(sql_connection_)),
       update_object(BuildUpdateObject(sql_connection_)),
-      update_edge(BuildUpdateEdge(sql_connection_)) {}
+      update_edge(BuildUpdateEdge(sql_connection_)),
+      batch_read(BuildBatchRead(sql_connection_)) {}
 
 void MySqlDB::Init() {
   const utils::Properties &props = *props_;
   statements = new PreparedStatements{props};
+  txn_method_ = props.GetProperty(TXN_METHOD, TXN_METHOD_DEFAULT);
+  scan_page_size_ = std::stoi(props.GetProperty(SCAN_PAGE_SIZE, "0"));
+
+  int async_connections = std::stoi(props.GetProperty(ASYNC_CONNECTIONS, "0"));
+  if (async_connections > 0) {
+    std::lock_guard<std::mutex> lock(event_loop_mutex);
+    event_loop_ = shared_event_loop.lock();
+    if (!event_loop_) {
+      event_loop_ = std::make_shared<MySqlEventLoop>(
+          props.GetProperty(DATABASE_NAME), props.GetProperty(DATABASE_USERNAME),
+          props.GetProperty(DATABASE_PASSWORD), props.GetProperty(DATABASE_URL),
+          std::stoi(props.GetProperty(DATABASE_PORT)), async_connections);
+      shared_event_loop = event_loop_;
+    }
+  }
 }
 
-void MySqlDB::Cleanup() { delete statements; }
+void MySqlDB::Cleanup() {
+  delete statements;
+  event_loop_.reset();
+}
 
 Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
                      std::vector<TimestampValue> &buffer) {
 
   bool row_found = false;
-  sql::Nullable<sql::StringDataBase<4100>> s;
-  sql::Nullable<int64_t> timestamp;
+  auto &s = statements->read_value;
+  auto &timestamp = statements->read_timestamp;
   if (table == DataTable::Edges) {
     auto &statement = statements->read_edge;
     assert(key.size() == 3);
@@ -289,13 +432,12 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
     statement.bindResult(0, timestamp);
     statement.bindResult(1, s);
     statement.updateResultBindings();
-    statement.fetch();
+    row_found = statement.fetch();
   } else {
     auto &statement = statements->read_object;
     assert(key.size() == 1);
@@ -306,15 +448,14 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
     statement.bindResult(0, timestamp);
     statement.bindResult(1, s);
     statement.updateResultBindings();
-    statement.fetch();
+    row_found = statement.fetch();
   }
-  if (!timestamp.isValid() || !s.isValid()) {
+  if (!row_found || !timestamp.isValid() || !s.isValid()) {
     std::cerr << "Key not found" << std::endl;
     return Status::kNotFound;
   }
@@ -322,6 +463,70 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
   return Status::kOK;
 }
 
+// Executes a statement whose parameters are bound and appends every
+// (timestamp, value) row it returns.
+Status MySqlDB::FetchRows(PreparedStatement &statement,
+                          std::vector<TimestampValue> &buffer) {
+  auto &s = statements->read_value;
+  auto &timestamp = statements->read_timestamp;
+  try {
+    statement.execute();
+  } catch (sql::MysqlInternalError e) {
+    return MySqlErrorStatus(e);
+  }
+  statement.bindResult(0, timestamp);
+  statement.bindResult(1, s);
+  statement.updateResultBindings();
+  while (statement.fetch()) {
+    if (timestamp.isValid() && s.isValid()) {
+      buffer.emplace_back(TimestampValue(timestamp.value(), s->getString()));
+    }
+  }
+  return Status::kOK;
+}
+
+Status MySqlDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  auto &statement = statements->range_read_edges;
+  int64_t n = limit;
+  statement.bindParam(0, id1);
+  statement.bindParam(1, n);
+  statement.updateParamBindings();
+  return FetchRows(statement, buffer);
+}
+
+Status MySqlDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  auto &statement = statements->count_edges;
+  statement.bindParam(0, id1);
+  statement.bindParam(1, type);
+  statement.updateParamBindings();
+  try {
+    statement.execute();
+  } catch (sql::MysqlInternalError e) {
+    return MySqlErrorStatus(e);
+  }
+  statement.bindResult(0, count);
+  statement.updateResultBindings();
+  if (!statement.fetch()) {
+    std::cerr << "count returned no row" << std::endl;
+    return Status::kError;
+  }
+  return Status::kOK;
+}
+
+Status MySqlDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                              int64_t max_timestamp, int limit,
+                              std::vector<TimestampValue> &buffer) {
+  auto &statement = statements->time_range_read_edges;
+  int64_t n = limit;
+  statement.bindParam(0, id1);
+  statement.bindParam(1, type);
+  statement.bindParam(2, min_timestamp);
+  statement.bindParam(3, max_timestamp);
+  statement.bindParam(4, n);
+  statement.updateParamBindings();
+  return FetchRows(statement, buffer);
+}
+
 Status MySqlDB::Scan(DataTable table, const std::vector<Field> &key, int n,
                      std::vector<TimestampValue> &buffer) {
   return Status::kNotImplemented;
@@ -351,8 +556,7 @@ Status MySqlDB::Update(DataTable table, const std::vector<Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
   } else {
     assert(key.size() == 1);
@@ -367,8 +571,7 @@ Status MySqlDB::Update(DataTable table, const std::vector<Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
   }
   return Status::kOK;
@@ -391,8 +594,7 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
   } else {
     assert(key.size() == 3);
@@ -420,8 +622,7 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
       try {
         statement.execute();
       } catch (sql::MysqlInternalError e) {
-        std::cerr << e.getMysqlError() << std::endl;
-        return Status::kError;
+        return MySqlErrorStatus(e);
       }
     } else if (t == EdgeType::Unique) {
       auto &statement = statements->insert_unique;
@@ -437,8 +638,7 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
       try {
         statement.execute();
       } catch (sql::MysqlInternalError e) {
-        std::cerr << e.getMysqlError() << std::endl;
-        return Status::kError;
+        return MySqlErrorStatus(e);
       }
     } else if (t == EdgeType::Bidirectional) {
       auto &statement = statements->insert_bidirectional;
@@ -453,14 +653,13 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
       statement.bindParam(8, id2);
       statement.bindParam(9, id2);
       statement.bindParam(10, id1);
-      statement.bindParam(11, id1);
-      statement.bindParam(12, id2);
+      statement.bindParam(11, id2);
+      statement.bindParam(12, id1);
       statement.updateParamBindings();
       try {
         statement.execute();
       } catch (sql::MysqlInternalError e) {
-        std::cerr << e.getMysqlError() << std::endl;
-        return Status::kError;
+        return MySqlErrorStatus(e);
       }
     } else if (t == EdgeType::UniqueAndBidirectional) {
       auto &statement = statements->insert_unique_and_bidirectional;
@@ -478,8 +677,7 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
       try {
         statement.execute();
       } catch (sql::MysqlInternalError e) {
-        std::cerr << e.getMysqlError() << std::endl;
-        return Status::kError;
+        return MySqlErrorStatus(e);
       }
     } else {
       throw std::invalid_argument("Invalid edge type!");
@@ -509,32 +707,38 @@ Status MySqlDB::BatchRead(DataTable table, const std::vector<Field> &floor_key,
   assert(ceiling_key[0].name == "id1");
   assert(ceiling_key[1].name == "id2");
   assert(ceiling_key[2].name == "type");
-  std::ostringstream query_string;
-  query_string << "SELECT id1, id2, type FROM edges WHERE "
-               << "(id1, id2, type) > ('" << floor_key[0].value << "','"
-               << floor_key[1].value << "','"
-               << floor_key[2].value
-               << "') AND "
-               << "(id1, id2, type) < ('" << ceiling_key[0].value << "','"
-               << ceiling_key[1].value << "','"
-               << ceiling_key[2].value
-               << "') ORDER BY id1, id2, type "
-               << "LIMIT " << n;
-  auto query =
-      statements->sql_connection_.makeQuery(query_string.str().c_str());
+  auto &statement = statements->batch_read;
+  int64_t floor_id1 = floor_key[0].value;
+  int64_t floor_id2 = floor_key[1].value;
+  int64_t floor_type = floor_key[2].value;
+  int64_t ceiling_id1 = ceiling_key[0].value;
+  int64_t ceiling_id2 = ceiling_key[1].value;
+  int64_t ceiling_type = ceiling_key[2].value;
+  int64_t limit = scan_page_size_ > 0 ? scan_page_size_ : n;
+  statement.bindParam(0, floor_id1);
+  statement.bindParam(1, ceiling_id1);
+  statement.bindParam(2, floor_id1);
+  statement.bindParam(3, floor_id2);
+  statement.bindParam(4, floor_type);
+  statement.bindParam(5, ceiling_id1);
+  statement.bindParam(6, ceiling_id2);
+  statement.bindParam(7, ceiling_type);
+  statement.bindParam(8, limit);
+  statement.updateParamBindings();
+  auto &id1 = statements->batch_read_id1;
+  auto &id2 = statements->batch_read_id2;
+  auto &type = statements->batch_read_type;
   try {
-    query.execute();
+    statement.execute();
+    statement.bindResult(0, id1);
+    statement.bindResult(1, id2);
+    statement.bindResult(2, type);
+    statement.updateResultBindings();
+    while (statement.fetch()) {
+      key_buffer.push_back({{"id1", id1}, {"id2", id2}, {"type", type}});
+    }
   } catch (sql::MysqlInternalError e) {
-    std::cerr << e.getMysqlError() << std::endl;
-    return Status::kError;
-  }
-  auto result = query.store();
-  while (auto row = result.fetchRow()) {
-    std::vector<DB::Field> row_result;
-    row_result.emplace_back("id1", std::stoll(row[0].getString()));
-    row_result.emplace_back("id2", std::stoll(row[1].getString()));
-    row_result.emplace_back("type", std::stoll(row[2].getString()));
-    key_buffer.push_back(std::move(row_result));
+    return MySqlErrorStatus(e);
   }
   return Status::kOK;
 }
@@ -607,7 +811,7 @@ Status MySqlDB::Delete(DataTable table, const std::vector<Field> &key,
     auto &statement = statements->delete_edge;
     int64_t id1 = key[0].value;
     int64_t id2 = key[1].value;
-    std::string type = EdgeTypeToString(static_cast<EdgeType>(key[2].value));
+    int64_t type = key[2].value;
     statement.bindParam(0, timestamp);
     statement.bindParam(1, id1);
     statement.bindParam(2, id2);
@@ -616,8 +820,7 @@ Status MySqlDB::Delete(DataTable table, const std::vector<Field> &key,
     try {
       statement.execute();
     } catch (sql::MysqlInternalError e) {
-      std::cerr << e.getMysqlError() << std::endl;
-      return Status::kError;
+      return MySqlErrorStatus(e);
     }
   } else {
     assert(key.size() == 1);
@@ -630,8 +833,8 @@ Status MySqlDB::Delete(DataTable table, const std::vector<Field> &key,
     statement.updateParamBindings();
     try {
       statement.execute();
-    } catch (sql::MysqlInternalError) {
-      return Status::kError;
+    } catch (sql::MysqlInternalError e) {
+      return MySqlErrorStatus(e);
     }
   }
   return Status::kOK;
@@ -671,6 +874,14 @@ Status MySqlDB::Execute(const DB_Operation &operation,
       return Status::kError;
     }
     break;
+  case Operation::RANGEREAD:
+  case Operation::COUNTREAD:
+  case Operation::TIMERANGEREAD:
+    if (ExecuteEdgeQuery(*this, operation, read_buffer) != Status::kOK) {
+      std::cerr << "edge query failed" << std::endl;
+      return Status::kError;
+    }
+    break;
   default:
     std::cerr << "invalid operation" << std::endl;
     return Status::kNotImplemented;
@@ -681,51 +892,85 @@ Status MySqlDB::Execute(const DB_Operation &operation,
 Status MySqlDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
                                    std::vector<TimestampValue> &read_buffer,
                                    bool read_only) {
-  auto query = statements->sql_connection_.makeQuery("START TRANSACTION; ");
+  if (txn_method_ == "prepared") {
+    return ExecuteTransactionPrepared(operations, read_buffer, read_only);
+  } else if (txn_method_ == "multi_statement") {
+    return ExecuteTransactionMultiStatement(operations, read_buffer, read_only);
+  }
+  std::cerr << "invalid " << TXN_METHOD << ": " << txn_method_ << std::endl;
+  return Status::kNotImplemented;
+}
+
+Status MySqlDB::ExecuteTransactionPrepared(const std::vector<DB_Operation> &operations,
+                                           std::vector<TimestampValue> &read_buffer,
+                                           bool read_only) {
+  auto &conn = statements->sql_connection_;
+  try {
+    conn.makeQuery(read_only ? "START TRANSACTION READ ONLY" : "START TRANSACTION").execute();
+  } catch (sql::MysqlInternalError e) {
+    return MySqlErrorStatus(e);
+  }
+  Status status = Status::kOK;
   for (auto const &op : operations) {
     switch (op.operation) {
     case Operation::READ:
-      if (op.table == DataTable::Edges) {
-        query << ReadEdgeSQL(op);
-      } else {
-        query << ReadObjectSQL(op);
+      status = Read(op.table, op.key, read_buffer);
+      // a miss inside a transaction just contributes no row, as in the
+      // multi-statement path
+      if (status == Status::kNotFound) {
+        status = Status::kOK;
       }
       break;
     case Operation::DELETE:
-      if (op.table == DataTable::Edges) {
-        query << DeleteEdgeSQL(op);
-      } else {
-        query << DeleteObjectSQL(op);
-      }
+      status = Delete(op.table, op.key, op.time_and_value);
       break;
     case Operation::UPDATE:
-      if (op.table == DataTable::Edges) {
-        query << UpdateEdgeSQL(op);
-      } else {
-        query << UpdateObjectSQL(op);
-      }
+      status = Update(op.table, op.key, op.time_and_value);
       break;
     case Operation::INSERT:
-      if (op.table == DataTable::Objects) {
-        query << InsertObjectSQL(op);
-      } else {
-        auto type = static_cast<EdgeType>(op.key[2].value);
-        if (type == EdgeType::Other) {
-          query << InsertOtherSQL(op);
-        } else if (type == EdgeType::Unique) {
-          query << InsertUniqueSQL(op);
-        } else if (type == EdgeType::Bidirectional) {
-          query << InsertBidrectionalSQL(op);
-        } else if (type == EdgeType::UniqueAndBidirectional) {
-          query << InsertUniqueAndBidirectionalSQL(op);
-        }
-      }
+      status = Insert(op.table, op.key, op.time_and_value);
+      break;
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD:
+      status = ExecuteEdgeQuery(*this, op, read_buffer);
       break;
     default:
+      std::cerr << "invalid operation" << std::endl;
+      status = Status::kNotImplemented;
+    }
+    if (status != Status::kOK) {
+      break;
+    }
+  }
+  try {
+    if (status == Status::kOK) {
+      conn.makeQuery("COMMIT").execute();
+      return Status::kOK;
+    }
+  } catch (sql::MysqlInternalError e) {
+    std::cerr << "transaction failed: ";
+    status = MySqlErrorStatus(e);
+  }
+  try {
+    conn.makeQuery("ROLLBACK").execute();
+  } catch (sql::MysqlInternalError e) {
+    std::cerr << "failed to rollback: " << e.getMysqlError() << std::endl;
+  }
+  return status;
+}
+
+Status MySqlDB::ExecuteTransactionMultiStatement(const std::vector<DB_Operation> &operations,
+                                                 std::vector<TimestampValue> &read_buffer,
+                                                 bool read_only) {
+  auto query = statements->sql_connection_.makeQuery("START TRANSACTION; ");
+  for (auto const &op : operations) {
+    std::string stmt = OperationSQL(op);
+    if (stmt.empty()) {
       std::cerr << "invalid operation" << std::endl;
       return Status::kNotImplemented;
     }
-    query << "; ";
+    query << stmt << "; ";
   }
   query << "COMMIT";
 
@@ -751,14 +996,64 @@ Status MySqlDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
     } catch (sql::MysqlInternalError e) {
       std::cerr << "failed to rollback: " << e.getMysqlError() << std::endl;
     }
-    if (e.getErrorCode() == 1213) {
-      return Status::kContentionError;
-    }
-    return Status::kError;
+    return IsContentionErrorCode(e.getErrorCode()) ? Status::kContentionError
+                                                   : Status::kError;
   }
   return Status::kOK;
 }
 
+void MySqlDB::ExecuteAsync(const DB_Operation &operation,
+                           std::vector<TimestampValue> &read_buffer,
+                           std::function<void(Status)> callback) {
+  if (!event_loop_) {
+    callback(Execute(operation, read_buffer));
+    return;
+  }
+  std::string query = OperationSQL(operation);
+  if (query.empty()) {
+    std::cerr << "invalid operation" << std::endl;
+    callback(Status::kNotImplemented);
+    return;
+  }
+  bool is_read = operation.operation == Operation::READ;
+  event_loop_->Submit(std::move(query), false,
+      [&read_buffer, is_read, callback](unsigned int error,
+                                        std::vector<TimestampValue> &&rows) {
+        if (error == 0 && is_read && rows.empty()) {
+          callback(Status::kNotFound);
+          return;
+        }
+        std::move(rows.begin(), rows.end(), std::back_inserter(read_buffer));
+        callback(AsyncStatus(error));
+      });
+}
+
+void MySqlDB::ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                                      std::vector<TimestampValue> &read_buffer,
+                                      bool read_only,
+                                      std::function<void(Status)> callback) {
+  if (!event_loop_) {
+    callback(ExecuteTransaction(operations, read_buffer, read_only));
+    return;
+  }
+  std::string query = read_only ? "START TRANSACTION READ ONLY; " : "START TRANSACTION; ";
+  for (auto const &op : operations) {
+    std::string stmt = OperationSQL(op);
+    if (stmt.empty()) {
+      std::cerr << "invalid operation" << std::endl;
+      callback(Status::kNotImplemented);
+      return;
+    }
+    query += stmt + "; ";
+  }
+  query += "COMMIT";
+  event_loop_->Submit(std::move(query), true,
+      [&read_buffer, callback](unsigned int error, std::vector<TimestampValue> &&rows) {
+        std::move(rows.begin(), rows.end(), std::back_inserter(read_buffer));
+        callback(AsyncStatus(error));
+      });
+}
+
 DB *NewMySqlDB() { return new MySqlDB; }
 
 const bool registered = DBFactory::RegisterDB("mysql", NewMySqlDB);
@@ -4,7 +4,9 @@
 #include "properties.h"
 #include "db_factory.h"
 #include "timer.h"
+#include "mysql_async.h"
 #include <iostream>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <superior_mysqlpp.hpp>
@@ -14,6 +16,11 @@ namespace benchmark {
 
 using PreparedStatement = SuperiorMySqlpp::DynamicPreparedStatement<true, SuperiorMySqlpp::ValidateMetadataMode::ArithmeticPromotions, SuperiorMySqlpp::ValidateMetadataMode::Same, false>;
 
+// Does not store the result set client-side; rows are pulled from the server
+// one fetch() at a time, so the whole result must be drained before the
+// connection is reused.
+using StreamingPreparedStatement = SuperiorMySqlpp::DynamicPreparedStatement<false, SuperiorMySqlpp::ValidateMetadataMode::ArithmeticPromotions, SuperiorMySqlpp::ValidateMetadataMode::Same, false>;
+
 class MySqlDB : public DB {
 public:
 
@@ -31,6 +38,14 @@ public:
   Status Scan(DataTable table, const std::vector<Field> & key, int n,
               std::vector<TimestampValue> &buffer);
 
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer);
+
   Status Update(DataTable table, const std::vector<Field> &key,
                 TimestampValue const & value);
 
@@ -55,13 +70,37 @@ public:
                             std::vector<TimestampValue> &read_buffer,
                             bool read_only);
 
+  // Submitted to the shared MySqlEventLoop as text queries when
+  // mysqldb.async_connections is set; otherwise they complete inline.
+  void ExecuteAsync(const DB_Operation &operation,
+                    std::vector<TimestampValue> &read_buffer,
+                    std::function<void(Status)> callback);
+
+  void ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                               std::vector<TimestampValue> &read_buffer,
+                               bool read_only,
+                               std::function<void(Status)> callback);
+
 private:
+  Status FetchRows(PreparedStatement &statement, std::vector<TimestampValue> &buffer);
+
   Status BatchInsertObjects(const std::vector<std::vector<Field>> &keys,
                             const std::vector<TimestampValue> &timeval);
 
   Status BatchInsertEdges(const std::vector<std::vector<Field>> &keys,
                           const std::vector<TimestampValue> &timeval);
 
+  // Runs each operation as a prepared statement (binary protocol) between
+  // START TRANSACTION and COMMIT.
+  Status ExecuteTransactionPrepared(const std::vector<DB_Operation> &operations,
+                                    std::vector<TimestampValue> &read_buffer,
+                                    bool read_only);
+
+  // Sends the whole transaction as one text-protocol multi-statement query.
+  Status ExecuteTransactionMultiStatement(const std::vector<DB_Operation> &operations,
+                                          std::vector<TimestampValue> &read_buffer,
+                                          bool read_only);
+
   struct PreparedStatements {
 
     PreparedStatements(utils::Properties const & props);
@@ -69,13 +108,24 @@ private:
     SuperiorMySqlpp::Connection sql_connection_;
     PreparedStatement read_object;
     PreparedStatement read_edge;
+    PreparedStatement range_read_edges, count_edges, time_range_read_edges;
     PreparedStatement insert_object;
     PreparedStatement insert_other, insert_unique, insert_bidirectional, insert_unique_and_bidirectional;
     PreparedStatement delete_object, delete_edge;
     PreparedStatement update_object, update_edge;
+    StreamingPreparedStatement batch_read;
+
+    // Result buffers bound by the read statements; reused across calls.
+    SuperiorMySqlpp::Nullable<SuperiorMySqlpp::StringDataBase<4100>> read_value;
+    SuperiorMySqlpp::Nullable<int64_t> read_timestamp;
+    int64_t batch_read_id1, batch_read_id2, batch_read_type;
   };
 
   PreparedStatements *statements;
+  // Shared by every MySqlDB in the process; null when async execution is off.
+  std::shared_ptr<MySqlEventLoop> event_loop_;
+  std::string txn_method_;
+  int scan_page_size_;
   std::mutex mutex_;
   static int ref_cnt_;
 
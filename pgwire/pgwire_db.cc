@@ -0,0 +1,591 @@
+#include "pgwire_db.h"
+
+#include <pqxx/pqxx>
+
+using std::cout;
+using std::endl;
+
+namespace benchmark {
+
+void PgWireDB::Init() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const utils::Properties &props = *props_;
+  std::string connectionstring = props.GetProperty(ConnectionStringProperty());
+  if (connectionstring == "") {
+    throw utils::Exception("Missing " + ConnectionStringProperty() + " in properties file");
+  }
+  txn_method_ = props.GetProperty(PropertyPrefix() + ".txn_method", DefaultTransactionMethod());
+
+  conn_ = new pqxx::connection(connectionstring);
+
+  // create prepared statements
+  edge_table_ = props.GetProperty("edge_table", "edges");
+  object_table_ = props.GetProperty("object_table", "objects");
+
+  // read
+  conn_->prepare("read_object", "SELECT timestamp, value FROM " + object_table_ + " WHERE id = $1");
+  conn_->prepare("read_edge", "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = $1 AND id2 = $2 AND type = $3");
+
+  // edge queries; a count comes back in the timestamp column
+  conn_->prepare("range_read_edges", "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = $1 ORDER BY id2, type LIMIT $2");
+  conn_->prepare("count_edges", "SELECT COUNT(*), '' FROM " + edge_table_ + " WHERE id1 = $1 AND type = $2");
+  conn_->prepare("time_range_read_edges", "SELECT timestamp, value FROM " + edge_table_
+      + " WHERE id1 = $1 AND type = $2 AND timestamp BETWEEN $3 AND $4 ORDER BY timestamp DESC LIMIT $5");
+
+  // update
+  conn_->prepare("update_object", "UPDATE " + object_table_ + " SET timestamp = $1, value = $2 WHERE id = $3 AND timestamp < $1");
+  conn_->prepare("update_edge", "UPDATE " + edge_table_ + " SET timestamp = $1, value = $2 WHERE id1 = $3 AND id2 = $4 AND type = $5 AND timestamp < $1");
+
+  // insert
+  // The select list is cast explicitly: PostgreSQL cannot infer parameter types
+  // through INSERT ... SELECT.
+  conn_->prepare("insert_object", "INSERT INTO " + object_table_ + " (id, timestamp, value) VALUES ($1, $2, $3)");
+  std::string insert_edge = "INSERT INTO " + edge_table_ + " (id1, id2, type, timestamp, value) "
+      "SELECT $1::BIGINT, $2::BIGINT, $3::BIGINT, $4::BIGINT, $5::TEXT WHERE NOT EXISTS (SELECT 1 FROM " + edge_table_ + " WHERE ";
+  conn_->prepare("insert_edge_other", insert_edge + IncompatibleKeysPredicate(EdgeType::Other, "$1", "$2") + ")");
+  conn_->prepare("insert_edge_bidirectional", insert_edge + IncompatibleKeysPredicate(EdgeType::Bidirectional, "$1", "$2") + ")");
+  conn_->prepare("insert_edge_unique", insert_edge + IncompatibleKeysPredicate(EdgeType::Unique, "$1", "$2") + ")");
+  conn_->prepare("insert_edge_bi_unique", insert_edge + IncompatibleKeysPredicate(EdgeType::UniqueAndBidirectional, "$1", "$2") + ")");
+
+  // delete
+  conn_->prepare("delete_object", "DELETE FROM " + object_table_ + " WHERE id = $1 AND timestamp < $2");
+  conn_->prepare("delete_edge", "DELETE FROM " + edge_table_ + " WHERE id1 = $1 AND id2 = $2 AND type = $3 AND timestamp < $4");
+
+  // batch read
+  conn_->prepare("batch_read", "SELECT id1, id2, type FROM " + edge_table_ + " WHERE " + BatchReadPredicate()
+      + " ORDER BY id1, id2, type LIMIT $7");
+
+  PrepareDialectStatements();
+}
+
+void PgWireDB::Cleanup() {
+  conn_->close();
+  delete conn_;
+}
+
+Status PgWireDB::ErrorStatus(std::exception const &e) const {
+  std::cerr << e.what() << endl;
+  return IsContentionError(e) ? Status::kContentionError : Status::kError;
+}
+
+/*
+  key always in the order {id1, id2, type} or {id1}
+  fields always in the other {timestamp, value}
+*/
+Status PgWireDB::Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    pqxx::result queryRes = DoRead(tx, table, key);
+    if (queryRes.empty()) {
+      return Status::kNotFound;
+    }
+    result.emplace_back((queryRes[0][0]).as<int64_t>(0), (queryRes[0][1]).as<std::string>("NULL"));
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+pqxx::result PgWireDB::DoRead(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key) {
+  if (table == DataTable::Objects) {
+    return tx.exec_prepared("read_object", key[0].value);
+  } else if (table == DataTable::Edges) {
+    return tx.exec_prepared("read_edge", key[0].value, key[1].value, key[2].value);
+  } else {
+    throw std::invalid_argument("Received unknown table");
+  }
+}
+
+Status PgWireDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    for (auto row : tx.exec_prepared("range_read_edges", id1, limit)) {
+      result.emplace_back((row[0]).as<int64_t>(0), (row[1]).as<std::string>("NULL"));
+    }
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    pqxx::result queryRes = tx.exec_prepared("count_edges", id1, type);
+    count = (queryRes[0][0]).as<int64_t>(0);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                               int limit, std::vector<TimestampValue> &result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    for (auto row : tx.exec_prepared("time_range_read_edges", id1, type, min_timestamp, max_timestamp, limit)) {
+      result.emplace_back((row[0]).as<int64_t>(0), (row[1]).as<std::string>("NULL"));
+    }
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+pqxx::result PgWireDB::DoEdgeQuery(pqxx::transaction_base &tx, const DB_Operation &operation) {
+  const std::vector<Field> &key = operation.key;
+  switch (operation.operation) {
+  case Operation::RANGEREAD:
+    return tx.exec_prepared("range_read_edges", key[0].value, operation.limit);
+  case Operation::COUNTREAD:
+    return tx.exec_prepared("count_edges", key[0].value, key[1].value);
+  case Operation::TIMERANGEREAD:
+    return tx.exec_prepared("time_range_read_edges", key[0].value, key[1].value, operation.min_timestamp,
+                            operation.max_timestamp, operation.limit);
+  default:
+    throw std::invalid_argument("Received unknown edge query");
+  }
+}
+
+Status PgWireDB::Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer) {
+  return Status::kNotImplemented;
+}
+
+Status PgWireDB::Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    DoUpdate(tx, table, key, value);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+pqxx::result PgWireDB::DoUpdate(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                                TimestampValue const &value) {
+  if (table == DataTable::Objects) {
+    return tx.exec_prepared("update_object", value.timestamp, value.value, key[0].value);
+  } else if (table == DataTable::Edges) {
+    return tx.exec_prepared("update_edge", value.timestamp, value.value, key[0].value, key[1].value, key[2].value);
+  } else {
+    throw std::invalid_argument("Received unknown table");
+  }
+}
+
+Status PgWireDB::Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    DoInsert(tx, table, key, value);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+pqxx::result PgWireDB::DoInsert(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                                TimestampValue const &value) {
+  if (table == DataTable::Objects) {
+    return tx.exec_prepared("insert_object", key[0].value, value.timestamp, value.value);
+  } else if (table == DataTable::Edges) {
+    EdgeType type = static_cast<EdgeType>(key[2].value);
+    if (type == EdgeType::Other) {
+      return tx.exec_prepared("insert_edge_other", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+    } else if (type == EdgeType::Bidirectional) {
+      return tx.exec_prepared("insert_edge_bidirectional", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+    } else if (type == EdgeType::Unique) {
+      return tx.exec_prepared("insert_edge_unique", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+    } else if (type == EdgeType::UniqueAndBidirectional) {
+      return tx.exec_prepared("insert_edge_bi_unique", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+    } else {
+      throw std::invalid_argument("Received unknown type");
+    }
+  } else {
+    throw std::invalid_argument("Received unknown table");
+  }
+}
+
+Status PgWireDB::Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    DoDelete(tx, table, key, value);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+pqxx::result PgWireDB::DoDelete(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                                TimestampValue const &value) {
+  if (table == DataTable::Objects) {
+    return tx.exec_prepared("delete_object", key[0].value, value.timestamp);
+  } else if (table == DataTable::Edges) {
+    return tx.exec_prepared("delete_edge", key[0].value, key[1].value, key[2].value, value.timestamp);
+  } else {
+    throw std::invalid_argument("Received unknown table");
+  }
+}
+
+Status PgWireDB::BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                             const std::vector<TimestampValue> &values) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return table == DataTable::Edges ? BatchInsertEdges(keys, values)
+                                   : BatchInsertObjects(keys, values);
+}
+
+Status PgWireDB::BatchInsertEdges(const std::vector<std::vector<Field>> &keys,
+                                  const std::vector<TimestampValue> &values) {
+  try {
+    pqxx::nontransaction tx(*conn_);
+
+    std::string query = "INSERT INTO " + edge_table_ + " (id1, id2, type, timestamp, value) VALUES ";
+    bool is_first = true;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+      assert(keys[i].size() == 3);
+      assert(keys[i][0].name == "id1");
+      assert(keys[i][1].name == "id2");
+      assert(keys[i][2].name == "type");
+
+      if (!is_first) {
+        query += ", ";
+      } else {
+        is_first = false;
+      }
+      query += "(" + std::to_string(keys[i][0].value)         // id1
+                + ", " + std::to_string(keys[i][1].value)     // id2
+                + ", " + std::to_string(keys[i][2].value)     // type
+                + ", " + std::to_string(values[i].timestamp)  // timestamp
+                + ", " + conn_->quote(values[i].value)        // value
+              + ")";
+    }
+
+    tx.exec(query);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::BatchInsertObjects(const std::vector<std::vector<Field>> &keys,
+                                    const std::vector<TimestampValue> &values) {
+  try {
+    pqxx::nontransaction tx(*conn_);
+
+    std::string query = "INSERT INTO " + object_table_ + " (id, timestamp, value) VALUES ";
+    bool is_first = true;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+      assert(keys[i].size() == 1);
+      assert(keys[i][0].name == "id");
+
+      if (!is_first) {
+        query += ", ";
+      } else {
+        is_first = false;
+      }
+      query += "(" + std::to_string(keys[i][0].value)               // id
+                + ", " + std::to_string(values[i].timestamp)        // timestamp
+                + ", " + conn_->quote(values[i].value)              // value
+              + ")";
+    }
+
+    tx.exec(query);
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::BatchRead(DataTable table,
+                           std::vector<Field> const &floor_key,
+                           std::vector<Field> const &ceil_key,
+                           int n,
+                           std::vector<std::vector<Field>> &result) {
+  assert(floor_key.size() == 3);
+  assert(floor_key[0].name == "id1");
+  assert(floor_key[1].name == "id2");
+  assert(floor_key[2].name == "type");
+  assert(ceil_key.size() == 3);
+  assert(ceil_key[0].name == "id1");
+  assert(ceil_key[1].name == "id2");
+  assert(ceil_key[2].name == "type");
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    pqxx::result queryRes = tx.exec_prepared("batch_read", floor_key[0].value, floor_key[1].value, floor_key[2].value,
+                                             ceil_key[0].value, ceil_key[1].value, ceil_key[2].value, n);
+    for (auto row : queryRes) {
+      result.push_back({{"id1", (row)[0].as<int64_t>(0)},
+                        {"id2", (row)[1].as<int64_t>(0)},
+                        {"type", (row)[2].as<int64_t>(0)}});
+    }
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::Execute(const DB_Operation &operation, std::vector<TimestampValue> &result, bool txn_op) {
+  try {
+    switch (operation.operation) {
+    case Operation::READ:
+      return Read(operation.table, operation.key, result);
+    case Operation::INSERT: {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pqxx::nontransaction tx(*conn_);
+      // the WHERE NOT EXISTS of a blocked edge insert selects no row
+      operation.written = DoInsert(tx, operation.table, operation.key, operation.time_and_value)
+          .affected_rows() > 0;
+      return Status::kOK;
+    }
+    case Operation::UPDATE:
+      return Update(operation.table, operation.key, operation.time_and_value);
+    case Operation::DELETE:
+      return Delete(operation.table, operation.key, operation.time_and_value);
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD:
+      return ExecuteEdgeQuery(*this, operation, result);
+    case Operation::SCAN:
+    case Operation::READMODIFYWRITE:
+    case Operation::MAXOPTYPE:
+      return Status::kNotImplemented;
+    default:
+      return Status::kNotFound;
+    }
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+Status PgWireDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                    std::vector<TimestampValue> &results, bool read_only) {
+  if (txn_method_ == "prepared") {
+    return ExecuteTransactionPrepared(operations, results, read_only);
+  } else if (txn_method_ == "batch") {
+    return ExecuteTransactionBatch(operations, results, read_only);
+  } else {
+    cout << "Attempted to perform " << PropertyPrefix() << " ExecuteTransaction with unsupported execution method: "
+         << txn_method_ << endl;
+    return Status::kNotImplemented;
+  }
+}
+
+/*
+* Method executes each operation within a transaction as a prepared statement
+*/
+Status PgWireDB::ExecuteTransactionPrepared(const std::vector<DB_Operation> &operations,
+                                            std::vector<TimestampValue> &results, bool read_only) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::work tx(*conn_);
+
+    for (const auto &operation : operations) {
+      pqxx::result queryRes;
+      switch (operation.operation) {
+      case Operation::READ:
+        queryRes = DoRead(tx, operation.table, operation.key);
+        break;
+      case Operation::INSERT:
+        queryRes = DoInsert(tx, operation.table, operation.key, operation.time_and_value);
+        operation.written = queryRes.affected_rows() > 0;
+        break;
+      case Operation::UPDATE:
+        queryRes = DoUpdate(tx, operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::DELETE:
+        queryRes = DoDelete(tx, operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::RANGEREAD:
+      case Operation::COUNTREAD:
+      case Operation::TIMERANGEREAD:
+        queryRes = DoEdgeQuery(tx, operation);
+        break;
+      case Operation::SCAN:
+      case Operation::READMODIFYWRITE:
+      case Operation::MAXOPTYPE:
+        return Status::kNotImplemented;
+      default:
+        return Status::kNotFound;
+      }
+
+      if (operation.operation == Operation::READ || IsEdgeQuery(operation.operation)) {
+        for (auto row : queryRes) {
+          results.emplace_back((row[0]).as<int64_t>(0), (row[1]).as<std::string>("NULL"));
+        }
+      }
+    }
+
+    tx.commit();
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+/*
+* Method sends the transaction as plain, not prepared, SQL in two round trips:
+* all reads as one UNION ALL query, then all writes as one semicolon-joined string.
+* Execution order (first to last): reads, inserts, updates, deletes
+*/
+Status PgWireDB::ExecuteTransactionBatch(const std::vector<DB_Operation> &operations,
+                                         std::vector<TimestampValue> &results, bool read_only) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    std::vector<DB_Operation> read_operations;
+    std::vector<DB_Operation> insert_operations;
+    std::vector<DB_Operation> update_operations;
+    std::vector<DB_Operation> delete_operations;
+
+    for (const auto &operation : operations) {
+      switch (operation.operation) {
+      case Operation::READ:
+      case Operation::RANGEREAD:
+      case Operation::COUNTREAD:
+      case Operation::TIMERANGEREAD:
+        read_operations.push_back(operation);
+        break;
+      case Operation::INSERT:
+        insert_operations.push_back(operation);
+        break;
+      case Operation::UPDATE:
+        update_operations.push_back(operation);
+        break;
+      case Operation::DELETE:
+        delete_operations.push_back(operation);
+        break;
+      case Operation::SCAN:
+      case Operation::READMODIFYWRITE:
+      case Operation::MAXOPTYPE:
+        return Status::kNotImplemented;
+      default:
+        return Status::kNotFound;
+      }
+    }
+
+    pqxx::work tx(*conn_);
+
+    if (!read_operations.empty()) {
+      pqxx::result queryRes = tx.exec(GenerateMergedReadQuery(read_operations));
+      for (auto row : queryRes) {
+        results.emplace_back((row[0]).as<int64_t>(0), (row[1]).as<std::string>("NULL"));
+      }
+    }
+
+    std::string write_query = GenerateMergedInsertQuery(insert_operations)
+                            + GenerateMergedUpdateQuery(update_operations)
+                            + GenerateMergedDeleteQuery(delete_operations);
+    if (!write_query.empty()) {
+      tx.exec(write_query);
+    }
+
+    tx.commit();
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    return ErrorStatus(e);
+  }
+}
+
+// A multi-statement string only returns the last statement's rows, so reads
+// are merged with UNION ALL instead of semicolons. Edge queries are
+// parenthesized so that their ORDER BY and LIMIT stay their own.
+std::string PgWireDB::GenerateMergedReadQuery(const std::vector<DB_Operation> &read_operations) {
+  std::string query = "";
+  for (size_t i = 0; i < read_operations.size(); i++) {
+    const DB_Operation &operation = read_operations[i];
+    if (i > 0) {
+      query += " UNION ALL ";
+    }
+    if (operation.table == DataTable::Objects) {
+      query += "SELECT timestamp, value FROM " + object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value);
+    } else if (operation.table == DataTable::Edges) {
+      std::string id1 = std::to_string((operation.key)[0].value);
+      switch (operation.operation) {
+      case Operation::RANGEREAD:
+        query += "(SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + id1
+            + " ORDER BY id2, type LIMIT " + std::to_string(operation.limit) + ")";
+        break;
+      case Operation::COUNTREAD:
+        query += "SELECT COUNT(*), '' FROM " + edge_table_ + " WHERE id1 = " + id1
+            + " AND type = " + std::to_string((operation.key)[1].value);
+        break;
+      case Operation::TIMERANGEREAD:
+        query += "(SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + id1
+            + " AND type = " + std::to_string((operation.key)[1].value)
+            + " AND timestamp BETWEEN " + std::to_string(operation.min_timestamp)
+            + " AND " + std::to_string(operation.max_timestamp)
+            + " ORDER BY timestamp DESC LIMIT " + std::to_string(operation.limit) + ")";
+        break;
+      default:
+        query += "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + id1
+            + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value);
+      }
+    }
+  }
+  return query;
+}
+
+std::string PgWireDB::GenerateMergedInsertQuery(const std::vector<DB_Operation> &insert_operations) {
+  std::string query = "";
+  for (const DB_Operation &operation : insert_operations) {
+    if (operation.table == DataTable::Objects) {
+      query += "INSERT INTO " + object_table_ + " (id, timestamp, value) VALUES (" + std::to_string((operation.key)[0].value)
+          + ", " + std::to_string(operation.time_and_value.timestamp) + ", " + conn_->quote(operation.time_and_value.value) + ")";
+    } else if (operation.table == DataTable::Edges) {
+      std::string id1 = std::to_string((operation.key)[0].value);
+      std::string id2 = std::to_string((operation.key)[1].value);
+      std::string type = std::to_string((operation.key)[2].value);
+      std::string timestamp = std::to_string(operation.time_and_value.timestamp);
+      std::string value = conn_->quote(operation.time_and_value.value);
+      EdgeType edge_type = static_cast<EdgeType>((operation.key)[2].value);
+      query += "INSERT INTO " + edge_table_ + " (id1, id2, type, timestamp, value) SELECT " + id1 + ", " + id2 + ", "
+          + type + ", " + timestamp + ", " + value + " WHERE NOT EXISTS (SELECT 1 FROM " + edge_table_ + " WHERE "
+          + IncompatibleKeysPredicate(edge_type, id1, id2) + ")";
+    }
+    query += ";";
+  }
+  return query;
+}
+
+std::string PgWireDB::GenerateMergedUpdateQuery(const std::vector<DB_Operation> &update_operations) {
+  std::string query = "";
+  for (const DB_Operation &operation : update_operations) {
+    std::string timestamp = std::to_string(operation.time_and_value.timestamp);
+    if (operation.table == DataTable::Objects) {
+      query += "UPDATE " + object_table_ + " SET timestamp = " + timestamp + ", value = " + conn_->quote(operation.time_and_value.value)
+          + " WHERE id = " + std::to_string((operation.key)[0].value) + " AND timestamp < " + timestamp;
+    } else if (operation.table == DataTable::Edges) {
+      query += "UPDATE " + edge_table_ + " SET timestamp = " + timestamp + ", value = " + conn_->quote(operation.time_and_value.value)
+          + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value)
+          + " AND type = " + std::to_string((operation.key)[2].value) + " AND timestamp < " + timestamp;
+    }
+    query += ";";
+  }
+  return query;
+}
+
+std::string PgWireDB::GenerateMergedDeleteQuery(const std::vector<DB_Operation> &delete_operations) {
+  std::string query = "";
+  for (const DB_Operation &operation : delete_operations) {
+    std::string timestamp = std::to_string(operation.time_and_value.timestamp);
+    if (operation.table == DataTable::Objects) {
+      query += "DELETE FROM " + object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value)
+          + " AND timestamp < " + timestamp;
+    } else if (operation.table == DataTable::Edges) {
+      query += "DELETE FROM " + edge_table_ + " WHERE id1 = " + std::to_string((operation.key)[0].value)
+          + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value)
+          + " AND timestamp < " + timestamp;
+    }
+    query += ";";
+  }
+  return query;
+}
+
+} // benchmark
@@ -0,0 +1,146 @@
+#ifndef PGWIRE_DB_H_
+#define PGWIRE_DB_H_
+
+#include "db.h"
+#include "edge.h"
+#include "properties.h"
+
+#include <iostream>
+#include <string>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <pqxx/pqxx>
+
+namespace benchmark {
+
+///
+/// Driver core shared by databases that speak the PostgreSQL wire protocol
+/// (CockroachDB, YugabyteDB and PostgreSQL itself).
+///
+/// All statements, the Do* helpers and the merged-query builders live here;
+/// subclasses only override the dialect hooks below.
+///
+class PgWireDB : public DB {
+ public:
+  void Init();
+
+  void Cleanup();
+
+  Status Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &buffer);
+
+  Status Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer);
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                       int limit, std::vector<TimestampValue> &buffer);
+
+  Status Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer, // for reads
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer, bool read_only);
+
+  Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                     std::vector<TimestampValue> const &values);
+
+  Status BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                   const std::vector<Field> &ceiling_key, int n,
+                   std::vector<std::vector<Field>> &key_buffer);
+
+ protected:
+  /// Dialect hooks.
+
+  /// Prefix of this driver's properties, e.g. "crdb" for crdb.connectionstring.
+  virtual std::string PropertyPrefix() const = 0;
+
+  /// Property holding the libpq connection string.
+  virtual std::string ConnectionStringProperty() const {
+    return PropertyPrefix() + ".connectionstring";
+  }
+
+  /// Transaction execution method used when <prefix>.txn_method is not set.
+  /// "prepared" runs one prepared statement per operation; "batch" sends
+  /// semicolon-joined plain SQL.
+  virtual std::string DefaultTransactionMethod() const {
+    return "prepared";
+  }
+
+  /// WHERE clause of the batch read; $1..$3 is the floor key and $4..$6 the
+  /// ceiling key, both exclusive. Row-value comparison by default; dialects
+  /// whose planner cannot turn that into a range scan expand it instead.
+  virtual std::string BatchReadPredicate() const {
+    return "(id1, id2, type) > ($1, $2, $3) AND (id1, id2, type) < ($4, $5, $6)";
+  }
+
+  /// Returns true if @param e means the transaction lost a conflict and may be
+  /// retried, in which case it is reported as Status::kContentionError.
+  virtual bool IsContentionError(std::exception const &e) const {
+    return dynamic_cast<pqxx::serialization_failure const *>(&e) != nullptr
+        || dynamic_cast<pqxx::deadlock_detected const *>(&e) != nullptr;
+  }
+
+  /// Called at the end of Init with the connection open, so dialects can
+  /// prepare additional statements or set session variables.
+  virtual void PrepareDialectStatements() { }
+
+  pqxx::connection *conn_;
+  std::mutex mutex_;
+  std::string object_table_;
+  std::string edge_table_;
+
+ private:
+  Status ErrorStatus(std::exception const &e) const;
+
+  pqxx::result DoRead(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key);
+
+  // Runs a RANGEREAD, COUNTREAD or TIMERANGEREAD; rows are (timestamp, value),
+  // or (count, '') for a count.
+  pqxx::result DoEdgeQuery(pqxx::transaction_base &tx, const DB_Operation &operation);
+
+  pqxx::result DoUpdate(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                        TimestampValue const &value);
+
+  pqxx::result DoInsert(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                        TimestampValue const &value);
+
+  pqxx::result DoDelete(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key,
+                        TimestampValue const &value);
+
+  Status BatchInsertObjects(const std::vector<std::vector<Field>> &keys,
+                            const std::vector<TimestampValue> &values);
+
+  Status BatchInsertEdges(const std::vector<std::vector<Field>> &keys,
+                          const std::vector<TimestampValue> &values);
+
+  Status ExecuteTransactionPrepared(const std::vector<DB_Operation> &operations,
+                                    std::vector<TimestampValue> &results, bool read_only);
+
+  Status ExecuteTransactionBatch(const std::vector<DB_Operation> &operations,
+                                 std::vector<TimestampValue> &results, bool read_only);
+
+  std::string GenerateMergedReadQuery(const std::vector<DB_Operation> &read_operations);
+
+  std::string GenerateMergedInsertQuery(const std::vector<DB_Operation> &insert_operations);
+
+  std::string GenerateMergedUpdateQuery(const std::vector<DB_Operation> &update_operations);
+
+  std::string GenerateMergedDeleteQuery(const std::vector<DB_Operation> &delete_operations);
+
+  std::string txn_method_;
+};
+
+} // benchmark
+
+#endif // PGWIRE_DB_H_
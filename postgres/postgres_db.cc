@@ -0,0 +1,12 @@
+#include "postgres_db.h"
+#include "db_factory.h"
+
+namespace benchmark {
+
+DB *NewPostgresDB() {
+  return new PostgresDB;
+}
+
+const bool registered = DBFactory::RegisterDB("postgres", NewPostgresDB);
+
+} // benchmark
@@ -0,0 +1,21 @@
+#ifndef POSTGRES_DB_H_
+#define POSTGRES_DB_H_
+
+#include "pgwire_db.h"
+
+#include <string>
+
+namespace benchmark {
+
+class PostgresDB : public PgWireDB {
+ protected:
+  std::string PropertyPrefix() const {
+    return "postgres";
+  }
+};
+
+DB *NewPostgresDB();
+
+} // benchmark
+
+#endif // POSTGRES_DB_H_
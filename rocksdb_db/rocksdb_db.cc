@@ -0,0 +1,554 @@
+#include "rocksdb_db.h"
+#include "db_factory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <thread>
+
+#include <rocksdb/snapshot.h>
+#include <rocksdb/write_batch.h>
+
+namespace {
+const std::string PATH = "rocksdb.path";
+const std::string PATH_DEFAULT = "taobench-rocksdb";
+const std::string SYNC = "rocksdb.sync";
+
+// Flipping the sign bit makes the big-endian bytes of an int64 sort like the
+// int64 itself, negative ids included.
+inline void AppendId(std::string &out, int64_t id) {
+  uint64_t bits = static_cast<uint64_t>(id) ^ (uint64_t(1) << 63);
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>(bits >> shift));
+  }
+}
+
+inline int64_t ReadId(char const *bytes) {
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits = (bits << 8) | static_cast<unsigned char>(bytes[i]);
+  }
+  return static_cast<int64_t>(bits ^ (uint64_t(1) << 63));
+}
+
+inline std::string ObjectKey(int64_t id) {
+  std::string key;
+  AppendId(key, id);
+  return key;
+}
+
+inline std::string EdgeKey(int64_t id1, int64_t id2, int64_t type) {
+  std::string key;
+  key.reserve(24);
+  AppendId(key, id1);
+  AppendId(key, id2);
+  AppendId(key, type);
+  return key;
+}
+
+// Written, as a tombstone, by every insert of an edge of type from id1; read by
+// inserts whose GetIncompatibleKeys check (id1, *, type) or (id1, *).
+inline std::string GuardKey(int64_t id1, int64_t type) {
+  std::string key;
+  key.reserve(16);
+  AppendId(key, id1);
+  AppendId(key, type);
+  return key;
+}
+
+inline std::string EncodeValue(benchmark::DB::TimestampValue const &value) {
+  std::string encoded;
+  encoded.reserve(8 + value.value.size());
+  AppendId(encoded, value.timestamp);
+  encoded += value.value;
+  return encoded;
+}
+
+inline benchmark::DB::TimestampValue DecodeValue(std::string const &encoded) {
+  assert(encoded.size() >= 8);
+  return {ReadId(encoded.data()), encoded.substr(8)};
+}
+} // namespace
+
+namespace benchmark {
+
+namespace {
+inline std::string Key(DataTable table, const std::vector<DB::Field> &key) {
+  if (table == DataTable::Objects) {
+    return ObjectKey(key[0].value);
+  }
+  assert(key.size() == 3);
+  return EdgeKey(key[0].value, key[1].value, key[2].value);
+}
+
+// Write conflicts detected at commit are retried by the workload.
+inline Status ErrorStatus(rocksdb::Status const &s) {
+  if (s.IsBusy() || s.IsTryAgain()) {
+    return Status::kContentionError;
+  }
+  std::cerr << "rocksdb: " << s.ToString() << std::endl;
+  return Status::kError;
+}
+
+// RANGEREAD, COUNTREAD or TIMERANGEREAD over the edges of the id1 of op, read
+// through it. Edges are not indexed by type or timestamp, so the last two
+// walk every edge of id1.
+Status EdgeQuery(rocksdb::Iterator *it, DB::DB_Operation const &op,
+                 std::vector<DB::TimestampValue> &buffer) {
+  std::string prefix = ObjectKey(op.key[0].value);
+  int64_t count = 0;
+  std::vector<DB::TimestampValue> matches;
+  for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+    if (op.operation == Operation::RANGEREAD) {
+      if (static_cast<int>(matches.size()) >= op.limit) {
+        break;
+      }
+      matches.push_back(DecodeValue(it->value().ToString()));
+    } else if (ReadId(it->key().data() + 16) == op.key[1].value) {
+      if (op.operation == Operation::COUNTREAD) {
+        ++count;
+        continue;
+      }
+      DB::TimestampValue value = DecodeValue(it->value().ToString());
+      if (value.timestamp >= op.min_timestamp && value.timestamp <= op.max_timestamp) {
+        matches.push_back(std::move(value));
+      }
+    }
+  }
+  if (!it->status().ok()) {
+    return ErrorStatus(it->status());
+  }
+  if (op.operation == Operation::COUNTREAD) {
+    buffer.emplace_back(count, "");
+    return Status::kOK;
+  }
+  if (op.operation == Operation::TIMERANGEREAD) {
+    size_t n = std::min(matches.size(), static_cast<size_t>(std::max(op.limit, 0)));
+    std::partial_sort(matches.begin(), matches.begin() + n, matches.end(),
+                      [](DB::TimestampValue const &a, DB::TimestampValue const &b) {
+                        return a.timestamp > b.timestamp;
+                      });
+    matches.erase(matches.begin() + n, matches.end());
+  }
+  std::move(matches.begin(), matches.end(), std::back_inserter(buffer));
+  return Status::kOK;
+}
+} // namespace
+
+std::mutex RocksDB::shared_handle_mutex_;
+std::weak_ptr<RocksDB::Handle> RocksDB::shared_handle_;
+
+RocksDB::Handle::Handle(utils::Properties const &props) {
+  std::string path = props.GetProperty(PATH, PATH_DEFAULT);
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  options.create_missing_column_families = true;
+  options.IncreaseParallelism(std::max(2u, std::thread::hardware_concurrency()));
+  options.OptimizeLevelStyleCompaction();
+  std::vector<rocksdb::ColumnFamilyDescriptor> descriptors = {
+    {rocksdb::kDefaultColumnFamilyName, options},
+    {"objects", options},
+    {"edges", options},
+    {"edge_guards", options},
+  };
+  rocksdb::Status s = rocksdb::OptimisticTransactionDB::Open(options, path, descriptors,
+                                                             &column_families, &db);
+  if (!s.ok()) {
+    throw utils::Exception("Failed to open RocksDB at " + path + ": " + s.ToString());
+  }
+  objects = column_families[1];
+  edges = column_families[2];
+  guards = column_families[3];
+}
+
+RocksDB::Handle::~Handle() {
+  for (rocksdb::ColumnFamilyHandle *column_family : column_families) {
+    db->DestroyColumnFamilyHandle(column_family);
+  }
+  delete db;
+}
+
+void RocksDB::Init() {
+  {
+    std::lock_guard<std::mutex> lock(shared_handle_mutex_);
+    handle_ = shared_handle_.lock();
+    if (!handle_) {
+      handle_ = std::make_shared<Handle>(*props_);
+      shared_handle_ = handle_;
+    }
+  }
+  write_options_.sync = utils::StrToBool(props_->GetProperty(SYNC, "false"));
+}
+
+void RocksDB::Cleanup() {
+  handle_.reset();
+}
+
+template <typename F>
+Status RocksDB::InTransaction(F body) {
+  rocksdb::OptimisticTransactionOptions txn_options;
+  txn_options.set_snapshot = true;
+  std::unique_ptr<rocksdb::Transaction> txn(handle_->db->BeginTransaction(write_options_, txn_options));
+  Status s = body(txn.get());
+  if (s != Status::kOK) {
+    txn->Rollback();
+    return s;
+  }
+  rocksdb::Status commit = txn->Commit();
+  return commit.ok() ? Status::kOK : ErrorStatus(commit);
+}
+
+Status RocksDB::Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &buffer) {
+  std::string value;
+  rocksdb::Status s = handle_->db->Get(rocksdb::ReadOptions(), ColumnFamily(table), Key(table, key), &value);
+  if (s.IsNotFound()) {
+    return Status::kNotFound;
+  } else if (!s.ok()) {
+    return ErrorStatus(s);
+  }
+  buffer.push_back(DecodeValue(value));
+  return Status::kOK;
+}
+
+Status RocksDB::DoRead(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                       std::vector<TimestampValue> &buffer) {
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = txn->GetSnapshot();
+  std::string value;
+  rocksdb::Status s = txn->Get(read_options, ColumnFamily(table), Key(table, key), &value);
+  if (s.IsNotFound()) {
+    return Status::kOK;
+  } else if (!s.ok()) {
+    return ErrorStatus(s);
+  }
+  buffer.push_back(DecodeValue(value));
+  return Status::kOK;
+}
+
+Status RocksDB::Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  std::string prefix = ObjectKey(key[0].value);
+  std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(rocksdb::ReadOptions(), handle_->edges));
+  int found = 0;
+  for (it->Seek(Key(table, key)); found < n && it->Valid() && it->key().starts_with(prefix);
+       it->Next(), ++found) {
+    buffer.push_back(DecodeValue(it->value().ToString()));
+  }
+  return it->status().ok() ? Status::kOK : ErrorStatus(it->status());
+}
+
+Status RocksDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}}, TimestampValue(0, ""), Operation::RANGEREAD);
+  op.limit = limit;
+  std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(rocksdb::ReadOptions(), handle_->edges));
+  return EdgeQuery(it.get(), op, buffer);
+}
+
+Status RocksDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}, {"type", type}}, TimestampValue(0, ""),
+                  Operation::COUNTREAD);
+  std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(rocksdb::ReadOptions(), handle_->edges));
+  std::vector<TimestampValue> result;
+  Status s = EdgeQuery(it.get(), op, result);
+  if (s == Status::kOK) {
+    count = result[0].timestamp;
+  }
+  return s;
+}
+
+Status RocksDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                              int limit, std::vector<TimestampValue> &buffer) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}, {"type", type}}, TimestampValue(0, ""),
+                  Operation::TIMERANGEREAD);
+  op.limit = limit;
+  op.min_timestamp = min_timestamp;
+  op.max_timestamp = max_timestamp;
+  std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(rocksdb::ReadOptions(), handle_->edges));
+  return EdgeQuery(it.get(), op, buffer);
+}
+
+Status RocksDB::EdgeMatches(rocksdb::Transaction *txn, const std::vector<Field> &pattern,
+                            bool &matches) {
+  int64_t id1 = 0, id2 = 0;
+  bool has_id2 = false;
+  std::vector<int64_t> types;
+  for (auto const &field : pattern) {
+    if (field.name == "id1") {
+      id1 = field.value;
+    } else if (field.name == "id2") {
+      id2 = field.value;
+      has_id2 = true;
+    } else if (field.name == "type") {
+      types.push_back(field.value);
+    }
+  }
+  if (types.empty()) {
+    for (EdgeType type : {EdgeType::Unique, EdgeType::Bidirectional,
+                          EdgeType::UniqueAndBidirectional, EdgeType::Other}) {
+      types.push_back(static_cast<int64_t>(type));
+    }
+  }
+  matches = false;
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = txn->GetSnapshot();
+  std::string unused;
+  rocksdb::Status s;
+  if (has_id2) {
+    // at most one key per type, so read them for update and let the commit
+    // validate them directly
+    for (int64_t type : types) {
+      s = txn->GetForUpdate(read_options, handle_->edges, EdgeKey(id1, id2, type), &unused);
+      if (s.ok()) {
+        matches = true;
+        return Status::kOK;
+      } else if (!s.IsNotFound()) {
+        return ErrorStatus(s);
+      }
+    }
+    return Status::kOK;
+  }
+  // iterator reads are not validated, so track the guards of the types instead
+  for (int64_t type : types) {
+    s = txn->GetForUpdate(read_options, handle_->guards, GuardKey(id1, type), &unused);
+    if (!s.ok() && !s.IsNotFound()) {
+      return ErrorStatus(s);
+    }
+  }
+  std::string prefix = ObjectKey(id1);
+  std::unique_ptr<rocksdb::Iterator> it(txn->GetIterator(read_options, handle_->edges));
+  for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+    if (std::find(types.begin(), types.end(), ReadId(it->key().data() + 16)) != types.end()) {
+      matches = true;
+      break;
+    }
+  }
+  return it->status().ok() ? Status::kOK : ErrorStatus(it->status());
+}
+
+Status RocksDB::DoInsert(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                         TimestampValue const &value, bool *written) {
+  if (written) {
+    *written = true;
+  }
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = txn->GetSnapshot();
+  std::string existing;
+  rocksdb::Status s;
+  if (table == DataTable::Edges) {
+    // like INSERT ... WHERE NOT EXISTS, a blocked insert succeeds without effect
+    for (auto const &incompatible : GetIncompatibleKeys(key)) {
+      bool matches = false;
+      Status status = EdgeMatches(txn, incompatible, matches);
+      if (status != Status::kOK) {
+        return status;
+      }
+      if (matches) {
+        if (written) {
+          *written = false;
+        }
+        return Status::kOK;
+      }
+    }
+  }
+  std::string k = Key(table, key);
+  s = txn->GetForUpdate(read_options, ColumnFamily(table), k, &existing);
+  if (s.ok()) {
+    return Status::kError; // duplicate primary key
+  } else if (!s.IsNotFound()) {
+    return ErrorStatus(s);
+  }
+  s = txn->Put(ColumnFamily(table), k, EncodeValue(value));
+  if (s.ok() && table == DataTable::Edges) {
+    // untracked, so that inserts of the same id1 and type do not conflict with
+    // each other, and a tombstone, so that guards take no space once compacted
+    s = txn->DeleteUntracked(handle_->guards, GuardKey(key[0].value, key[2].value));
+  }
+  return s.ok() ? Status::kOK : ErrorStatus(s);
+}
+
+Status RocksDB::DoUpdate(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                         TimestampValue const &value) {
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = txn->GetSnapshot();
+  std::string k = Key(table, key);
+  std::string existing;
+  rocksdb::Status s = txn->GetForUpdate(read_options, ColumnFamily(table), k, &existing);
+  if (s.IsNotFound()) {
+    return Status::kOK;
+  } else if (!s.ok()) {
+    return ErrorStatus(s);
+  }
+  if (DecodeValue(existing).timestamp >= value.timestamp) {
+    return Status::kOK;
+  }
+  s = txn->Put(ColumnFamily(table), k, EncodeValue(value));
+  return s.ok() ? Status::kOK : ErrorStatus(s);
+}
+
+Status RocksDB::DoDelete(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                         TimestampValue const &value) {
+  rocksdb::ReadOptions read_options;
+  read_options.snapshot = txn->GetSnapshot();
+  std::string k = Key(table, key);
+  std::string existing;
+  rocksdb::Status s = txn->GetForUpdate(read_options, ColumnFamily(table), k, &existing);
+  if (s.IsNotFound()) {
+    return Status::kOK;
+  } else if (!s.ok()) {
+    return ErrorStatus(s);
+  }
+  if (DecodeValue(existing).timestamp >= value.timestamp) {
+    return Status::kOK;
+  }
+  s = txn->Delete(ColumnFamily(table), k);
+  return s.ok() ? Status::kOK : ErrorStatus(s);
+}
+
+Status RocksDB::Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  return InTransaction([&](rocksdb::Transaction *txn) { return DoUpdate(txn, table, key, value); });
+}
+
+Status RocksDB::Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  return InTransaction([&](rocksdb::Transaction *txn) { return DoInsert(txn, table, key, value); });
+}
+
+Status RocksDB::Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  return InTransaction([&](rocksdb::Transaction *txn) { return DoDelete(txn, table, key, value); });
+}
+
+Status RocksDB::Execute(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer, bool txn_op) {
+  switch (operation.operation) {
+  case Operation::READ:
+    return Read(operation.table, operation.key, read_buffer);
+  case Operation::INSERT:
+    return InTransaction([&](rocksdb::Transaction *txn) {
+      return DoInsert(txn, operation.table, operation.key, operation.time_and_value, &operation.written);
+    });
+  case Operation::UPDATE:
+    return Update(operation.table, operation.key, operation.time_and_value);
+  case Operation::DELETE:
+    return Delete(operation.table, operation.key, operation.time_and_value);
+  case Operation::RANGEREAD:
+  case Operation::COUNTREAD:
+  case Operation::TIMERANGEREAD:
+    return ExecuteEdgeQuery(*this, operation, read_buffer);
+  case Operation::SCAN:
+  case Operation::READMODIFYWRITE:
+  case Operation::MAXOPTYPE:
+    return Status::kNotImplemented;
+  default:
+    return Status::kNotFound;
+  }
+}
+
+Status RocksDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                   std::vector<TimestampValue> &read_buffer, bool read_only) {
+  if (read_only) {
+    // consistent reads need a snapshot but no commit-time validation
+    rocksdb::ManagedSnapshot snapshot(handle_->db);
+    rocksdb::ReadOptions read_options;
+    read_options.snapshot = snapshot.snapshot();
+    for (auto const &operation : operations) {
+      if (IsEdgeQuery(operation.operation)) {
+        std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(read_options, handle_->edges));
+        Status s = EdgeQuery(it.get(), operation, read_buffer);
+        if (s != Status::kOK) {
+          return s;
+        }
+        continue;
+      } else if (operation.operation != Operation::READ) {
+        return Status::kNotImplemented;
+      }
+      std::string value;
+      rocksdb::Status s = handle_->db->Get(read_options, ColumnFamily(operation.table),
+                                           Key(operation.table, operation.key), &value);
+      if (s.ok()) {
+        read_buffer.push_back(DecodeValue(value));
+      } else if (!s.IsNotFound()) {
+        return ErrorStatus(s);
+      }
+    }
+    return Status::kOK;
+  }
+
+  return InTransaction([&](rocksdb::Transaction *txn) {
+    for (auto const &operation : operations) {
+      Status s;
+      switch (operation.operation) {
+      case Operation::READ:
+        s = DoRead(txn, operation.table, operation.key, read_buffer);
+        break;
+      case Operation::INSERT:
+        s = DoInsert(txn, operation.table, operation.key, operation.time_and_value, &operation.written);
+        break;
+      case Operation::UPDATE:
+        s = DoUpdate(txn, operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::DELETE:
+        s = DoDelete(txn, operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::RANGEREAD:
+      case Operation::COUNTREAD:
+      case Operation::TIMERANGEREAD: {
+        // sees the transaction's own writes; not validated at commit
+        rocksdb::ReadOptions read_options;
+        read_options.snapshot = txn->GetSnapshot();
+        std::unique_ptr<rocksdb::Iterator> it(txn->GetIterator(read_options, handle_->edges));
+        s = EdgeQuery(it.get(), operation, read_buffer);
+        break;
+      }
+      default:
+        s = Status::kNotImplemented;
+      }
+      if (s != Status::kOK) {
+        return s;
+      }
+    }
+    return Status::kOK;
+  });
+}
+
+Status RocksDB::BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                            std::vector<TimestampValue> const &values) {
+  rocksdb::WriteBatch batch;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    batch.Put(ColumnFamily(table), Key(table, keys[i]), EncodeValue(values[i]));
+  }
+  rocksdb::Status s = handle_->db->Write(write_options_, &batch);
+  return s.ok() ? Status::kOK : ErrorStatus(s);
+}
+
+Status RocksDB::BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                          const std::vector<Field> &ceiling_key, int n,
+                          std::vector<std::vector<Field>> &key_buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  std::string floor = Key(table, floor_key);
+  std::string ceiling = Key(table, ceiling_key);
+  rocksdb::Slice upper_bound(ceiling);
+  rocksdb::ReadOptions read_options;
+  read_options.iterate_upper_bound = &upper_bound; // exclusive
+  std::unique_ptr<rocksdb::Iterator> it(handle_->db->NewIterator(read_options, handle_->edges));
+  it->Seek(floor);
+  if (it->Valid() && it->key() == rocksdb::Slice(floor)) {
+    it->Next(); // the floor is exclusive too
+  }
+  for (int read = 0; read < n && it->Valid(); it->Next(), ++read) {
+    char const *bytes = it->key().data();
+    key_buffer.push_back({{"id1", ReadId(bytes)},
+                          {"id2", ReadId(bytes + 8)},
+                          {"type", ReadId(bytes + 16)}});
+  }
+  return it->status().ok() ? Status::kOK : ErrorStatus(it->status());
+}
+
+DB *NewRocksDB() {
+  return new RocksDB;
+}
+
+const bool registered = DBFactory::RegisterDB("rocksdb", NewRocksDB);
+
+} // benchmark
@@ -0,0 +1,125 @@
+#ifndef ROCKSDB_DB_H_
+#define ROCKSDB_DB_H_
+
+#include "db.h"
+#include "properties.h"
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rocksdb/db.h>
+#include <rocksdb/utilities/optimistic_transaction_db.h>
+#include <rocksdb/utilities/transaction.h>
+
+namespace benchmark {
+
+///
+/// Embedded RocksDB driver, for measuring the storage engine beneath several
+/// of the distributed databases without the distribution layer.
+///
+/// Objects and edges live in their own column families. Keys are big-endian
+/// with the sign bit flipped, so that byte order is (id1, id2, type) order
+/// and BatchRead and Scan are plain iterator walks. Values are the
+/// big-endian timestamp followed by the value bytes.
+///
+/// Writes and transactions run on an OptimisticTransactionDB: keys are
+/// validated at commit and a conflict is reported as
+/// Status::kContentionError. Incompatible keys naming both ids are point
+/// reads, validated like any other. Those naming only id1 need an iterator,
+/// which is not validated, so each edge insert also writes a guard for its
+/// (id1, type) and such checks read the guards of the types they cover; two
+/// racing inserts conflict only if one's check covers the other's edge.
+///
+/// A process opens the database once; all DB instances share it.
+///
+class RocksDB : public DB {
+ public:
+  void Init();
+
+  void Cleanup();
+
+  Status Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &buffer);
+
+  // Returns up to n edges with the id1 of key, starting at key, in key order.
+  Status Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer);
+
+  // The edge queries iterate over the edges of id1, in key order.
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                       int limit, std::vector<TimestampValue> &buffer);
+
+  Status Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer, bool read_only);
+
+  Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                     std::vector<TimestampValue> const &values);
+
+  Status BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                   const std::vector<Field> &ceiling_key, int n,
+                   std::vector<std::vector<Field>> &key_buffer);
+
+ private:
+  struct Handle {
+    explicit Handle(utils::Properties const &props);
+    ~Handle();
+
+    rocksdb::OptimisticTransactionDB *db = nullptr;
+    std::vector<rocksdb::ColumnFamilyHandle *> column_families;
+    rocksdb::ColumnFamilyHandle *objects = nullptr;
+    rocksdb::ColumnFamilyHandle *edges = nullptr;
+    rocksdb::ColumnFamilyHandle *guards = nullptr;
+  };
+
+  rocksdb::ColumnFamilyHandle *ColumnFamily(DataTable table) const {
+    return table == DataTable::Edges ? handle_->edges : handle_->objects;
+  }
+
+  // Runs body in an optimistic transaction and commits it if body returns kOK.
+  template <typename F>
+  Status InTransaction(F body);
+
+  Status DoRead(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                std::vector<TimestampValue> &buffer);
+
+  // Sets @param written, if given, to whether a row was inserted.
+  Status DoInsert(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                  TimestampValue const &value, bool *written = nullptr);
+
+  Status DoUpdate(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                  TimestampValue const &value);
+
+  Status DoDelete(rocksdb::Transaction *txn, DataTable table, const std::vector<Field> &key,
+                  TimestampValue const &value);
+
+  // Sets @param matches to whether an edge matching pattern, a key from
+  // GetIncompatibleKeys, exists, tracking what it read for the commit check.
+  Status EdgeMatches(rocksdb::Transaction *txn, const std::vector<Field> &pattern, bool &matches);
+
+  std::shared_ptr<Handle> handle_;
+  rocksdb::WriteOptions write_options_;
+
+  static std::mutex shared_handle_mutex_;
+  static std::weak_ptr<Handle> shared_handle_;
+};
+
+DB *NewRocksDB();
+
+} // benchmark
+
+#endif // ROCKSDB_DB_H_
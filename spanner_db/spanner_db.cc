@@ -1,5 +1,7 @@
 #include "spanner_db.h"
 #include "google/cloud/status.h"
+#include "google/cloud/grpc_options.h"
+#include "google/cloud/spanner/options.h"
 #include <sstream>
 
 namespace {
@@ -61,6 +63,28 @@ namespace {
     "(id1, id2) = (@cid1, @cid2) AND type < @ctype) "
     "ORDER BY id1, id2, type "
     "LIMIT @n";
+  const std::string RANGE_READ_EDGES = "SELECT timestamp, value FROM edges WHERE "
+    "id1 = @id1 ORDER BY id2, type LIMIT @n";
+  const std::string COUNT_EDGES = "SELECT COUNT(*), '' FROM edges WHERE "
+    "(id1, type) = (@id1, @type)";
+  const std::string TIME_RANGE_READ_EDGES = "SELECT timestamp, value FROM edges WHERE "
+    "(id1, type) = (@id1, @type) AND timestamp BETWEEN @min AND @max "
+    "ORDER BY timestamp DESC LIMIT @n";
+
+  const std::string WRITE_METHOD = "spanner.write_method";
+  const std::string WRITE_METHOD_DEFAULT = "dml";
+  const std::string MAX_STALENESS_MS = "spanner.max_staleness_ms";
+  const std::string PARTITIONED_BATCH_READ = "spanner.partitioned_batch_read";
+  const std::string KEY_SCAN = "SELECT id1, id2, type FROM edges";
+  const std::string SHARED_CLIENT = "spanner.shared_client";
+  const std::string NUM_CHANNELS = "spanner.num_channels";
+  const std::string MIN_SESSIONS = "spanner.min_sessions";
+  const std::string MAX_SESSIONS_PER_CHANNEL = "spanner.max_sessions_per_channel";
+  const std::string KEEP_ALIVE_SECONDS = "spanner.session_keep_alive_seconds";
+  // client library defaults, used when the properties above are unset
+  const int DEFAULT_NUM_CHANNELS = 4;
+  const int DEFAULT_MAX_SESSIONS_PER_CHANNEL = 100;
+  const std::string SESSION_WAIT_METRIC = "SESSIONWAIT";
 
   namespace spanner = ::google::cloud::spanner;
 
@@ -118,27 +142,36 @@ namespace {
     });
   }
 
-  inline spanner::SqlStatement GetInsertEdgeSql(std::vector<benchmark::DB::Field> const & key,
-                                                benchmark::DB::TimestampValue const & timeval)
-  {
+  // Subquery selecting the existing edges that forbid inserting key.
+  inline std::string GetEdgeConflictSubquery(std::vector<benchmark::DB::Field> const & key) {
     assert(key.size() == 3);
     assert(key[0].name == "id1");
     assert(key[1].name == "id2");
     assert(key[2].name == "type");
     benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key[2].value);
-    std::string read_string;
     if (type == benchmark::EdgeType::Other) {
-      read_string = INSERT_EDGE_OTHER;
+      return INSERT_EDGE_OTHER;
     } else if (type == benchmark::EdgeType::Unique) {
-      read_string = INSERT_EDGE_UNIQUE;
+      return INSERT_EDGE_UNIQUE;
     } else if (type == benchmark::EdgeType::Bidirectional) {
-      read_string = INSERT_EDGE_BIDIRECTIONAL;
+      return INSERT_EDGE_BIDIRECTIONAL;
     } else if (type == benchmark::EdgeType::UniqueAndBidirectional) {
-      read_string = INSERT_EDGE_UNIQUE_BI;
-    } else {
-      throw std::runtime_error("Invalid edge type!");
+      return INSERT_EDGE_UNIQUE_BI;
     }
-    return spanner::SqlStatement(INSERT_EDGE + read_string, {
+    throw std::runtime_error("Invalid edge type!");
+  }
+
+  inline spanner::SqlStatement GetEdgeConflictSql(std::vector<benchmark::DB::Field> const & key) {
+    return spanner::SqlStatement("SELECT EXISTS " + GetEdgeConflictSubquery(key), {
+      {"id1", spanner::Value(key[0].value)},
+      {"id2", spanner::Value(key[1].value)}
+    });
+  }
+
+  inline spanner::SqlStatement GetInsertEdgeSql(std::vector<benchmark::DB::Field> const & key,
+                                                benchmark::DB::TimestampValue const & timeval)
+  {
+    return spanner::SqlStatement(INSERT_EDGE + GetEdgeConflictSubquery(key), {
       {"id1", spanner::Value(key[0].value)},
       {"id2", spanner::Value(key[1].value)},
       {"type", spanner::Value(key[2].value)},
@@ -210,11 +243,58 @@ namespace {
     });
   }
 
+  // Statement for RANGEREAD, COUNTREAD or TIMERANGEREAD; every one returns
+  // (timestamp, value) rows, a count as the timestamp of a single row.
+  inline spanner::SqlStatement GetEdgeQuerySql(benchmark::DB::DB_Operation const & op) {
+    switch (op.operation) {
+      case benchmark::Operation::RANGEREAD:
+        return spanner::SqlStatement(RANGE_READ_EDGES, {
+          {"id1", spanner::Value(op.key[0].value)},
+          {"n", spanner::Value(static_cast<int64_t>(op.limit))}
+        });
+      case benchmark::Operation::COUNTREAD:
+        return spanner::SqlStatement(COUNT_EDGES, {
+          {"id1", spanner::Value(op.key[0].value)},
+          {"type", spanner::Value(op.key[1].value)}
+        });
+      default:
+        assert(op.operation == benchmark::Operation::TIMERANGEREAD);
+        return spanner::SqlStatement(TIME_RANGE_READ_EDGES, {
+          {"id1", spanner::Value(op.key[0].value)},
+          {"type", spanner::Value(op.key[1].value)},
+          {"min", spanner::Value(op.min_timestamp)},
+          {"max", spanner::Value(op.max_timestamp)},
+          {"n", spanner::Value(static_cast<int64_t>(op.limit))}
+        });
+    }
+  }
+
+  inline int NumChannels(benchmark::utils::Properties const & props) {
+    return std::stoi(props.GetProperty(NUM_CHANNELS, std::to_string(DEFAULT_NUM_CHANNELS)));
+  }
+
+  inline int MaxSessionsPerChannel(benchmark::utils::Properties const & props) {
+    return std::stoi(props.GetProperty(MAX_SESSIONS_PER_CHANNEL,
+                                       std::to_string(DEFAULT_MAX_SESSIONS_PER_CHANNEL)));
+  }
+
   inline spanner::Client MakeClient(benchmark::utils::Properties const & props) {
     auto db = spanner::Database(props.GetProperty("project.id"),
                                 props.GetProperty("instance.id"),
                                 props.GetProperty("database.id"));
-    auto connection = spanner::MakeConnection(db);
+    auto options = google::cloud::Options{}
+        .set<google::cloud::GrpcNumChannelsOption>(NumChannels(props))
+        .set<spanner::SessionPoolMaxSessionsPerChannelOption>(MaxSessionsPerChannel(props))
+        .set<spanner::SessionPoolActionOnExhaustionOption>(spanner::ActionOnExhaustion::kBlock);
+    int min_sessions = std::stoi(props.GetProperty(MIN_SESSIONS, "0"));
+    if (min_sessions > 0) {
+      options.set<spanner::SessionPoolMinSessionsOption>(min_sessions);
+    }
+    int keep_alive = std::stoi(props.GetProperty(KEEP_ALIVE_SECONDS, "0"));
+    if (keep_alive > 0) {
+      options.set<spanner::SessionPoolKeepAliveIntervalOption>(std::chrono::seconds(keep_alive));
+    }
+    auto connection = spanner::MakeConnection(db, options);
     return spanner::Client(connection);
   }
 
@@ -227,18 +307,130 @@ namespace benchmark {
 
 SpannerDB::ConnectorInfo::ConnectorInfo(utils::Properties const & props)
   : client(MakeClient(props))
+  , free_sessions(NumChannels(props) * MaxSessionsPerChannel(props))
 {
 }
 
+void SpannerDB::ConnectorInfo::AcquireSession(Measurements *measurements) {
+  std::unique_lock<std::mutex> lock(session_mutex);
+  if (free_sessions == 0) {
+    int64_t start = utils::CurrentTimeNanos();
+    session_released.wait(lock, [this] { return free_sessions > 0; });
+    if (measurements != nullptr) {
+      measurements->ReportMetric(SESSION_WAIT_METRIC, utils::CurrentTimeNanos() - start);
+    }
+  }
+  free_sessions--;
+}
+
+void SpannerDB::ConnectorInfo::ReleaseSession() {
+  std::lock_guard<std::mutex> lock(session_mutex);
+  free_sessions++;
+  session_released.notify_one();
+}
+
+std::mutex SpannerDB::shared_info_mutex_;
+std::weak_ptr<SpannerDB::ConnectorInfo> SpannerDB::shared_info_;
+
 void SpannerDB::Init() {
-  info = new ConnectorInfo {*props_};
+  if (props_->GetProperty(SHARED_CLIENT, "false") == "true") {
+    std::lock_guard<std::mutex> lock(shared_info_mutex_);
+    info = shared_info_.lock();
+    if (!info) {
+      info = std::make_shared<ConnectorInfo>(*props_);
+      shared_info_ = info;
+    }
+  } else {
+    info = std::make_shared<ConnectorInfo>(*props_);
+  }
+  write_method_ = props_->GetProperty(WRITE_METHOD, WRITE_METHOD_DEFAULT);
+  if (write_method_ != "dml" && write_method_ != "mutation") {
+    throw std::invalid_argument("Invalid " + WRITE_METHOD + ": " + write_method_);
+  }
+  max_staleness_ = std::chrono::milliseconds(std::stol(props_->GetProperty(MAX_STALENESS_MS, "0")));
+  partitioned_batch_read_ = props_->GetProperty(PARTITIONED_BATCH_READ, "true") == "true";
+}
+
+spanner::Transaction::SingleUseOptions SpannerDB::ReadOptions() const {
+  if (max_staleness_.count() > 0) {
+    return spanner::Transaction::SingleUseOptions(max_staleness_);
+  }
+  return spanner::Transaction::SingleUseOptions(spanner::Transaction::ReadOnlyOptions());
+}
+
+StatusOr<spanner::Mutations> SpannerDB::WriteMutations(spanner::Transaction const & txn,
+                                                       Operation op,
+                                                       DataTable table,
+                                                       const std::vector<Field> &key,
+                                                       TimestampValue const & timeval)
+{
+  if (op == Operation::INSERT && table == DataTable::Objects) {
+    // no constraint beyond the primary key, which the commit enforces
+    return spanner::Mutations{spanner::MakeInsertMutation("objects",
+        {"id", "timestamp", "value"}, key[0].value, timeval.timestamp, timeval.value)};
+  } else if (op == Operation::INSERT) {
+    auto rows = info->client.ExecuteQuery(txn, GetEdgeConflictSql(key));
+    for (auto const & row : spanner::StreamOf<std::tuple<bool>>(rows)) {
+      if (!row) { return row.status(); }
+      if (std::get<0>(*row)) { return spanner::Mutations{}; }
+    }
+    return spanner::Mutations{spanner::MakeInsertMutation("edges",
+        {"id1", "id2", "type", "timestamp", "value"},
+        key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value)};
+  } else if (op != Operation::UPDATE && op != Operation::DELETE) {
+    return google::cloud::Status(google::cloud::StatusCode::kInvalidArgument,
+                                 "Invalid operation type for mutation write.");
+  }
+
+  // updates and deletes only apply over an older timestamp
+  spanner::KeySet keyset = table == DataTable::Edges ? BuildEdgeKeySet({key}) : BuildObjectKeySet({key});
+  auto rows = info->client.Read(txn, DataTableToStr(table), keyset, {"timestamp"});
+  bool apply = false;
+  for (auto const & row : spanner::StreamOf<std::tuple<int64_t>>(rows)) {
+    if (!row) { return row.status(); }
+    apply = std::get<0>(*row) < timeval.timestamp;
+  }
+  if (!apply) {
+    return spanner::Mutations{};
+  } else if (op == Operation::DELETE) {
+    return spanner::Mutations{spanner::MakeDeleteMutation(DataTableToStr(table), keyset)};
+  } else if (table == DataTable::Edges) {
+    return spanner::Mutations{spanner::MakeUpdateMutation("edges",
+        {"id1", "id2", "type", "timestamp", "value"},
+        key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value)};
+  }
+  return spanner::Mutations{spanner::MakeUpdateMutation("objects",
+      {"id", "timestamp", "value"}, key[0].value, timeval.timestamp, timeval.value)};
+}
+
+Status SpannerDB::MutationWrite(Operation op,
+                                DataTable table,
+                                const std::vector<Field> &key,
+                                TimestampValue const & timeval,
+                                bool *written)
+{
+  auto commit = info->client.Commit(
+    [&] (spanner::Transaction const & txn) -> StatusOr<spanner::Mutations> {
+      auto mutations = WriteMutations(txn, op, table, key, timeval);
+      if (mutations && written) {
+        *written = !mutations->empty();
+      }
+      return mutations;
+    }
+  );
+  if (!commit) {
+    std::cerr << "Mutation write failed - " << commit.status().message() << std::endl;
+    return IsContentionMessage(commit.status().message()) ? Status::kContentionError : Status::kError;
+  }
+  return Status::kOK;
 }
 
 void SpannerDB::Cleanup() {
-  delete info;
+  info.reset();
 }
 
 Status SpannerDB::Execute(const DB_Operation &op, std::vector<TimestampValue> &read_buffer, bool txn_op) {
+  SessionPermit permit(*info, measurements_);
   switch (op.operation) {
     case Operation::READ:
       return Read(op.table, op.key, read_buffer);
@@ -247,7 +439,11 @@ Status SpannerDB::Execute(const DB_Operation &op, std::vector<TimestampValue> &r
     case Operation::UPDATE:
       return Update(op.table, op.key, op.time_and_value);
     case Operation::INSERT:
-      return Insert(op.table, op.key, op.time_and_value);
+      return DoInsert(op.table, op.key, op.time_and_value, &op.written);
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD:
+      return ExecuteEdgeQuery(*this, op, read_buffer);
     default:
       std::cerr << "invalid operation" << std::endl;
       return Status::kNotImplemented;
@@ -259,13 +455,19 @@ Status SpannerDB::ExecuteTransaction(const std::vector<DB_Operation> &operations
                                      bool read_only)
 {
   assert(!operations.empty());
+  SessionPermit permit(*info, measurements_);
   std::vector<std::vector<Field>> edge_keys;
   std::vector<std::vector<Field>> object_keys;
   std::unordered_set<int64_t> edge_ids;
   std::unordered_set<int64_t> object_ids;
   if (read_only) {
     using RowType = std::tuple<int64_t, std::string>;
+    std::vector<DB_Operation const *> edge_queries;
     for (auto const & op : operations) {
+      if (IsEdgeQuery(op.operation)) {
+        edge_queries.push_back(&op);
+        continue;
+      }
       assert(op.operation == Operation::READ);
       if (op.table == DataTable::Edges && edge_ids.find(op.key[0].value) == edge_ids.end()) {
         edge_keys.emplace_back(op.key);
@@ -301,12 +503,37 @@ Status SpannerDB::ExecuteTransaction(const std::vector<DB_Operation> &operations
         ++num_rows_read;
       }
     }
+    for (auto const * op : edge_queries) {
+      Status s = EdgeQuery(read_only_txn, *op, read_buffer);
+      if (s != Status::kOK) { return s; }
+    }
     if (num_rows_read < object_ids.size() + edge_ids.size()) {
       std::cerr << "Warning: " << object_ids.size() + edge_ids.size() << " unique read requests sent in read "
          "transaction but only " << num_rows_read << " rows read." << std::endl;
     }
     return Status::kOK;
   } else {
+    if (write_method_ == "mutation") {
+      auto commit = info->client.Commit(
+        [&] (spanner::Transaction const & txn) -> StatusOr<spanner::Mutations> {
+          spanner::Mutations mutations;
+          for (auto const & op : operations) {
+            auto op_mutations = WriteMutations(txn, op.operation, op.table, op.key, op.time_and_value);
+            if (!op_mutations) { return op_mutations.status(); }
+            if (op.operation == Operation::INSERT) {
+              op.written = !op_mutations->empty();
+            }
+            mutations.insert(mutations.end(), op_mutations->begin(), op_mutations->end());
+          }
+          return mutations;
+        }
+      );
+      if (!commit) {
+        std::cerr << "Write transaction failed: " << commit.status().message() << std::endl;
+        return IsContentionMessage(commit.status().message()) ? Status::kContentionError : Status::kError;
+      }
+      return Status::kOK;
+    }
     std::vector<spanner::SqlStatement> dml_statements;
     for (auto const & op : operations) {
       switch (op.operation) {
@@ -334,6 +561,12 @@ Status SpannerDB::ExecuteTransaction(const std::vector<DB_Operation> &operations
         auto result = info->client.ExecuteBatchDml(txn, dml_statements);
         if (!result) { return result.status(); }
         if (!result->status.ok()) { return result->status; }
+        // one statement per operation, in order
+        for (size_t i = 0; i < operations.size() && i < result->stats.size(); ++i) {
+          if (operations[i].operation == Operation::INSERT) {
+            operations[i].written = result->stats[i].row_count > 0;
+          }
+        }
         return spanner::Mutations{};
       }
     );
@@ -351,7 +584,7 @@ Status SpannerDB::Read(DataTable table, const std::vector<Field> &key, std::vect
   using RowType = std::tuple<int64_t, std::string>;
   int num_rows_read = 0;
   spanner::KeySet keyset = table == DataTable::Edges ? BuildEdgeKeySet({key}) : BuildObjectKeySet({key});
-  auto rows = info->client.Read(DataTableToStr(table), keyset, {"timestamp", "value"});
+  auto rows = info->client.Read(ReadOptions(), DataTableToStr(table), keyset, {"timestamp", "value"});
   for (auto const & row : spanner::StreamOf<RowType>(rows)) {
     if (!row) { 
       std::cerr << "Read Failed: " << row.status().message() << std::endl;
@@ -368,6 +601,53 @@ Status SpannerDB::Read(DataTable table, const std::vector<Field> &key, std::vect
   return Status::kOK;
 }
 
+template <typename Txn>
+Status SpannerDB::EdgeQuery(Txn const & txn, DB_Operation const & op,
+                            std::vector<TimestampValue> &buffer)
+{
+  using RowType = std::tuple<int64_t, std::string>;
+  auto rows = info->client.ExecuteQuery(txn, GetEdgeQuerySql(op));
+  for (auto const & row : spanner::StreamOf<RowType>(rows)) {
+    if (!row) {
+      std::cerr << "Edge query failed: " << row.status().message() << std::endl;
+      return Status::kError;
+    }
+    buffer.emplace_back(std::get<0>(*row), std::get<1>(*row));
+  }
+  return Status::kOK;
+}
+
+Status SpannerDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  DB_Operation op(DataTable::Edges, {{"id1", id1}}, TimestampValue(0, ""), Operation::RANGEREAD);
+  op.limit = limit;
+  return EdgeQuery(ReadOptions(), op, buffer);
+}
+
+Status SpannerDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  std::vector<TimestampValue> result;
+  Status s = EdgeQuery(ReadOptions(),
+                       DB_Operation(DataTable::Edges, {{"id1", id1}, {"type", type}},
+                                    TimestampValue(0, ""), Operation::COUNTREAD),
+                       result);
+  if (s == Status::kOK) {
+    assert(result.size() == 1);
+    count = result[0].timestamp;
+  }
+  return s;
+}
+
+Status SpannerDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                                int64_t max_timestamp, int limit,
+                                std::vector<TimestampValue> &buffer)
+{
+  DB_Operation op(DataTable::Edges, {{"id1", id1}, {"type", type}}, TimestampValue(0, ""),
+                  Operation::TIMERANGEREAD);
+  op.limit = limit;
+  op.min_timestamp = min_timestamp;
+  op.max_timestamp = max_timestamp;
+  return EdgeQuery(ReadOptions(), op, buffer);
+}
+
 Status SpannerDB::Scan(DataTable table,
                       const std::vector<Field> &key,
                       int n,
@@ -379,14 +659,26 @@ Status SpannerDB::Scan(DataTable table,
 Status SpannerDB::Insert(DataTable table, const std::vector<Field> &key,
                          const TimestampValue & timeval) 
 {
+  return DoInsert(table, key, timeval, nullptr);
+}
+
+Status SpannerDB::DoInsert(DataTable table, const std::vector<Field> &key,
+                           const TimestampValue & timeval, bool *written)
+{
+  if (write_method_ == "mutation") {
+    return MutationWrite(Operation::INSERT, table, key, timeval, written);
+  }
   spanner::SqlStatement insert_stmt = table == DataTable::Edges 
       ? GetInsertEdgeSql(key, timeval)
       : GetInsertObjectSql(key, timeval);
 
   auto commit = info->client.Commit(
     [&] (spanner::Transaction const & txn) -> StatusOr<spanner::Mutations> {
-      auto insert = info->client.ExecuteDml(txn, std::move(insert_stmt));
+      auto insert = info->client.ExecuteDml(txn, insert_stmt);
       if (!insert) { return insert.status(); }
+      if (written) {
+        *written = insert->RowsModified() > 0;
+      }
       return spanner::Mutations{};
     }
   );
@@ -399,6 +691,9 @@ Status SpannerDB::Insert(DataTable table, const std::vector<Field> &key,
 
 Status SpannerDB::Update(DataTable table, const std::vector<Field> &key,
                          const TimestampValue &timeval) {
+  if (write_method_ == "mutation") {
+    return MutationWrite(Operation::UPDATE, table, key, timeval);
+  }
 
   spanner::SqlStatement update_stmt = table == DataTable::Edges
       ? GetUpdateEdgeSql(key, timeval)
@@ -420,6 +715,9 @@ Status SpannerDB::Update(DataTable table, const std::vector<Field> &key,
 
 Status SpannerDB::Delete(DataTable table, const std::vector<Field> &key,
                        const TimestampValue & timeval) {
+  if (write_method_ == "mutation") {
+    return MutationWrite(Operation::DELETE, table, key, timeval);
+  }
 
   spanner::SqlStatement delete_stmt = table == DataTable::Edges
       ? GetDeleteEdgeSql(key, timeval)
@@ -476,6 +774,49 @@ Status SpannerDB::BatchRead(DataTable table,
   return Status::kOK;
 }
 
+Status SpannerDB::ParallelBatchRead(DataTable table, int num_threads,
+                                    std::function<void(int, std::vector<Field> &&)> const &sink)
+{
+  if (!partitioned_batch_read_ || table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  // every partition of a read-only transaction reads at the same timestamp
+  auto read_only = spanner::MakeReadOnlyTransaction();
+  auto partitions = info->client.PartitionQuery(read_only, spanner::SqlStatement(KEY_SCAN));
+  if (!partitions) {
+    std::cerr << "PartitionQuery failed: " << partitions.status().message() << std::endl;
+    return Status::kError;
+  }
+  std::cout << "Reading key pool from " << partitions->size() << " partitions" << std::endl;
+
+  using RowType = std::tuple<int64_t, int64_t, int64_t>;
+  std::atomic<size_t> next_partition{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      size_t i;
+      while (!failed && (i = next_partition++) < partitions->size()) {
+        auto rows = info->client.ExecuteQuery((*partitions)[i]);
+        for (auto const & row : spanner::StreamOf<RowType>(rows)) {
+          if (!row) {
+            std::cerr << "Partition read failed: " << row.status().message() << std::endl;
+            failed = true;
+            return;
+          }
+          sink(t, {{"id1", std::get<0>(*row)},
+                   {"id2", std::get<1>(*row)},
+                   {"type", std::get<2>(*row)}});
+        }
+      }
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  return failed ? Status::kError : Status::kOK;
+}
+
 Status SpannerDB::BatchInsertObjects(DataTable table,
                                      const std::vector<std::vector<Field>> &keys,
                                      const std::vector<TimestampValue> &timevals)
@@ -4,9 +4,16 @@
 #include "properties.h"
 #include "db_factory.h"
 #include "timer.h"
+#include "measurements.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <mutex>
+#include <thread>
 #include "google/cloud/spanner/client.h"
 
 namespace benchmark {
@@ -46,6 +53,14 @@ public:
                 const std::vector<DB::Field> &key,
                 TimestampValue const & value);
 
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer);
+
   Status Execute(const DB_Operation &operation,
                  std::vector<TimestampValue> & read_buffer,
                  bool txn_op = false);
@@ -64,6 +79,11 @@ public:
                    int n, 
                    std::vector<std::vector<DB::Field>> &key_buffer);                     
 
+  // Partitions one key query with PartitionQuery and runs the partitions on
+  // num_threads threads, all at the read timestamp of a single transaction.
+  Status ParallelBatchRead(DataTable table, int num_threads,
+                           std::function<void(int, std::vector<Field> &&)> const &sink);
+
 private:
 
   struct ConnectorInfo {
@@ -71,9 +91,78 @@ private:
     ConnectorInfo(utils::Properties const & props);
 
     spanner::Client client;
+
+    // Admits at most as many concurrent requests as the session pool holds, so
+    // time spent waiting for a session can be measured instead of hidden
+    // inside the client library.
+    void AcquireSession(Measurements *measurements);
+
+    void ReleaseSession();
+
+    std::mutex session_mutex;
+    std::condition_variable session_released;
+    int free_sessions;
+  };
+
+  class SessionPermit {
+   public:
+    SessionPermit(ConnectorInfo &info, Measurements *measurements) : info_(info) {
+      info_.AcquireSession(measurements);
+    }
+    ~SessionPermit() {
+      info_.ReleaseSession();
+    }
+   private:
+    ConnectorInfo &info_;
   };
 
-  ConnectorInfo *info;
+  // Either owned by this instance or, with spanner.shared_client=true, shared
+  // by every SpannerDB in the process.
+  std::shared_ptr<ConnectorInfo> info;
+
+  // Released once the last SpannerDB using it is cleaned up.
+  static std::mutex shared_info_mutex_;
+  static std::weak_ptr<ConnectorInfo> shared_info_;
+
+  // "dml" (default) runs each write as a DML statement in a read-write
+  // transaction; "mutation" reads what the write's condition depends on and
+  // commits a mutation instead, or blind mutations where there is no condition.
+  std::string write_method_;
+
+  // Single reads use single-use read-only transactions: strong when zero,
+  // otherwise bounded by this staleness.
+  std::chrono::nanoseconds max_staleness_;
+
+  bool partitioned_batch_read_;
+
+  spanner::Transaction::SingleUseOptions ReadOptions() const;
+
+  // Mutations implementing one write inside txn; empty if its condition fails,
+  // mirroring the WHERE clause of the DML it replaces.
+  StatusOr<spanner::Mutations> WriteMutations(spanner::Transaction const & txn,
+                                              Operation op,
+                                              DataTable table,
+                                              const std::vector<DB::Field> &key,
+                                              TimestampValue const & value);
+
+  // Runs the edge query op in txn, a single-use or read-only transaction,
+  // appending its rows to buffer.
+  template <typename Txn>
+  Status EdgeQuery(Txn const & txn, DB_Operation const & op,
+                   std::vector<TimestampValue> &buffer);
+
+  // Sets *written, if given, to whether an insert wrote a row.
+  Status MutationWrite(Operation op,
+                       DataTable table,
+                       const std::vector<DB::Field> &key,
+                       TimestampValue const & value,
+                       bool *written = nullptr);
+
+  // Insert, setting *written, if given, to whether a row was written.
+  Status DoInsert(DataTable table,
+                  const std::vector<DB::Field> &key,
+                  TimestampValue const & value,
+                  bool *written);
 
   Status BatchInsertObjects(DataTable table,
                             const std::vector<std::vector<Field>> &keys,
@@ -0,0 +1,441 @@
+#include "sqlite_db.h"
+#include "db_factory.h"
+
+#include <cassert>
+
+namespace {
+const std::string PATH = "sqlite.path";
+const std::string PATH_DEFAULT = "taobench.db";
+const std::string SYNCHRONOUS = "sqlite.synchronous";
+const std::string SYNCHRONOUS_DEFAULT = "NORMAL";
+const std::string BUSY_TIMEOUT_MS = "sqlite.busy_timeout_ms";
+const std::string BUSY_TIMEOUT_MS_DEFAULT = "5000";
+const std::string CREATE_TABLES = "sqlite.create_tables";
+
+inline void BindParam(sqlite3_stmt *stmt, int index, int64_t value) {
+  sqlite3_bind_int64(stmt, index, value);
+}
+
+inline void BindParam(sqlite3_stmt *stmt, int index, std::string const &value) {
+  // the statement is reset before value goes out of scope
+  sqlite3_bind_text(stmt, index, value.data(), value.size(), SQLITE_STATIC);
+}
+
+template <typename... Args>
+inline void BindParams(sqlite3_stmt *stmt, Args const &... args) {
+  int index = 1;
+  (BindParam(stmt, index++, args), ...);
+}
+} // namespace
+
+namespace benchmark {
+
+void SqliteDB::Init() {
+  const utils::Properties &props = *props_;
+  std::string path = props.GetProperty(PATH, PATH_DEFAULT);
+  int rc = sqlite3_open_v2(path.c_str(), &db_,
+                           SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+                           nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception("Failed to open " + path + ": " + sqlite3_errstr(rc));
+  }
+  sqlite3_busy_timeout(db_, std::stoi(props.GetProperty(BUSY_TIMEOUT_MS, BUSY_TIMEOUT_MS_DEFAULT)));
+
+  std::string synchronous = props.GetProperty(SYNCHRONOUS, SYNCHRONOUS_DEFAULT);
+  if (synchronous != "OFF" && synchronous != "NORMAL" && synchronous != "FULL"
+      && synchronous != "EXTRA") {
+    throw utils::Exception("Invalid " + SYNCHRONOUS + ": " + synchronous);
+  }
+  std::string edge_table = props.GetProperty("edge_table", "edges");
+  std::string object_table = props.GetProperty("object_table", "objects");
+
+  std::vector<std::string> setup = {"PRAGMA journal_mode=WAL", "PRAGMA synchronous=" + synchronous};
+  if (utils::StrToBool(props.GetProperty(CREATE_TABLES, "true"))) {
+    setup.push_back("CREATE TABLE IF NOT EXISTS " + object_table + " ("
+                    "id INTEGER PRIMARY KEY, timestamp INTEGER, value TEXT)");
+    setup.push_back("CREATE TABLE IF NOT EXISTS " + edge_table + " ("
+                    "id1 INTEGER, id2 INTEGER, type INTEGER, timestamp INTEGER, value TEXT, "
+                    "PRIMARY KEY (id1, id2, type)) WITHOUT ROWID");
+  }
+  for (std::string const &sql : setup) {
+    char *error = nullptr;
+    if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+      std::string message = error ? error : "unknown error";
+      sqlite3_free(error);
+      throw utils::Exception(sql + " failed: " + message);
+    }
+  }
+
+  Prepare(kBegin, "BEGIN");
+  Prepare(kBeginImmediate, "BEGIN IMMEDIATE");
+  Prepare(kCommit, "COMMIT");
+  Prepare(kRollback, "ROLLBACK");
+
+  // read
+  Prepare(kReadObject, "SELECT timestamp, value FROM " + object_table + " WHERE id = ?1");
+  Prepare(kReadEdge, "SELECT timestamp, value FROM " + edge_table + " WHERE id1 = ?1 AND id2 = ?2 AND type = ?3");
+  Prepare(kScanEdges, "SELECT timestamp, value FROM " + edge_table
+      + " WHERE id1 = ?1 AND (id2, type) >= (?2, ?3) ORDER BY id2, type LIMIT ?4");
+  Prepare(kRangeReadEdges, "SELECT timestamp, value FROM " + edge_table
+      + " WHERE id1 = ?1 ORDER BY id2, type LIMIT ?2");
+  Prepare(kCountEdges, "SELECT COUNT(*), '' FROM " + edge_table + " WHERE id1 = ?1 AND type = ?2");
+  Prepare(kTimeRangeReadEdges, "SELECT timestamp, value FROM " + edge_table
+      + " WHERE id1 = ?1 AND type = ?2 AND timestamp BETWEEN ?3 AND ?4 ORDER BY timestamp DESC LIMIT ?5");
+
+  // update
+  Prepare(kUpdateObject, "UPDATE " + object_table + " SET timestamp = ?1, value = ?2 WHERE id = ?3 AND timestamp < ?1");
+  Prepare(kUpdateEdge, "UPDATE " + edge_table + " SET timestamp = ?1, value = ?2 WHERE id1 = ?3 AND id2 = ?4 AND type = ?5 AND timestamp < ?1");
+
+  // insert
+  Prepare(kInsertObject, "INSERT INTO " + object_table + " (id, timestamp, value) VALUES (?1, ?2, ?3)");
+  std::string insert_edge = "INSERT INTO " + edge_table + " (id1, id2, type, timestamp, value) "
+      "SELECT ?1, ?2, ?3, ?4, ?5 WHERE NOT EXISTS (SELECT 1 FROM " + edge_table + " WHERE ";
+  Prepare(kInsertEdgeOther, insert_edge + IncompatibleKeysPredicate(EdgeType::Other, "?1", "?2") + ")");
+  Prepare(kInsertEdgeBidirectional, insert_edge + IncompatibleKeysPredicate(EdgeType::Bidirectional, "?1", "?2") + ")");
+  Prepare(kInsertEdgeUnique, insert_edge + IncompatibleKeysPredicate(EdgeType::Unique, "?1", "?2") + ")");
+  Prepare(kInsertEdgeUniqueAndBidirectional,
+          insert_edge + IncompatibleKeysPredicate(EdgeType::UniqueAndBidirectional, "?1", "?2") + ")");
+  Prepare(kBatchInsertObject, "INSERT INTO " + object_table + " (id, timestamp, value) VALUES (?1, ?2, ?3)");
+  Prepare(kBatchInsertEdge, "INSERT INTO " + edge_table + " (id1, id2, type, timestamp, value) VALUES (?1, ?2, ?3, ?4, ?5)");
+
+  // delete
+  Prepare(kDeleteObject, "DELETE FROM " + object_table + " WHERE id = ?1 AND timestamp < ?2");
+  Prepare(kDeleteEdge, "DELETE FROM " + edge_table + " WHERE id1 = ?1 AND id2 = ?2 AND type = ?3 AND timestamp < ?4");
+
+  // batch read
+  Prepare(kBatchRead, "SELECT id1, id2, type FROM " + edge_table
+      + " WHERE (id1, id2, type) > (?1, ?2, ?3) AND (id1, id2, type) < (?4, ?5, ?6)"
+      + " ORDER BY id1, id2, type LIMIT ?7");
+}
+
+void SqliteDB::Cleanup() {
+  for (sqlite3_stmt *&stmt : statements_) {
+    sqlite3_finalize(stmt);
+    stmt = nullptr;
+  }
+  sqlite3_close(db_);
+  db_ = nullptr;
+}
+
+void SqliteDB::Prepare(Statement id, std::string const &sql) {
+  if (sqlite3_prepare_v3(db_, sql.c_str(), sql.size(), SQLITE_PREPARE_PERSISTENT,
+                         &statements_[id], nullptr) != SQLITE_OK) {
+    throw utils::Exception("Failed to prepare " + sql + ": " + sqlite3_errmsg(db_));
+  }
+}
+
+int SqliteDB::Run(Statement id, std::vector<TimestampValue> *rows) {
+  sqlite3_stmt *stmt = statements_[id];
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    if (rows) {
+      auto text = reinterpret_cast<char const *>(sqlite3_column_text(stmt, 1));
+      rows->emplace_back(sqlite3_column_int64(stmt, 0), text ? text : "NULL");
+    }
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return rc;
+}
+
+// Busy and locked mean another connection held the lock for longer than the
+// busy timeout; the workload retries those.
+Status SqliteDB::ErrorStatus(int rc) const {
+  std::cerr << "sqlite: " << sqlite3_errstr(rc) << ": " << sqlite3_errmsg(db_) << std::endl;
+  int primary = rc & 0xff;
+  return primary == SQLITE_BUSY || primary == SQLITE_LOCKED ? Status::kContentionError
+                                                             : Status::kError;
+}
+
+/*
+  key always in the order {id1, id2, type} or {id1}
+  fields always in the other {timestamp, value}
+*/
+Status SqliteDB::Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &buffer) {
+  size_t before = buffer.size();
+  int rc = DoRead(table, key, buffer);
+  if (rc != SQLITE_DONE) {
+    return ErrorStatus(rc);
+  }
+  return buffer.size() == before ? Status::kNotFound : Status::kOK;
+}
+
+int SqliteDB::DoRead(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &rows) {
+  if (table == DataTable::Objects) {
+    BindParams(statements_[kReadObject], key[0].value);
+    return Run(kReadObject, &rows);
+  } else {
+    BindParams(statements_[kReadEdge], key[0].value, key[1].value, key[2].value);
+    return Run(kReadEdge, &rows);
+  }
+}
+
+Status SqliteDB::Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  BindParams(statements_[kScanEdges], key[0].value, key[1].value, key[2].value, static_cast<int64_t>(n));
+  int rc = Run(kScanEdges, &buffer);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+Status SqliteDB::RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+  int rc = DoRangeRead(id1, limit, buffer);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+int SqliteDB::DoRangeRead(int64_t id1, int limit, std::vector<TimestampValue> &rows) {
+  BindParams(statements_[kRangeReadEdges], id1, static_cast<int64_t>(limit));
+  return Run(kRangeReadEdges, &rows);
+}
+
+Status SqliteDB::CountRead(int64_t id1, int64_t type, int64_t &count) {
+  std::vector<TimestampValue> rows;
+  int rc = DoCountRead(id1, type, rows);
+  if (rc != SQLITE_DONE) {
+    return ErrorStatus(rc);
+  }
+  count = rows[0].timestamp;
+  return Status::kOK;
+}
+
+int SqliteDB::DoCountRead(int64_t id1, int64_t type, std::vector<TimestampValue> &rows) {
+  BindParams(statements_[kCountEdges], id1, type);
+  return Run(kCountEdges, &rows);
+}
+
+Status SqliteDB::TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                               int limit, std::vector<TimestampValue> &buffer) {
+  int rc = DoTimeRangeRead(id1, type, min_timestamp, max_timestamp, limit, buffer);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+int SqliteDB::DoTimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                              int limit, std::vector<TimestampValue> &rows) {
+  BindParams(statements_[kTimeRangeReadEdges], id1, type, min_timestamp, max_timestamp,
+             static_cast<int64_t>(limit));
+  return Run(kTimeRangeReadEdges, &rows);
+}
+
+Status SqliteDB::Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  int rc = DoUpdate(table, key, value);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+int SqliteDB::DoUpdate(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  if (table == DataTable::Objects) {
+    BindParams(statements_[kUpdateObject], value.timestamp, value.value, key[0].value);
+    return Run(kUpdateObject);
+  } else {
+    BindParams(statements_[kUpdateEdge], value.timestamp, value.value,
+               key[0].value, key[1].value, key[2].value);
+    return Run(kUpdateEdge);
+  }
+}
+
+Status SqliteDB::Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  int rc = DoInsert(table, key, value);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+int SqliteDB::DoInsert(DataTable table, const std::vector<Field> &key, TimestampValue const &value,
+                       bool *written) {
+  if (table == DataTable::Objects) {
+    BindParams(statements_[kInsertObject], key[0].value, value.timestamp, value.value);
+    return Run(kInsertObject);
+  }
+  Statement id;
+  switch (static_cast<EdgeType>(key[2].value)) {
+    case EdgeType::Other:
+      id = kInsertEdgeOther;
+      break;
+    case EdgeType::Bidirectional:
+      id = kInsertEdgeBidirectional;
+      break;
+    case EdgeType::Unique:
+      id = kInsertEdgeUnique;
+      break;
+    case EdgeType::UniqueAndBidirectional:
+      id = kInsertEdgeUniqueAndBidirectional;
+      break;
+    default:
+      throw std::invalid_argument("Received unknown type");
+  }
+  BindParams(statements_[id], key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+  int rc = Run(id);
+  if (written) {
+    // the WHERE NOT EXISTS of a blocked insert selects no row
+    *written = sqlite3_changes(db_) > 0;
+  }
+  return rc;
+}
+
+Status SqliteDB::Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  int rc = DoDelete(table, key, value);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+int SqliteDB::DoDelete(DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+  if (table == DataTable::Objects) {
+    BindParams(statements_[kDeleteObject], key[0].value, value.timestamp);
+    return Run(kDeleteObject);
+  } else {
+    BindParams(statements_[kDeleteEdge], key[0].value, key[1].value, key[2].value, value.timestamp);
+    return Run(kDeleteEdge);
+  }
+}
+
+Status SqliteDB::Execute(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer, bool txn_op) {
+  switch (operation.operation) {
+  case Operation::READ:
+    return Read(operation.table, operation.key, read_buffer);
+  case Operation::INSERT: {
+    int rc = DoInsert(operation.table, operation.key, operation.time_and_value, &operation.written);
+    return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+  }
+  case Operation::UPDATE:
+    return Update(operation.table, operation.key, operation.time_and_value);
+  case Operation::DELETE:
+    return Delete(operation.table, operation.key, operation.time_and_value);
+  case Operation::RANGEREAD:
+  case Operation::COUNTREAD:
+  case Operation::TIMERANGEREAD:
+    return ExecuteEdgeQuery(*this, operation, read_buffer);
+  case Operation::SCAN:
+  case Operation::READMODIFYWRITE:
+  case Operation::MAXOPTYPE:
+    return Status::kNotImplemented;
+  default:
+    return Status::kNotFound;
+  }
+}
+
+template <typename F>
+Status SqliteDB::InTransaction(bool read_only, F body) {
+  // BEGIN IMMEDIATE takes the write lock up front, so two writers cannot
+  // deadlock upgrading their read locks
+  int rc = Run(read_only ? kBegin : kBeginImmediate);
+  if (rc != SQLITE_DONE) {
+    return ErrorStatus(rc);
+  }
+  rc = body();
+  if (rc == SQLITE_DONE) {
+    rc = Run(kCommit);
+  }
+  if (rc != SQLITE_DONE) {
+    Status s = ErrorStatus(rc);
+    if (!sqlite3_get_autocommit(db_)) {
+      Run(kRollback);
+    }
+    return s;
+  }
+  return Status::kOK;
+}
+
+Status SqliteDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                    std::vector<TimestampValue> &read_buffer, bool read_only) {
+  for (auto const &operation : operations) {
+    switch (operation.operation) {
+    case Operation::READ:
+    case Operation::INSERT:
+    case Operation::UPDATE:
+    case Operation::DELETE:
+    case Operation::RANGEREAD:
+    case Operation::COUNTREAD:
+    case Operation::TIMERANGEREAD:
+      break;
+    default:
+      return Status::kNotImplemented;
+    }
+  }
+  return InTransaction(read_only, [&] {
+    for (auto const &operation : operations) {
+      int rc = SQLITE_DONE;
+      switch (operation.operation) {
+      case Operation::READ:
+        rc = DoRead(operation.table, operation.key, read_buffer);
+        break;
+      case Operation::INSERT:
+        rc = DoInsert(operation.table, operation.key, operation.time_and_value, &operation.written);
+        break;
+      case Operation::UPDATE:
+        rc = DoUpdate(operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::DELETE:
+        rc = DoDelete(operation.table, operation.key, operation.time_and_value);
+        break;
+      case Operation::RANGEREAD:
+        rc = DoRangeRead(operation.key[0].value, operation.limit, read_buffer);
+        break;
+      case Operation::COUNTREAD:
+        rc = DoCountRead(operation.key[0].value, operation.key[1].value, read_buffer);
+        break;
+      case Operation::TIMERANGEREAD:
+        rc = DoTimeRangeRead(operation.key[0].value, operation.key[1].value, operation.min_timestamp,
+                             operation.max_timestamp, operation.limit, read_buffer);
+        break;
+      default:
+        break;
+      }
+      if (rc != SQLITE_DONE) {
+        return rc;
+      }
+    }
+    return static_cast<int>(SQLITE_DONE);
+  });
+}
+
+Status SqliteDB::BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                             std::vector<TimestampValue> const &values) {
+  return InTransaction(false, [&] {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int rc;
+      if (table == DataTable::Edges) {
+        assert(keys[i].size() == 3);
+        BindParams(statements_[kBatchInsertEdge], keys[i][0].value, keys[i][1].value,
+                   keys[i][2].value, values[i].timestamp, values[i].value);
+        rc = Run(kBatchInsertEdge);
+      } else {
+        assert(keys[i].size() == 1);
+        BindParams(statements_[kBatchInsertObject], keys[i][0].value,
+                   values[i].timestamp, values[i].value);
+        rc = Run(kBatchInsertObject);
+      }
+      if (rc != SQLITE_DONE) {
+        return rc;
+      }
+    }
+    return static_cast<int>(SQLITE_DONE);
+  });
+}
+
+Status SqliteDB::BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                           const std::vector<Field> &ceiling_key, int n,
+                           std::vector<std::vector<Field>> &key_buffer) {
+  if (table != DataTable::Edges) {
+    return Status::kNotImplemented;
+  }
+  assert(floor_key.size() == 3);
+  assert(ceiling_key.size() == 3);
+  sqlite3_stmt *stmt = statements_[kBatchRead];
+  BindParams(stmt, floor_key[0].value, floor_key[1].value, floor_key[2].value,
+             ceiling_key[0].value, ceiling_key[1].value, ceiling_key[2].value,
+             static_cast<int64_t>(n));
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    key_buffer.push_back({{"id1", sqlite3_column_int64(stmt, 0)},
+                          {"id2", sqlite3_column_int64(stmt, 1)},
+                          {"type", sqlite3_column_int64(stmt, 2)}});
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return rc == SQLITE_DONE ? Status::kOK : ErrorStatus(rc);
+}
+
+DB *NewSqliteDB() {
+  return new SqliteDB;
+}
+
+const bool registered = DBFactory::RegisterDB("sqlite", NewSqliteDB);
+
+} // benchmark
@@ -0,0 +1,129 @@
+#ifndef SQLITE_DB_H_
+#define SQLITE_DB_H_
+
+#include "db.h"
+#include "edge.h"
+#include "properties.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace benchmark {
+
+///
+/// Embedded SQLite driver. Every DB instance (one per client thread) opens its
+/// own connection to the database file in WAL mode, so readers do not block
+/// the writer, and prepares each statement once.
+///
+/// Edge inserts use the same INSERT ... WHERE NOT EXISTS statements as the
+/// other SQL drivers. Write transactions start with BEGIN IMMEDIATE; a
+/// connection that cannot get the write lock within sqlite.busy_timeout_ms
+/// reports Status::kContentionError.
+///
+class SqliteDB : public DB {
+ public:
+  void Init();
+
+  void Cleanup();
+
+  Status Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &buffer);
+
+  // Returns up to n edges with the id1 of key, starting at key, in key order.
+  Status Scan(DataTable table, const std::vector<Field> &key, int n, std::vector<TimestampValue> &buffer);
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer);
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count);
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                       int limit, std::vector<TimestampValue> &buffer);
+
+  Status Update(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer, bool read_only);
+
+  Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
+                     std::vector<TimestampValue> const &values);
+
+  Status BatchRead(DataTable table, const std::vector<Field> &floor_key,
+                   const std::vector<Field> &ceiling_key, int n,
+                   std::vector<std::vector<Field>> &key_buffer);
+
+ private:
+  enum Statement {
+    kBegin,
+    kBeginImmediate,
+    kCommit,
+    kRollback,
+    kReadObject,
+    kReadEdge,
+    kScanEdges,
+    kRangeReadEdges,
+    kCountEdges,
+    kTimeRangeReadEdges,
+    kUpdateObject,
+    kUpdateEdge,
+    kInsertObject,
+    kInsertEdgeOther,
+    kInsertEdgeBidirectional,
+    kInsertEdgeUnique,
+    kInsertEdgeUniqueAndBidirectional,
+    kBatchInsertObject,
+    kBatchInsertEdge,
+    kDeleteObject,
+    kDeleteEdge,
+    kBatchRead,
+    kNumStatements
+  };
+
+  void Prepare(Statement id, std::string const &sql);
+
+  // Runs a statement to completion, appending (timestamp, value) rows to rows
+  // if given, and resets it. Returns SQLITE_DONE on success.
+  int Run(Statement id, std::vector<TimestampValue> *rows = nullptr);
+
+  int DoRead(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &rows);
+
+  int DoRangeRead(int64_t id1, int limit, std::vector<TimestampValue> &rows);
+
+  // Appends the count as the timestamp of a single row.
+  int DoCountRead(int64_t id1, int64_t type, std::vector<TimestampValue> &rows);
+
+  int DoTimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp, int64_t max_timestamp,
+                      int limit, std::vector<TimestampValue> &rows);
+
+  int DoUpdate(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  // Sets @param written, if given, to whether a row was inserted.
+  int DoInsert(DataTable table, const std::vector<Field> &key, TimestampValue const &value,
+               bool *written = nullptr);
+
+  int DoDelete(DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+
+  // Runs statements inside BEGIN/COMMIT, rolling back if one fails.
+  template <typename F>
+  Status InTransaction(bool read_only, F body);
+
+  Status ErrorStatus(int rc) const;
+
+  sqlite3 *db_ = nullptr;
+  sqlite3_stmt *statements_[kNumStatements] = {};
+};
+
+DB *NewSqliteDB();
+
+} // benchmark
+
+#endif // SQLITE_DB_H_
@@ -0,0 +1,59 @@
+#include "adjacency_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+namespace benchmark {
+
+  void AdjacencyIndex::SortEdges(std::unordered_map<int, std::vector<Edge>> &shard_to_edges) {
+    for (auto & [shard, edges] : shard_to_edges) {
+      std::sort(edges.begin(), edges.end(), [](Edge const & a, Edge const & b) {
+        return std::tie(a.primary_key, a.type, a.remote_key) < std::tie(b.primary_key, b.type, b.remote_key);
+      });
+    }
+  }
+
+  AdjacencyIndex::AdjacencyIndex(std::unordered_map<int, std::vector<Edge>> const &shard_to_edges) {
+    for (auto const & [shard, edges] : shard_to_edges) {
+      if (edges.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many edges in one shard for the adjacency index");
+      }
+      ShardIndex & index = shards_[shard];
+      index.edges = edges.data();
+      for (uint32_t i = 0; i < edges.size(); ++i) {
+        if (i == 0 || edges[i].primary_key != edges[i-1].primary_key) {
+          index.run_of.emplace(edges[i].primary_key, index.offsets.size());
+          index.offsets.push_back(i);
+        }
+      }
+      index.offsets.push_back(edges.size());
+      num_objects_ += index.run_of.size();
+    }
+  }
+
+  AdjacencyIndex::EdgeRange AdjacencyIndex::EdgesOf(int64_t id1) const {
+    auto shard = shards_.find(GetShardFromKey(id1));
+    if (shard == shards_.end()) {
+      return {};
+    }
+    ShardIndex const & index = shard->second;
+    auto run = index.run_of.find(id1);
+    if (run == index.run_of.end()) {
+      return {};
+    }
+    return {index.edges + index.offsets[run->second], index.edges + index.offsets[run->second + 1]};
+  }
+
+  size_t AdjacencyIndex::MemoryBytes() const {
+    size_t bytes = 0;
+    for (auto const & [shard, index] : shards_) {
+      bytes += index.offsets.capacity() * sizeof(uint32_t);
+      // one node per entry plus the bucket array
+      bytes += index.run_of.size() * (sizeof(std::pair<const int64_t, uint32_t>) + sizeof(void *));
+      bytes += index.run_of.bucket_count() * sizeof(void *);
+    }
+    return bytes;
+  }
+}
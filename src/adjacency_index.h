@@ -0,0 +1,58 @@
+#pragma once
+
+#include "edge.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace benchmark {
+
+  // AdjacencyIndex finds the edges leaving an object in the run-phase key pool.
+  // It is a compressed sparse row index over each shard's edge vector: the edges
+  // are sorted by (id1, type, id2), so those of an id1 form one run, an offsets
+  // array marks where each run starts, and a hash maps id1 to its run.
+  class AdjacencyIndex {
+  public:
+
+    // The edges of one id1, sorted by (type, id2).
+    struct EdgeRange {
+      Edge const *first = nullptr;
+      Edge const *last = nullptr;
+
+      Edge const *begin() const { return first; }
+      Edge const *end() const { return last; }
+      size_t size() const { return last - first; }
+      bool empty() const { return first == last; }
+      Edge const & operator[](size_t i) const { return first[i]; }
+    };
+
+    // Sorts each shard's edges into the order the index expects; call before
+    // constructing an index over them.
+    static void SortEdges(std::unordered_map<int, std::vector<Edge>> &shard_to_edges);
+
+    // Indexes @param shard_to_edges, which must be sorted and outlive the index.
+    explicit AdjacencyIndex(std::unordered_map<int, std::vector<Edge>> const &shard_to_edges);
+
+    // Edges leaving @param id1; empty if it has none in the key pool.
+    EdgeRange EdgesOf(int64_t id1) const;
+
+    // Number of distinct id1s.
+    size_t NumObjects() const {
+      return num_objects_;
+    }
+
+    // Bytes used by the offsets and hashes, not counting the edges themselves.
+    size_t MemoryBytes() const;
+
+  private:
+    struct ShardIndex {
+      Edge const *edges = nullptr;
+      // run i spans edges[offsets[i], offsets[i+1])
+      std::vector<uint32_t> offsets;
+      std::unordered_map<int64_t, uint32_t> run_of;
+    };
+
+    std::unordered_map<int, ShardIndex> shards_;
+    size_t num_objects_ = 0;
+  };
+}
@@ -8,6 +8,7 @@
 #include <future>
 #include <chrono>
 #include <iomanip>
+#include <sstream>
 
 #include "utils.h"
 #include "timer.h"
@@ -21,6 +22,11 @@
 #include "experiment_loader.h"
 #include "constants.h"
 #include "test_workload.h"
+#include "stub_bench.h"
+#include "trace.h"
+#include "replay.h"
+#include "trace_file_workload.h"
+#include "characterize.h"
 
 void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties &props);
 bool StrStartWith(const char *str, const char *pre);
@@ -28,6 +34,7 @@ void UsageMessage(const char *command);
 
 void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties &props) {
   int argindex = 1;
+  bool have_config = false;
   while (argindex < argc && StrStartWith(argv[argindex], "-")) {
     if (strcmp(argv[argindex], "-load-threads") == 0) {
       argindex++;
@@ -71,7 +78,14 @@ void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties
         std::cerr << "Missing argument value for -c" << std::endl;
         exit(0);
       }
-      props.SetProperty("config_path", argv[argindex]);
+      // with several -c configs, the first is loaded and each runs as a tenant
+      if (!have_config) {
+        props.SetProperty("config_path", argv[argindex]);
+        props.SetProperty("tenant_configs", argv[argindex]);
+        have_config = true;
+      } else {
+        props.SetProperty("tenant_configs", props["tenant_configs"] + "," + argv[argindex]);
+      }
       argindex++;
     } else if (strcmp(argv[argindex], "-property") == 0) {
       argindex++;
@@ -119,10 +133,43 @@ void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties
       props.SetProperty("run", "true");
     } else if (strcmp(argv[argindex], "-load") == 0) {
       argindex++;
-      props.SetProperty("run", "false");
+      props.SetProperty("load", "true");
+      if (props.GetProperty("run", "false") != "true") {
+        props.SetProperty("run", "false");
+      }
     } else if (strcmp(argv[argindex], "-test") == 0) {
       argindex++;
       props.SetProperty("test", "true");
+    } else if (strcmp(argv[argindex], "-stub-bench") == 0) {
+      argindex++;
+      props.SetProperty("stub_bench", "true");
+    } else if (strcmp(argv[argindex], "-record") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument for -record (tracefile)" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("record_path", argv[argindex]);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-replay") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument for -replay (tracefile)" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("replay_path", argv[argindex]);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-characterize") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument for -characterize (tracefile)" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("characterize_path", argv[argindex]);
+      argindex++;
     } else {
       UsageMessage(argv[0]);
       std::cerr << "Unknown option '" << argv[argindex] << "'" << std::endl;
@@ -143,6 +190,7 @@ namespace OpsCounts {
 }
 
 void StatusThread(benchmark::Measurements *measurements
+                  , std::vector<benchmark::Measurements *> tenant_measurements
                   , CountDownLatch *latch
                   , int interval
                   , double warmup_period
@@ -161,6 +209,9 @@ void StatusThread(benchmark::Measurements *measurements
     duration<double> elapsed_time = now - start;
     if (!reset_post_warmup && elapsed_time.count() > warmup_period) {
       measurements->Reset();
+      for (benchmark::Measurements *tenant : tenant_measurements) {
+        tenant->Reset();
+      }
       timer->Start();
       // TODO(jchan): Resetting these counts doesn't work as intended, since
       // the client threads aren't aware of this reset.
@@ -181,6 +232,19 @@ void StatusThread(benchmark::Measurements *measurements
   };
 }
 
+// The trimmed, non-empty items of a comma-separated list.
+std::vector<std::string> SplitList(std::string const & list) {
+  std::vector<std::string> items;
+  std::istringstream stream(list);
+  for (std::string item; std::getline(stream, item, ','); ) {
+    item = benchmark::utils::Trim(item);
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
 inline bool StrStartWith(const char *str, const char *pre) {
   return strncmp(str, pre, strlen(pre)) == 0;
 }
@@ -189,15 +253,24 @@ void UsageMessage(const char *command) {
   std::cout <<
       "Usage: " << command << " [options]\n"
       "Options:\n"
-      "  -load: run the batch insert phase of the workload\n"
+      "  -load: run the batch insert phase of the workload; with -run, load then run\n"
+      "         in one process (needed for in-memory drivers such as memdb)\n"
       "  -t: run the transactions phase of the workload\n"
       "  -run: same as -t\n"
       "  -test: run test_workload\n"
+      "  -stub-bench: measure the driver's own cost per operation, against a local\n"
+      "               stub server for PostgreSQL and MySQL drivers (see USAGE.md)\n"
+      "  -record tracefile: with -run, record the requests of the run to tracefile\n"
+      "  -replay tracefile: issue the requests recorded in tracefile instead of\n"
+      "                     running the workload; with -load, load first\n"
+      "  -characterize tracefile: write a workload config derived from the requests\n"
+      "                           in tracefile (see USAGE.md)\n"
       "  -load-threads n: number of threads for batch inserts (load) or batch reads (run) (default: 1)\n"
       "  -db dbname: specify the name of the DB to use (default: basic)\n"
       "  -p propertyfile: load properties from the given file. Multiple files can\n"
       "                   be specified, and will be processed in the order specified\n"
-      "  -c configfile: load workload config from the given file\n"
+      "  -c configfile: load workload config from the given file; repeat to run\n"
+      "                 several configs as tenants (see tenant_shares in USAGE.md)\n"
       "  -e experimentfile: each line gives num_threads, num_ops, and target throughput for an experiment\n"
       "  -property name=value: specify a property to be passed to the DB and workloads\n"
       "                         multiple properties can be specified, and override any\n"
@@ -216,114 +289,62 @@ inline void ClearDBs(std::vector<benchmark::DB *> dbs) {
   dbs.clear();
 }
 
-void RunTransactions(benchmark::utils::Properties & props) {
-  const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
-
-  props.SetProperty("object_table", "objects");
-  props.SetProperty("edge_table", "edges");
-  std::string object_table = props.GetProperty("object_table", "objects");
-  std::string edge_table = props.GetProperty("edge_table", "edges");
-
-  benchmark::Measurements measurements;
-
-  // controls if we spin or sleep when we want to slow down to meet target throughput
-  const bool spin = props.GetProperty("spin", "false") == "true";
-
-  // load in experiments from experiment file
-  if  (props.GetProperty("experiment_path", "missing") == "missing") {
-    throw std::runtime_error("Must specify an experiment file");
+// A workload that a share of each experiment's client threads run, with the
+// measurements of its requests, or null for the only tenant of a run.
+struct Tenant {
+  std::string name;
+  double share;
+  benchmark::Workload *workload;
+  std::unique_ptr<benchmark::Measurements> measurements;
+};
+
+// The tenant of each of num_threads client threads, in proportion to the
+// tenants' shares, rounding by largest remainder.
+std::vector<size_t> AssignTenants(std::vector<Tenant> const & tenants, int num_threads) {
+  double total_share = 0;
+  for (Tenant const & tenant : tenants) {
+    total_share += tenant.share;
   }
-  std::vector<benchmark::ExperimentInfo> experiments = benchmark::LoadExperiments(props.GetProperty("experiment_path"));
-
-  std::vector<int> thread_counts {0, num_threads};
-  for (auto & experiment : experiments) {
-    thread_counts.push_back(experiment.num_threads);
+  std::vector<int> counts;
+  std::vector<std::pair<double, size_t>> remainders;
+  int assigned = 0;
+  for (size_t i = 0; i < tenants.size(); ++i) {
+    double exact = tenants[i].share / total_share * num_threads;
+    counts.push_back(static_cast<int>(exact));
+    remainders.emplace_back(exact - counts.back(), i);
+    assigned += counts.back();
   }
-
-  int max_concurrent_connections = *std::max_element(thread_counts.begin(), thread_counts.end());
-  props.SetProperty("max_concurrent_connections", std::to_string(max_concurrent_connections));
-
-
-  benchmark::DescribeExperiments(experiments);
-
-  // initialize DBs for batch reads
-  std::vector<benchmark::DB *> dbs;
-  for (int i = 0; i < num_threads; i++) {
-      benchmark::DB *db = benchmark::DBFactory::CreateDB(&props, &measurements);
-      if (db == nullptr) {
-          std::cerr << "Unknown database name " << props["dbname"] << std::endl;
-          exit(1);
-      }
-      dbs.push_back(db);
-  }
-  std::cout << "finished initializing DBs" << std::endl;
-
-
-  // we need at most one thread per shard
-  if (num_threads > benchmark::constants::NUM_SHARDS) {
-    throw std::invalid_argument("Number of threads (" + std::to_string(num_threads)
-        + ") must not exceed the number of shards (" + std::to_string(benchmark::constants::NUM_SHARDS));
-  }
-  int n_shards_per_thread = benchmark::constants::NUM_SHARDS / num_threads;
-
-  // temporary workload object, only used for determining load spreader distribution
-  // for batch reads
-  benchmark::TraceGeneratorWorkload wl1 {props};
-
-  // Divide up the shards evenly by thread; for each shard,
-  // the functions GetShardStartKey and GetShardEndKey return an integer such that
-  // the ID1s of all the edges corresponding to shard s lie in the open interval
-  // (GetShardStartKey(s), GetShardEndKey(s))
-  // Then using these functions and the start/end shards for each thread,
-  // we generate start/end points for batch reads from each thread.
-  std::vector<std::shared_ptr<benchmark::WorkloadLoader>> loaders;
-  for (int i = 0, start_shard = 0; i < num_threads; ++i, start_shard += n_shards_per_thread) {
-    int end_for_thread = std::min(start_shard + n_shards_per_thread,
-                                  benchmark::constants::NUM_SHARDS);
-    if (i >= benchmark::constants::NUM_SHARDS % num_threads) {
-      end_for_thread--;
-    }
-    int64_t start_key = benchmark::TraceGeneratorWorkload::GetShardStartKey(start_shard);
-    int64_t end_key = benchmark::TraceGeneratorWorkload::GetShardEndKey(end_for_thread);
-    std::cout << "begin: " << start_key << ", end: " << end_key << std::endl;
-    loaders.push_back(std::make_shared<benchmark::WorkloadLoader>(*dbs[i], start_key, end_key));
+  std::stable_sort(remainders.begin(), remainders.end(),
+                   [](auto const & a, auto const & b) { return a.first > b.first; });
+  for (size_t i = 0; assigned < num_threads; ++i, ++assigned) {
+    counts[remainders[i].second]++;
   }
-  std::cout << "loaders" << std::endl;
-
-  // Run batch reads in parallel on each thread
-  std::vector<std::future<int>> batch_read_threads;
-
-  for (int i = 0; i < num_threads; i++) {
-    batch_read_threads.emplace_back(std::async(
-      std::launch::async,
-      benchmark::BatchReadThread,
-      loaders[i],
-      std::stoi(props.GetProperty("read_batch_size", std::to_string(benchmark::constants::READ_BATCH_SIZE)))
-    ));
-  }
-
-  int invalid_batch_reads = 0;
-  for (auto &n : batch_read_threads) {
-    assert(n.valid());
-    invalid_batch_reads += n.get();
+  std::vector<size_t> tenant_of_thread;
+  for (size_t i = 0; i < tenants.size(); ++i) {
+    tenant_of_thread.insert(tenant_of_thread.end(), counts[i], i);
   }
+  return tenant_of_thread;
+}
 
-  // Combine all loaded edges and form workload distributions
-  benchmark::TraceGeneratorWorkload wl {props, loaders};
-
-  std::cout << "Number of failed batch reads: " << invalid_batch_reads << std::endl;
-  std::cout << "Done with batch read phase!" << std::endl;
-  std::cout << "Total edges read: " << wl.GetNumLoadedEdges() << std::endl;
-  ClearDBs(dbs);
-
-  std::cout << "Sleeping after batch reads." << std::endl;
-  std::this_thread::sleep_for(std::chrono::seconds(60));
-
+// Runs each experiment on the tenants' workloads with fresh connections, printing
+// its results, per tenant if there are several; recorder, if not null, is flushed
+// after each experiment.
+void RunExperiments(benchmark::utils::Properties & props,
+                    std::vector<benchmark::ExperimentInfo> const & experiments,
+                    benchmark::Measurements & measurements,
+                    std::vector<Tenant> & tenants,
+                    benchmark::TraceRecorder *recorder) {
+  // controls if we spin or sleep when we want to slow down to meet target throughput
+  const bool spin = props.GetProperty("spin", "false") == "true";
   const bool show_status = (props.GetProperty("status", "true") == "true");
   if (!show_status) {
     throw std::runtime_error("Status thread is needed to clear data from warmup period.");
   }
   const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  // requests each client thread keeps outstanding; > 1 needs a driver with async execution
+  const int max_in_flight = std::stoi(props.GetProperty("max_in_flight", "1"));
+  // time for connections (and session pools) to form before each experiment
+  const int connect_wait_seconds = std::stoi(props.GetProperty("connect_wait_seconds", "150"));
 
   benchmark::utils::Timer<double> timer;
   benchmark::utils::Timer<double> warmup_excluded_timer;
@@ -337,16 +358,26 @@ void RunTransactions(benchmark::utils::Properties & props) {
     throw std::runtime_error("Compiler does not support std::thread::hardware_concurrency");
   }
 
-  for (benchmark::ExperimentInfo & experiment : experiments) {
+  std::vector<benchmark::Measurements *> tenant_measurements;
+  for (Tenant & tenant : tenants) {
+    if (tenant.measurements) {
+      tenant_measurements.push_back(tenant.measurements.get());
+    }
+  }
+
+  for (benchmark::ExperimentInfo const & experiment : experiments) {
     int num_experiment_threads = experiment.num_threads;
     double exp_len = experiment.exp_len;
     double warmup_len = experiment.warmup_len;
     std::cout << "Running experiment: " << num_experiment_threads << " threads, " <<
       warmup_len << " seconds (warmup), " << exp_len << " seconds (experiment)" << std::endl;
 
+    std::vector<size_t> tenant_of_thread = AssignTenants(tenants, num_experiment_threads);
     std::vector<benchmark::DB *> experiment_dbs;
     for (int i = 0; i < num_experiment_threads; i++) {
-        benchmark::DB *db = benchmark::DBFactory::CreateDB(&props, &measurements);
+        Tenant & tenant = tenants[tenant_of_thread[i]];
+        benchmark::DB *db = benchmark::DBFactory::CreateDB(
+            &props, tenant.measurements ? tenant.measurements.get() : &measurements);
         if (db == nullptr) {
             std::cerr << "Unknown database name " << props["dbname"] << std::endl;
             exit(1);
@@ -357,10 +388,13 @@ void RunTransactions(benchmark::utils::Properties & props) {
     // for TiDB at least, this was needed because connections take time to form
     // might need to adjust
     std::cout << "Sleeping after sending DB connections." << std::endl;
-    std::this_thread::sleep_for(std::chrono::seconds(150));
+    std::this_thread::sleep_for(std::chrono::seconds(connect_wait_seconds));
 
     CountDownLatch latch(num_experiment_threads);
     measurements.Reset();
+    for (benchmark::Measurements *tenant : tenant_measurements) {
+      tenant->Reset();
+    }
     timer.Start();
     OpsCounts::completed_ops = OpsCounts::failed_ops = OpsCounts::overtime_ops = 0;
     warmup_excluded_timer.Start();
@@ -369,16 +403,32 @@ void RunTransactions(benchmark::utils::Properties & props) {
     // launch status update thread
     if (show_status) {
       status_future = std::async(std::launch::async, StatusThread,
-                                  &measurements, &latch, status_interval, warmup_len,
-                                  &warmup_excluded_timer);
+                                  &measurements, tenant_measurements, &latch, status_interval,
+                                  warmup_len, &warmup_excluded_timer);
+    }
+    for (Tenant & tenant : tenants) {
+      tenant.workload->BeginExperiment(tenant.measurements ? *tenant.measurements : measurements);
     }
 
     std::vector<std::future<benchmark::ClientThreadInfo>> client_threads;
     for (int i = 0; i < num_experiment_threads; ++i) {
+      if (max_in_flight > 1) {
+        client_threads.emplace_back(std::async(
+          std::launch::async,
+          benchmark::AsyncClientThread, experiment_dbs[i],
+          tenants[tenant_of_thread[i]].workload,
+          exp_len,
+          i % std::thread::hardware_concurrency(),
+          max_in_flight,
+          false,  // cleanup db, we do it separately
+          &latch
+        ));
+        continue;
+      }
       client_threads.emplace_back(std::async(
         std::launch::async,
         benchmark::ClientThread, experiment_dbs[i],
-        &wl,
+        tenants[tenant_of_thread[i]].workload,
         exp_len,
         i % std::thread::hardware_concurrency(),
         false, // initialize workload, not used rn
@@ -390,14 +440,22 @@ void RunTransactions(benchmark::utils::Properties & props) {
     }
     assert((int)client_threads.size() == num_experiment_threads);
 
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      benchmark::ClientThreadInfo info = n.get();
+    std::vector<uint64_t> tenant_failed_ops(tenants.size());
+    for (size_t i = 0; i < client_threads.size(); ++i) {
+      assert(client_threads[i].valid());
+      benchmark::ClientThreadInfo info = client_threads[i].get();
       OpsCounts::completed_ops += info.completed_ops;
       OpsCounts::overtime_ops += info.overtime_ops;
       OpsCounts::failed_ops += info.failed_ops;
+      tenant_failed_ops[tenant_of_thread[i]] += info.failed_ops;
+    }
+    for (Tenant & tenant : tenants) {
+      tenant.workload->EndExperiment();
     }
     double runtime = timer.End();
+    if (recorder) {
+      recorder->Flush();
+    }
     double warmup_excluded_runtime = warmup_excluded_timer.End();
 
     if (show_status) {
@@ -416,14 +474,182 @@ void RunTransactions(benchmark::utils::Properties & props) {
     std::cout << "Number of overtime operations: " << OpsCounts::overtime_ops << std::endl;
     std::cout << "Number of failed operations: " << OpsCounts::failed_ops << std::endl;
     std::cout << measurements.GetStatusMsg() << std::endl;
+    for (size_t i = 0; i < tenants.size() && tenants.size() > 1; ++i) {
+      benchmark::Measurements & tenant_measurements = *tenants[i].measurements;
+      std::cout << "Tenant " << i + 1 << "/" << tenants.size() << " (" << tenants[i].name << "), "
+                << std::count(tenant_of_thread.begin(), tenant_of_thread.end(), i) << " threads: "
+                << "throughput excluding warmup "
+                << tenant_measurements.GetTotalNumOps()/warmup_excluded_runtime << ", "
+                << tenant_failed_ops[i] << " failed operations" << std::endl;
+      std::cout << "Tenant " << i + 1 << "/" << tenants.size() << " (" << tenants[i].name << "): "
+                << tenant_measurements.GetStatusMsg() << std::endl;
+    }
     std::cout << std::endl;
 
     ClearDBs(experiment_dbs);
     // sleep between experiments
-    std::this_thread::sleep_for(std::chrono::seconds(150));
+    std::this_thread::sleep_for(std::chrono::seconds(
+        std::stoi(props.GetProperty("experiment_wait_seconds", "150"))));
   }
 }
 
+void RunTransactions(benchmark::utils::Properties & props) {
+  const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
+
+  props.SetProperty("object_table", "objects");
+  props.SetProperty("edge_table", "edges");
+  std::string object_table = props.GetProperty("object_table", "objects");
+  std::string edge_table = props.GetProperty("edge_table", "edges");
+
+  benchmark::Measurements measurements;
+
+  // load in experiments from experiment file
+  if  (props.GetProperty("experiment_path", "missing") == "missing") {
+    throw std::runtime_error("Must specify an experiment file");
+  }
+  std::vector<benchmark::ExperimentInfo> experiments = benchmark::LoadExperiments(props.GetProperty("experiment_path"));
+
+  std::vector<int> thread_counts {0, num_threads};
+  for (auto & experiment : experiments) {
+    thread_counts.push_back(experiment.num_threads);
+  }
+
+  int max_concurrent_connections = *std::max_element(thread_counts.begin(), thread_counts.end());
+  props.SetProperty("max_concurrent_connections", std::to_string(max_concurrent_connections));
+
+
+  benchmark::DescribeExperiments(experiments);
+
+  // a trace brings its own keys, so there is no key pool to read
+  if (props.ContainsKey("trace.path")) {
+    benchmark::TraceFileWorkload wl {props};
+    std::vector<Tenant> tenants;
+    tenants.push_back({props["trace.path"], 1, &wl, nullptr});
+    RunExperiments(props, experiments, measurements, tenants, nullptr);
+    return;
+  }
+
+  // initialize DBs for batch reads
+  std::vector<benchmark::DB *> dbs;
+  for (int i = 0; i < num_threads; i++) {
+      benchmark::DB *db = benchmark::DBFactory::CreateDB(&props, &measurements);
+      if (db == nullptr) {
+          std::cerr << "Unknown database name " << props["dbname"] << std::endl;
+          exit(1);
+      }
+      dbs.push_back(db);
+  }
+  std::cout << "finished initializing DBs" << std::endl;
+
+
+  // we need at most one thread per shard
+  if (num_threads > benchmark::constants::NUM_SHARDS) {
+    throw std::invalid_argument("Number of threads (" + std::to_string(num_threads)
+        + ") must not exceed the number of shards (" + std::to_string(benchmark::constants::NUM_SHARDS));
+  }
+  int n_shards_per_thread = benchmark::constants::NUM_SHARDS / num_threads;
+
+  // temporary workload object, only used for determining load spreader distribution
+  // for batch reads
+  benchmark::TraceGeneratorWorkload wl1 {props};
+
+  // Divide up the shards evenly by thread; for each shard,
+  // the functions GetShardStartKey and GetShardEndKey return an integer such that
+  // the ID1s of all the edges corresponding to shard s lie in the open interval
+  // (GetShardStartKey(s), GetShardEndKey(s))
+  // Then using these functions and the start/end shards for each thread,
+  // we generate start/end points for batch reads from each thread.
+  std::vector<std::shared_ptr<benchmark::WorkloadLoader>> loaders;
+  for (int i = 0, start_shard = 0; i < num_threads; ++i, start_shard += n_shards_per_thread) {
+    int end_for_thread = std::min(start_shard + n_shards_per_thread,
+                                  benchmark::constants::NUM_SHARDS);
+    if (i >= benchmark::constants::NUM_SHARDS % num_threads) {
+      end_for_thread--;
+    }
+    int64_t start_key = benchmark::TraceGeneratorWorkload::GetShardStartKey(start_shard);
+    int64_t end_key = benchmark::TraceGeneratorWorkload::GetShardEndKey(end_for_thread);
+    std::cout << "begin: " << start_key << ", end: " << end_key << std::endl;
+    loaders.push_back(std::make_shared<benchmark::WorkloadLoader>(*dbs[i], start_key, end_key));
+  }
+  std::cout << "loaders" << std::endl;
+
+  // Let the driver scan the whole edge table in parallel if it can; each of its
+  // threads fills one loader, so the loaders' shard maps need no locking.
+  benchmark::Status parallel_read = dbs[0]->ParallelBatchRead(
+    benchmark::DataTable::Edges, num_threads,
+    [&loaders](int thread, std::vector<benchmark::DB::Field> &&key) {
+      loaders[thread]->AddReadEdge(key);
+    });
+  if (parallel_read == benchmark::Status::kError) {
+    throw std::runtime_error("Terminal: Parallel batch read failure.");
+  }
+
+  // Otherwise run paginated batch reads in parallel on each thread
+  std::vector<std::future<int>> batch_read_threads;
+
+  if (parallel_read == benchmark::Status::kNotImplemented) {
+    for (int i = 0; i < num_threads; i++) {
+      batch_read_threads.emplace_back(std::async(
+        std::launch::async,
+        benchmark::BatchReadThread,
+        loaders[i],
+        std::stoi(props.GetProperty("read_batch_size", std::to_string(benchmark::constants::READ_BATCH_SIZE)))
+      ));
+    }
+  }
+
+  int invalid_batch_reads = 0;
+  for (auto &n : batch_read_threads) {
+    assert(n.valid());
+    invalid_batch_reads += n.get();
+  }
+
+  // Combine all loaded edges and form workload distributions
+  benchmark::TraceGeneratorWorkload wl {props, loaders};
+
+  std::cout << "Number of failed batch reads: " << invalid_batch_reads << std::endl;
+  std::cout << "Done with batch read phase!" << std::endl;
+  std::cout << "Total edges read: " << wl.GetNumLoadedEdges() << std::endl;
+  ClearDBs(dbs);
+
+  std::unique_ptr<benchmark::TraceRecorder> recorder;
+  if (props.ContainsKey("record_path")) {
+    recorder = std::make_unique<benchmark::TraceRecorder>(props["record_path"]);
+  }
+
+  // each config after the first runs as another tenant over the same keys
+  std::vector<std::string> configs = SplitList(props.GetProperty("tenant_configs", props["config_path"]));
+  std::vector<std::string> shares = SplitList(props.GetProperty("tenant_shares", ""));
+  if (!shares.empty() && shares.size() != configs.size()) {
+    throw std::invalid_argument("tenant_shares needs a share for each -c config");
+  }
+  std::vector<std::unique_ptr<benchmark::TraceGeneratorWorkload>> other_tenants;
+  std::vector<Tenant> tenants;
+  for (size_t i = 0; i < configs.size(); ++i) {
+    benchmark::TraceGeneratorWorkload *tenant_wl = &wl;
+    if (i > 0) {
+      benchmark::utils::Properties tenant_props = props;
+      tenant_props.SetProperty("config_path", configs[i]);
+      other_tenants.push_back(std::make_unique<benchmark::TraceGeneratorWorkload>(tenant_props, wl));
+      tenant_wl = other_tenants.back().get();
+    }
+    tenant_wl->SetRecorder(recorder.get());
+    double share = shares.empty() ? 1 : std::stod(shares[i]);
+    if (share <= 0) {
+      throw std::invalid_argument("tenant_shares must be positive");
+    }
+    tenants.push_back({configs[i], share, tenant_wl,
+                       configs.size() > 1 ? std::make_unique<benchmark::Measurements>(&measurements)
+                                          : nullptr});
+  }
+
+  std::cout << "Sleeping after batch reads." << std::endl;
+  std::this_thread::sleep_for(std::chrono::seconds(
+      std::stoi(props.GetProperty("read_wait_seconds", "60"))));
+
+  RunExperiments(props, experiments, measurements, tenants, recorder.get());
+}
+
 void RunBatchInsert(benchmark::utils::Properties & props) {
   std::cout << "Running batch insert phase!" << std::endl;
   const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
@@ -448,8 +674,14 @@ void RunBatchInsert(benchmark::utils::Properties & props) {
   }
   std::cout << "Created DBs" << std::endl;
   std::vector<std::shared_ptr<benchmark::WorkloadLoader>> loaders;
+  // with load_seed set, each thread of a graph-shaped load makes the same
+  // choices every run
+  std::string load_seed = props.GetProperty("load_seed", "");
   for (int i = 0; i < num_threads; ++i) {
     loaders.push_back(std::make_shared<benchmark::WorkloadLoader>(*dbs[i]));
+    if (!load_seed.empty()) {
+      loaders[i]->graph.gen.seed(std::stoul(load_seed) + i);
+    }
   }
 
   long total_keys = std::stol(props.GetProperty("num_edges", "165000000"));
@@ -496,13 +728,30 @@ int main(const int argc, const char *argv[]) {
     std::cout << "running benchmark!" << std::endl;
 
     bool test = props.GetProperty("test", "false") == "true";
+    bool stub_bench = props.GetProperty("stub_bench", "false") == "true";
+    bool replay = props.ContainsKey("replay_path");
+    bool characterize = props.ContainsKey("characterize_path");
     std::string run_phase;
-    if ((run_phase=props.GetProperty("run", "missing")) == "missing" && !test) {
+    if ((run_phase=props.GetProperty("run", "missing")) == "missing" && !test && !stub_bench
+        && !replay && !characterize) {
       throw std::invalid_argument("Must explicitly select run/load phase of workload!");
     }
     bool run = run_phase == "true";
-
-    if (run) {
+    bool load = props.GetProperty("load", "false") == "true";
+
+    if (stub_bench) {
+      benchmark::RunStubBench(props);
+    } else if (characterize) {
+      benchmark::RunCharacterize(props);
+    } else if (replay) {
+      if (load) {
+        RunBatchInsert(props);
+      }
+      benchmark::RunReplay(props);
+    } else if (run) {
+      if (load) {
+        RunBatchInsert(props);
+      }
       RunTransactions(props);
     } else if (test) {
       RunTestWorkload(props);
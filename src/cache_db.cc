@@ -0,0 +1,443 @@
+#include "cache_db.h"
+#include "measurements.h"
+#include "parse_config.h"
+#include "timer.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+  const std::string ENABLED = "cache.enabled";
+  const std::string CAPACITY = "cache.capacity";
+  const std::string SHARDS = "cache.shards";
+  const std::string LEASE_WAIT_US = "cache.lease_wait_us";
+  const std::string READ_TIERS = "cache.read_tiers";
+  const std::string DEFAULT_CAPACITY = "1000000";
+  const std::string DEFAULT_SHARDS = "64";
+}
+
+namespace benchmark {
+
+namespace {
+
+struct CacheKey {
+  DataTable table;
+  int64_t id1;
+  int64_t id2;
+  int64_t type;
+
+  bool operator==(CacheKey const &other) const {
+    return table == other.table && id1 == other.id1 && id2 == other.id2 && type == other.type;
+  }
+};
+
+struct CacheKeyHash {
+  size_t operator()(CacheKey const &key) const {
+    uint64_t hash = utils::Hash(key.id1);
+    hash = hash * 31 + utils::Hash(key.id2);
+    hash = hash * 31 + utils::Hash(key.type);
+    return hash * 2 + static_cast<int>(key.table);
+  }
+};
+
+CacheKey ToCacheKey(DataTable table, std::vector<DB::Field> const &key) {
+  if (table == DataTable::Objects) {
+    return {table, key[0].value, 0, 0};
+  }
+  assert(key.size() == 3);
+  return {table, key[0].value, key[1].value, key[2].value};
+}
+
+// Edge queries and reads leave the cache alone.
+inline bool IsWrite(Operation op) {
+  return op == Operation::INSERT || op == Operation::UPDATE || op == Operation::DELETE;
+}
+
+} // namespace
+
+///
+/// Process-wide cache shared by every CacheDB. Each shard has its own mutex
+/// and evicts with the CLOCK algorithm: a hit only sets a reference bit, and
+/// the hand clears bits until it finds an entry that was not used since its
+/// last pass.
+///
+class ObjectCache {
+ public:
+  enum class Lookup {
+    kHit,
+    kMiss, // the caller holds the lease and should Fill or Release
+    kBusy  // another reader holds the lease
+  };
+
+  ObjectCache(size_t capacity, int num_shards)
+    : shards_(num_shards)
+  {
+    for (Shard &shard : shards_) {
+      shard.capacity = std::max<size_t>(1, capacity / num_shards);
+    }
+  }
+
+  Lookup Get(CacheKey const &key, std::optional<DB::TimestampValue> &value, uint64_t &lease) {
+    Shard &shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      Slot &slot = shard.slots[it->second];
+      slot.referenced = true;
+      value = slot.value;
+      return Lookup::kHit;
+    }
+    return TakeLease(shard, key, lease);
+  }
+
+  // Takes a lease without looking the key up, for reads that bypass the cache.
+  Lookup Lease(CacheKey const &key, uint64_t &lease) {
+    Shard &shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return TakeLease(shard, key, lease);
+  }
+
+  // Waits until nobody holds a lease on key, or until timeout has passed.
+  void WaitForLease(CacheKey const &key, std::chrono::microseconds timeout) {
+    Shard &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    shard.released.wait_for(lock, timeout, [&] { return shard.leases.count(key) == 0; });
+  }
+
+  // Stores value unless the lease was revoked by an invalidation.
+  void Fill(CacheKey const &key, uint64_t lease, DB::TimestampValue const &value) {
+    Shard &shard = ShardOf(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto held = shard.leases.find(key);
+      if (held == shard.leases.end() || held->second != lease) {
+        return;
+      }
+      shard.leases.erase(held);
+      Store(shard, key, value);
+    }
+    shard.released.notify_all();
+  }
+
+  void Release(CacheKey const &key, uint64_t lease) {
+    Shard &shard = ShardOf(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto held = shard.leases.find(key);
+      if (held == shard.leases.end() || held->second != lease) {
+        return;
+      }
+      shard.leases.erase(held);
+    }
+    shard.released.notify_all();
+  }
+
+  // Drops key and revokes any lease on it, so an in-flight fill is discarded.
+  void Invalidate(CacheKey const &key) {
+    Shard &shard = ShardOf(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.leases.erase(key);
+      auto it = shard.index.find(key);
+      if (it != shard.index.end()) {
+        Slot &slot = shard.slots[it->second];
+        slot.value.reset();
+        slot.referenced = false;
+        shard.index.erase(it);
+      }
+    }
+    shard.released.notify_all();
+  }
+
+ private:
+  struct Slot {
+    CacheKey key;
+    std::optional<DB::TimestampValue> value; // empty if the slot is free
+    bool referenced;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::condition_variable released;
+    size_t capacity = 0;
+    std::vector<Slot> slots;
+    size_t hand = 0;
+    std::unordered_map<CacheKey, size_t, CacheKeyHash> index;
+    std::unordered_map<CacheKey, uint64_t, CacheKeyHash> leases;
+    uint64_t next_lease = 1;
+  };
+
+  Shard &ShardOf(CacheKey const &key) {
+    return shards_[CacheKeyHash()(key) % shards_.size()];
+  }
+
+  Lookup TakeLease(Shard &shard, CacheKey const &key, uint64_t &lease) {
+    auto [held, granted] = shard.leases.emplace(key, shard.next_lease);
+    if (!granted) {
+      return Lookup::kBusy;
+    }
+    lease = shard.next_lease++;
+    return Lookup::kMiss;
+  }
+
+  // The caller holds shard.mutex.
+  void Store(Shard &shard, CacheKey const &key, DB::TimestampValue const &value) {
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.slots[it->second].value = value;
+      shard.slots[it->second].referenced = true;
+      return;
+    }
+    if (shard.slots.size() < shard.capacity) {
+      shard.index.emplace(key, shard.slots.size());
+      shard.slots.push_back(Slot{key, value, false});
+      return;
+    }
+    while (true) {
+      Slot &slot = shard.slots[shard.hand];
+      if (slot.value && slot.referenced) {
+        slot.referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+        continue;
+      }
+      if (slot.value) {
+        shard.index.erase(slot.key);
+      }
+      slot = Slot{key, value, false};
+      shard.index.emplace(key, shard.hand);
+      shard.hand = (shard.hand + 1) % shard.slots.size();
+      return;
+    }
+  }
+
+  std::vector<Shard> shards_;
+};
+
+namespace {
+  std::mutex cache_mutex;
+  std::weak_ptr<ObjectCache> shared_cache;
+
+  std::shared_ptr<ObjectCache> SharedCache(utils::Properties const &props) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::shared_ptr<ObjectCache> cache = shared_cache.lock();
+    if (!cache) {
+      size_t capacity = std::stoull(props.GetProperty(CAPACITY, DEFAULT_CAPACITY));
+      int num_shards = std::stoi(props.GetProperty(SHARDS, DEFAULT_SHARDS));
+      if (num_shards <= 0) {
+        throw std::invalid_argument(SHARDS + " must be positive");
+      }
+      cache = std::make_shared<ObjectCache>(capacity, num_shards);
+      shared_cache = cache;
+    }
+    return cache;
+  }
+}
+
+bool CacheDB::Enabled(utils::Properties const &props) {
+  return utils::StrToBool(props.GetProperty(ENABLED, "false"));
+}
+
+CacheDB::CacheDB(DB *db, utils::Properties *props, Measurements *measurements)
+    : db_(db)
+    , cache_(SharedCache(*props))
+    , lease_wait_us_(std::stoll(props->GetProperty(LEASE_WAIT_US, "0")))
+    , rng_(std::random_device{}()) {
+  SetProps(props);
+  SetMeasurements(measurements);
+  if (measurements) {
+    hit_metric_ = measurements->GetMetric("CACHE_HIT");
+    miss_metric_ = measurements->GetMetric("CACHE_MISS");
+  }
+  if (utils::StrToBool(props->GetProperty(READ_TIERS, "false"))) {
+    ConfigParser config(props->GetProperty("config_path"));
+    auto tiers = config.fields.find("read_tiers");
+    if (tiers == config.fields.end()) {
+      throw std::invalid_argument(READ_TIERS + " is set but the config has no read_tiers line");
+    }
+    auto const &types = tiers->second.types;
+    auto db = std::find(types.begin(), types.end(), "db");
+    if (db == types.end()) {
+      throw std::invalid_argument("read_tiers has no db tier");
+    }
+    db_tier_ = db - types.begin();
+    read_tiers_ = tiers->second.distribution;
+  }
+}
+
+CacheDB::~CacheDB() {
+  delete db_;
+}
+
+bool CacheDB::BypassCache() {
+  return db_tier_ >= 0 && read_tiers_(rng_) == db_tier_;
+}
+
+void CacheDB::ReportMetric(Metric *metric, int64_t start) {
+  if (metric) {
+    metric->Report(utils::CurrentTimeNanos() - start);
+  }
+}
+
+Status CacheDB::Read(DataTable table, const std::vector<Field> &key,
+                     std::vector<TimestampValue> &buffer) {
+  return CachedRead(DB_Operation(table, key, TimestampValue(0, ""), Operation::READ), buffer);
+}
+
+Status CacheDB::CachedRead(const DB_Operation &operation,
+                           std::vector<TimestampValue> &read_buffer) {
+  int64_t start = utils::CurrentTimeNanos();
+  CacheKey cache_key = ToCacheKey(operation.table, operation.key);
+  bool bypass = BypassCache();
+  std::optional<TimestampValue> value;
+  uint64_t lease = 0;
+  ObjectCache::Lookup lookup = bypass ? cache_->Lease(cache_key, lease)
+                                      : cache_->Get(cache_key, value, lease);
+  if (lookup == ObjectCache::Lookup::kBusy && lease_wait_us_ > 0 && !bypass) {
+    cache_->WaitForLease(cache_key, std::chrono::microseconds(lease_wait_us_));
+    lookup = cache_->Get(cache_key, value, lease);
+  }
+  if (lookup == ObjectCache::Lookup::kHit) {
+    read_buffer.push_back(std::move(*value));
+    ReportMetric(hit_metric_, start);
+    return Status::kOK;
+  }
+
+  // through Execute, so that wrappers such as LatencyDB see the miss
+  size_t before = read_buffer.size();
+  Status s = db_->Execute(operation, read_buffer);
+  if (lookup == ObjectCache::Lookup::kMiss) {
+    if (s == Status::kOK && read_buffer.size() > before) {
+      cache_->Fill(cache_key, lease, read_buffer[before]);
+    } else {
+      cache_->Release(cache_key, lease);
+    }
+  }
+  ReportMetric(miss_metric_, start);
+  return s;
+}
+
+Status CacheDB::Update(DataTable table, const std::vector<Field> &key,
+                       const TimestampValue &value) {
+  Status s = db_->Update(table, key, value);
+  cache_->Invalidate(ToCacheKey(table, key));
+  return s;
+}
+
+Status CacheDB::Insert(DataTable table, const std::vector<Field> &key,
+                       const TimestampValue &value) {
+  Status s = db_->Insert(table, key, value);
+  cache_->Invalidate(ToCacheKey(table, key));
+  return s;
+}
+
+Status CacheDB::Delete(DataTable table, const std::vector<Field> &key,
+                       const TimestampValue &value) {
+  Status s = db_->Delete(table, key, value);
+  cache_->Invalidate(ToCacheKey(table, key));
+  return s;
+}
+
+Status CacheDB::Execute(const DB_Operation &operation,
+                        std::vector<TimestampValue> &read_buffer,
+                        bool txn_op) {
+  switch (operation.operation) {
+    case Operation::READ:
+      return CachedRead(operation, read_buffer);
+    case Operation::INSERT:
+    case Operation::UPDATE:
+    case Operation::DELETE: {
+      Status s = db_->Execute(operation, read_buffer, txn_op);
+      cache_->Invalidate(ToCacheKey(operation.table, operation.key));
+      return s;
+    }
+    default:
+      return db_->Execute(operation, read_buffer, txn_op);
+  }
+}
+
+Status CacheDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                   std::vector<TimestampValue> &read_buffer,
+                                   bool read_only) {
+  Status s = db_->ExecuteTransaction(operations, read_buffer, read_only);
+  for (auto const &op : operations) {
+    if (IsWrite(op.operation)) {
+      cache_->Invalidate(ToCacheKey(op.table, op.key));
+    }
+  }
+  return s;
+}
+
+void CacheDB::ExecuteAsync(const DB_Operation &operation,
+                           std::vector<TimestampValue> &read_buffer,
+                           std::function<void(Status)> callback) {
+  if (IsEdgeQuery(operation.operation)) {
+    db_->ExecuteAsync(operation, read_buffer, std::move(callback));
+    return;
+  }
+  std::shared_ptr<ObjectCache> cache = cache_;
+  CacheKey cache_key = ToCacheKey(operation.table, operation.key);
+  if (operation.operation != Operation::READ) {
+    db_->ExecuteAsync(operation, read_buffer, [cache, cache_key, callback](Status s) {
+      cache->Invalidate(cache_key);
+      callback(s);
+    });
+    return;
+  }
+
+  // same as CachedRead, except that a busy lease never waits
+  int64_t start = utils::CurrentTimeNanos();
+  bool bypass = BypassCache();
+  std::optional<TimestampValue> value;
+  uint64_t lease = 0;
+  ObjectCache::Lookup lookup = bypass ? cache_->Lease(cache_key, lease)
+                                      : cache_->Get(cache_key, value, lease);
+  if (lookup == ObjectCache::Lookup::kHit) {
+    read_buffer.push_back(std::move(*value));
+    ReportMetric(hit_metric_, start);
+    callback(Status::kOK);
+    return;
+  }
+  std::vector<TimestampValue> *buffer = &read_buffer;
+  size_t before = read_buffer.size();
+  Metric *miss_metric = miss_metric_;
+  db_->ExecuteAsync(operation, read_buffer,
+                    [=](Status s) {
+    if (lookup == ObjectCache::Lookup::kMiss) {
+      if (s == Status::kOK && buffer->size() > before) {
+        cache->Fill(cache_key, lease, (*buffer)[before]);
+      } else {
+        cache->Release(cache_key, lease);
+      }
+    }
+    ReportMetric(miss_metric, start);
+    callback(s);
+  });
+}
+
+void CacheDB::ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                                      std::vector<TimestampValue> &read_buffer,
+                                      bool read_only,
+                                      std::function<void(Status)> callback) {
+  std::shared_ptr<ObjectCache> cache = cache_;
+  std::vector<CacheKey> written;
+  for (auto const &op : operations) {
+    if (IsWrite(op.operation)) {
+      written.push_back(ToCacheKey(op.table, op.key));
+    }
+  }
+  db_->ExecuteTransactionAsync(operations, read_buffer, read_only,
+                               [cache, written, callback](Status s) {
+    for (CacheKey const &key : written) {
+      cache->Invalidate(key);
+    }
+    callback(s);
+  });
+}
+
+} // benchmark
@@ -0,0 +1,140 @@
+#ifndef CACHE_DB_H_
+#define CACHE_DB_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "db.h"
+#include "properties.h"
+
+namespace benchmark {
+
+class Metric;
+class ObjectCache;
+
+///
+/// Read-through cache tier in front of another driver, as TAO sits in front
+/// of MySQL. Point reads are served from a process-wide, sharded CLOCK cache
+/// of objects and edges and fill it on a miss; writes go to the driver and
+/// then invalidate the keys they touched. Transactions always go to the
+/// driver, and so do the edge queries (RANGEREAD, COUNTREAD, TIMERANGEREAD).
+///
+/// A miss takes a lease on its key, and a fill is only stored if the lease is
+/// still held, so an invalidation racing with a fill cannot leave a stale
+/// value behind. With cache.lease_wait_us set, other readers missing the same
+/// key wait for the lease holder instead of all going to the driver.
+///
+/// With cache.read_tiers set, the "db" share of the config's read_tiers line
+/// bypasses the cache lookup (and refills it), so the hit rate is capped to
+/// match the config; otherwise it follows from the access skew.
+///
+/// Hits and misses are reported separately as CACHE_HIT and CACHE_MISS.
+///
+class CacheDB : public DB {
+ public:
+  /// Takes ownership of @param db, which must already be initialized.
+  /// Hits and misses are reported to @param measurements, if not null.
+  CacheDB(DB *db, utils::Properties *props, Measurements *measurements);
+  ~CacheDB();
+
+  /// Whether @param props enables the cache tier (cache.enabled).
+  static bool Enabled(utils::Properties const &props);
+
+  void Init() {
+    db_->Init();
+  }
+
+  void Cleanup() {
+    db_->Cleanup();
+  }
+
+  Status Read(DataTable table, const std::vector<Field> &key,
+              std::vector<TimestampValue> &buffer);
+
+  Status Scan(DataTable table, const std::vector<Field> &key, int n,
+              std::vector<TimestampValue> &buffer) {
+    return db_->Scan(table, key, n, buffer);
+  }
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+    return db_->RangeRead(id1, limit, buffer);
+  }
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count) {
+    return db_->CountRead(id1, type, count);
+  }
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer) {
+    return db_->TimeRangeRead(id1, type, min_timestamp, max_timestamp, limit, buffer);
+  }
+
+  Status Update(DataTable table, const std::vector<Field> &key, const TimestampValue &value);
+
+  Status Insert(DataTable table, const std::vector<Field> &key, const TimestampValue &value);
+
+  Status Delete(DataTable table, const std::vector<Field> &key, const TimestampValue &value);
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer,
+                            bool read_only);
+
+  void ExecuteAsync(const DB_Operation &operation,
+                    std::vector<TimestampValue> &read_buffer,
+                    std::function<void(Status)> callback);
+
+  void ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                               std::vector<TimestampValue> &read_buffer,
+                               bool read_only,
+                               std::function<void(Status)> callback);
+
+  Status BatchInsert(DataTable table,
+                     const std::vector<std::vector<Field>> &keys,
+                     const std::vector<TimestampValue> &values) {
+    return db_->BatchInsert(table, keys, values);
+  }
+
+  Status BatchRead(DataTable table,
+                   const std::vector<Field> &floor,
+                   const std::vector<Field> &ceil,
+                   int n,
+                   std::vector<std::vector<Field>> &key_buffer) {
+    return db_->BatchRead(table, floor, ceil, n, key_buffer);
+  }
+
+  Status ParallelBatchRead(DataTable table, int num_threads,
+                           std::function<void(int, std::vector<Field> &&)> const &sink) {
+    return db_->ParallelBatchRead(table, num_threads, sink);
+  }
+
+ private:
+  Status CachedRead(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer);
+
+  // Whether this read skips the cache lookup, per the read_tiers line.
+  bool BypassCache();
+
+  // Reports the time since @param start to @param metric, if there is one.
+  static void ReportMetric(Metric *metric, int64_t start);
+
+  DB *db_;
+  std::shared_ptr<ObjectCache> cache_;
+  int64_t lease_wait_us_;
+  std::mt19937_64 rng_;
+  // empty unless cache.read_tiers is set
+  std::discrete_distribution<> read_tiers_;
+  int db_tier_ = -1;
+  // looked up once, so that a hit takes no lock in Measurements
+  Metric *hit_metric_ = nullptr;
+  Metric *miss_metric_ = nullptr;
+};
+
+} // benchmark
+
+#endif // CACHE_DB_H_
@@ -0,0 +1,551 @@
+#include "characterize.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "edge.h"
+#include "timer.h"
+#include "trace.h"
+#include "trace_row_parser.h"
+
+namespace benchmark {
+
+namespace {
+const std::string TRACE_PATH = "characterize_path";
+const std::string OUTPUT = "characterize.output";
+const std::string THREADS = "characterize.threads";
+// "prefix" takes an id's shard from its top bits, as in taobench keys;
+// "hash" spreads ids that carry no shard evenly over the shards
+const std::string SHARDS = "characterize.shards";
+// bytes of trace in each chunk handed to a thread
+const size_t CHUNK_BYTES = 4 << 20;
+// invalid lines reported individually; the rest are only counted
+const int MAX_REPORTED_ERRORS = 10;
+
+const std::vector<std::string> READ_TYPES = {"obj_read", "edge_point_read", "edge_range_read",
+                                             "edge_count_read", "edge_time_read"};
+const std::vector<std::string> WRITE_TYPES = {"obj_add", "obj_update", "obj_delete",
+                                              "edge_add", "edge_update", "edge_delete"};
+const int NUM_EDGE_TYPES = static_cast<int>(EdgeType::Other) + 1;
+
+// Kinds of request, in the order of the config's operations line.
+enum RequestKind { kRead, kWrite, kReadTxn, kWriteTxn, kNumKinds };
+
+struct ConfigLine {
+  std::string name;
+  std::string line;
+  bool has_data;
+};
+
+// Counts of what the requests of a trace did, for the config lines.
+class Profile {
+ public:
+  explicit Profile(bool hash_shards) : hash_shards_(hash_shards) {}
+
+  void Add(RequestKind kind, std::vector<DB::DB_Operation> const &ops) {
+    ++requests_[kind];
+    if (kind == kReadTxn || kind == kWriteTxn) {
+      auto &sizes = txn_sizes_[kind == kWriteTxn];
+      if (sizes.size() <= ops.size()) {
+        sizes.resize(ops.size() + 1);
+      }
+      ++sizes[ops.size()];
+    }
+    auto const &types = kind == kRead || kind == kReadTxn ? READ_TYPES : WRITE_TYPES;
+    for (auto const &op : ops) {
+      // reads in a write transaction have no write operation type
+      auto type = std::find(types.begin(), types.end(), TraceRowParser::OperationTypeName(op));
+      if (type != types.end()) {
+        ++op_types_[kind][type - types.begin()];
+      }
+      ++primary_shards_[Shard(op.key[0].value)];
+      if (op.table != DataTable::Edges) {
+        continue;
+      }
+      for (auto const &field : op.key) {
+        if (field.name == "id2") {
+          ++remote_shards_[Shard(field.value)];
+        } else if (field.name == "type") {
+          int64_t edge_type = field.value >= 0 && field.value < NUM_EDGE_TYPES
+              ? field.value : static_cast<int64_t>(EdgeType::Other);
+          ++edge_types_[op.operation == Operation::INSERT][edge_type];
+        }
+      }
+    }
+  }
+
+  void Merge(Profile const &other) {
+    for (int i = 0; i < kNumKinds; ++i) {
+      requests_[i] += other.requests_[i];
+      for (size_t t = 0; t < op_types_[i].size(); ++t) {
+        op_types_[i][t] += other.op_types_[i][t];
+      }
+    }
+    for (int i = 0; i < 2; ++i) {
+      auto &sizes = txn_sizes_[i];
+      sizes.resize(std::max(sizes.size(), other.txn_sizes_[i].size()));
+      for (size_t s = 0; s < other.txn_sizes_[i].size(); ++s) {
+        sizes[s] += other.txn_sizes_[i][s];
+      }
+      for (int t = 0; t < NUM_EDGE_TYPES; ++t) {
+        edge_types_[i][t] += other.edge_types_[i][t];
+      }
+    }
+    for (int s = 0; s < constants::NUM_SHARDS; ++s) {
+      primary_shards_[s] += other.primary_shards_[s];
+      remote_shards_[s] += other.remote_shards_[s];
+    }
+  }
+
+  std::array<int64_t, kNumKinds> const &Requests() const {
+    return requests_;
+  }
+
+  // The config lines; lines the trace has no data for get equal weights.
+  std::vector<ConfigLine> ConfigLines() const {
+    std::vector<ConfigLine> lines;
+    auto add = [&lines](std::string const &name, std::vector<std::string> values,
+                        std::vector<int64_t> weights) {
+      bool has_data = std::any_of(weights.begin(), weights.end(), [](int64_t w) { return w > 0; });
+      if (!has_data) {
+        if (values.empty() && weights.empty()) { // transaction sizes
+          values.push_back("1");
+          weights.push_back(0);
+        }
+        std::fill(weights.begin(), weights.end(), 1);
+      }
+      std::ostringstream line;
+      line << "{\"name\": \"" << name << "\", ";
+      if (!values.empty()) {
+        line << "\"values\": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+          line << (i ? ", " : "") << values[i];
+        }
+        line << "], ";
+      }
+      line << "\"weights\": [";
+      for (size_t i = 0; i < weights.size(); ++i) {
+        line << (i ? ", " : "") << weights[i];
+      }
+      line << "]}";
+      lines.push_back({name, line.str(), has_data});
+    };
+    auto quoted = [](std::vector<std::string> const &names) {
+      std::vector<std::string> values;
+      for (auto const &name : names) {
+        values.push_back('"' + name + '"');
+      }
+      return values;
+    };
+    auto sizes = [](std::vector<int64_t> const &counts, std::vector<std::string> &values) {
+      std::vector<int64_t> weights;
+      for (size_t size = 1; size < counts.size(); ++size) {
+        values.push_back(std::to_string(size));
+        weights.push_back(counts[size]);
+      }
+      return weights;
+    };
+    auto slice = [](auto const &counts, size_t n) {
+      return std::vector<int64_t>(counts.begin(), counts.begin() + n);
+    };
+
+    add("operations", {}, slice(requests_, kNumKinds));
+    std::vector<std::string> read_sizes, write_sizes;
+    std::vector<int64_t> read_size_weights = sizes(txn_sizes_[0], read_sizes);
+    std::vector<int64_t> write_size_weights = sizes(txn_sizes_[1], write_sizes);
+    add("read_txn_sizes", read_sizes, read_size_weights);
+    add("write_txn_sizes", write_sizes, write_size_weights);
+    add("read_operation_types", quoted(READ_TYPES), slice(op_types_[kRead], READ_TYPES.size()));
+    add("write_operation_types", quoted(WRITE_TYPES), slice(op_types_[kWrite], WRITE_TYPES.size()));
+    add("read_txn_operation_types", quoted(READ_TYPES),
+        slice(op_types_[kReadTxn], READ_TYPES.size()));
+    add("write_txn_operation_types", quoted(WRITE_TYPES),
+        slice(op_types_[kWriteTxn], WRITE_TYPES.size()));
+    std::vector<std::string> edge_type_names;
+    for (int t = 0; t < NUM_EDGE_TYPES; ++t) {
+      edge_type_names.push_back(EdgeTypeToString(static_cast<EdgeType>(t)));
+    }
+    // new edges' types if the trace adds edges, else those of every edge it touches
+    auto const &edge_types = edge_types_[1][0] + edge_types_[1][1] + edge_types_[1][2]
+        + edge_types_[1][3] > 0 ? edge_types_[1] : edge_types_[0];
+    add("edge_types", quoted(edge_type_names), slice(edge_types, NUM_EDGE_TYPES));
+    add("primary_shards", {}, slice(primary_shards_, constants::NUM_SHARDS));
+    add("remote_shards", {}, slice(remote_shards_, constants::NUM_SHARDS));
+    return lines;
+  }
+
+ private:
+  int Shard(int64_t id) const {
+    if (hash_shards_) {
+      return (static_cast<uint64_t>(id) * 0x9e3779b97f4a7c15ULL >> 32) % constants::NUM_SHARDS;
+    }
+    int shard = GetShardFromKey(id) % constants::NUM_SHARDS;
+    return shard < 0 ? shard + constants::NUM_SHARDS : shard;
+  }
+
+  bool const hash_shards_;
+  std::array<int64_t, kNumKinds> requests_{};
+  // transactions by size, for read and write transactions
+  std::array<std::vector<int64_t>, 2> txn_sizes_;
+  // operations by request kind and index in READ_TYPES or WRITE_TYPES
+  std::array<std::array<int64_t, 6>, kNumKinds> op_types_{};
+  // edge operations by type, of other operations and of inserts
+  std::array<std::array<int64_t, NUM_EDGE_TYPES>, 2> edge_types_{};
+  std::array<int64_t, constants::NUM_SHARDS> primary_shards_{};
+  std::array<int64_t, constants::NUM_SHARDS> remote_shards_{};
+};
+
+// A piece of trace for a worker: whole lines of a CSV or JSON Lines trace,
+// or whole blocks of a recorded one.
+struct Chunk {
+  size_t index = 0;
+  std::string text;
+  std::vector<std::string> blocks;
+};
+
+// Operations of a transaction of a CSV or JSON Lines trace.
+struct Fragment {
+  std::string txn;
+  std::vector<DB::DB_Operation> ops;
+  bool read_only = true;
+};
+
+// The transactions a chunk starts and ends with, which may go on in the
+// chunks next to it.
+struct ChunkEnds {
+  Fragment head;
+  Fragment tail;
+  // no request ended in the chunk, so head goes on in the next chunk
+  bool head_is_tail = false;
+};
+
+class Characterizer {
+ public:
+  Characterizer(utils::Properties const &props, std::string const &path)
+      : path_(path)
+      , binary_(TraceReader::IsTrace(path))
+      , jsonl_(TraceRowParser::IsJsonl(props, path))
+      , hash_shards_(props.GetProperty(SHARDS, "prefix") == "hash")
+      , num_threads_(std::stoi(props.GetProperty(
+          THREADS, std::to_string(std::max(1u, std::thread::hardware_concurrency())))))
+      , stitched_(hash_shards_) {
+  }
+
+  Profile Run() {
+    std::vector<Profile> profiles(num_threads_, Profile(hash_shards_));
+    std::vector<std::thread> workers;
+    if (binary_) {
+      for (int i = 0; i < num_threads_; ++i) {
+        workers.emplace_back(&Characterizer::DecodeBlocks, this, std::ref(profiles[i]));
+      }
+      ReadBlocks();
+    } else {
+      std::ifstream in;
+      std::vector<char> buffer(CHUNK_BYTES);
+      in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+      in.open(path_);
+      if (!in) {
+        throw std::invalid_argument("Cannot open trace " + path_);
+      }
+      std::string header;
+      if (!jsonl_) {
+        std::getline(in, header);
+      }
+      TraceRowParser(jsonl_, header, constants::RANGE_READ_LIMIT); // checks the header
+      for (int i = 0; i < num_threads_; ++i) {
+        workers.emplace_back(&Characterizer::ParseLines, this, header, std::ref(profiles[i]));
+      }
+      ReadLines(in);
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    Finalize(stitched_, open_);
+    for (auto const &profile : profiles) {
+      stitched_.Merge(profile);
+    }
+    if (invalid_lines_ > 0) {
+      std::cerr << "Skipped " << invalid_lines_ << " invalid lines of " << path_ << std::endl;
+    }
+    return stitched_;
+  }
+
+ private:
+  void Push(Chunk &&chunk) {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    not_full_.wait(lock, [this] { return chunks_.size() < 2 * static_cast<size_t>(num_threads_); });
+    chunks_.push_back(std::move(chunk));
+    not_empty_.notify_one();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  bool Pop(Chunk &chunk) {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    not_empty_.wait(lock, [this] { return !chunks_.empty() || closed_; });
+    if (chunks_.empty()) {
+      return false;
+    }
+    chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void ReadBlocks() {
+    TraceReader reader(path_);
+    Chunk chunk;
+    size_t bytes = 0;
+    uint32_t stream;
+    std::string block;
+    while (reader.NextBlock(stream, block)) {
+      bytes += block.size();
+      chunk.blocks.push_back(std::move(block));
+      if (bytes >= CHUNK_BYTES) {
+        Push(std::move(chunk));
+        chunk = Chunk();
+        bytes = 0;
+      }
+    }
+    if (!chunk.blocks.empty()) {
+      Push(std::move(chunk));
+    }
+    Close();
+  }
+
+  void DecodeBlocks(Profile &profile) {
+    Chunk chunk;
+    TraceRequest request;
+    while (Pop(chunk)) {
+      for (auto const &block : chunk.blocks) {
+        for (size_t offset = 0; offset < block.size(); ) {
+          TraceReader::DecodeRequest(block, offset, request);
+          RequestKind kind;
+          switch (request.kind) {
+            case TraceRequest::Kind::kOperation:
+              kind = IsReadOperation(request.operations[0].operation) ? kRead : kWrite;
+              break;
+            case TraceRequest::Kind::kReadTransaction:
+              kind = kReadTxn;
+              break;
+            default:
+              kind = kWriteTxn;
+              break;
+          }
+          profile.Add(kind, request.operations);
+        }
+      }
+    }
+  }
+
+  // Cuts the trace into chunks of whole lines.
+  void ReadLines(std::ifstream &in) {
+    for (size_t index = 0; ; ++index) {
+      Chunk chunk;
+      chunk.index = index;
+      chunk.text.resize(CHUNK_BYTES);
+      in.read(&chunk.text[0], CHUNK_BYTES);
+      chunk.text.resize(in.gcount());
+      if (chunk.text.empty()) {
+        break;
+      }
+      std::string rest;
+      if (chunk.text.back() != '\n' && std::getline(in, rest)) {
+        chunk.text += rest;
+      }
+      Push(std::move(chunk));
+    }
+    Close();
+  }
+
+  void ParseLines(std::string const &header, Profile &profile) {
+    TraceRowParser parser(jsonl_, header, constants::RANGE_READ_LIMIT);
+    Chunk chunk;
+    std::string line, txn;
+    while (Pop(chunk)) {
+      ChunkEnds ends;
+      bool ended = false; // whether a request has ended in the chunk
+      Fragment current;
+      std::string const &text = chunk.text;
+      for (size_t pos = 0; pos < text.size(); ) {
+        size_t end = std::min(text.find('\n', pos), text.size());
+        line.assign(text, pos, end - pos);
+        pos = end + 1;
+        std::optional<DB::DB_Operation> op;
+        try {
+          op = parser.Parse(line, txn);
+        } catch (std::exception const &e) {
+          if (invalid_lines_++ < MAX_REPORTED_ERRORS) {
+            std::cerr << "Skipping invalid line of " << path_ << ": " << e.what() << std::endl;
+          }
+        }
+        if (!op) {
+          continue;
+        }
+        if (!current.ops.empty() && (txn.empty() || txn != current.txn)) {
+          if (!ended) {
+            ends.head = std::move(current);
+          } else {
+            Finalize(profile, current);
+          }
+          ended = true;
+          current = Fragment();
+        }
+        if (txn.empty()) {
+          profile.Add(IsReadOperation(op->operation) ? kRead : kWrite, {*op});
+          ended = true;
+          continue;
+        }
+        current.txn = txn;
+        current.read_only = current.read_only && IsReadOperation(op->operation);
+        current.ops.push_back(std::move(*op));
+      }
+      if (ended) {
+        ends.tail = std::move(current);
+      } else {
+        ends.head = std::move(current);
+        ends.head_is_tail = true;
+      }
+      Stitch(chunk.index, std::move(ends));
+    }
+  }
+
+  // Joins the transactions that span chunks, taking the chunks in order.
+  void Stitch(size_t index, ChunkEnds &&ends) {
+    std::lock_guard<std::mutex> lock(stitch_mutex_);
+    waiting_.emplace(index, std::move(ends));
+    for (auto it = waiting_.find(next_chunk_); it != waiting_.end(); it = waiting_.find(next_chunk_)) {
+      ChunkEnds &e = it->second;
+      if (!e.head.ops.empty()) {
+        if (e.head.txn != open_.txn) {
+          Finalize(stitched_, open_);
+          open_ = Fragment();
+        }
+        open_.txn = e.head.txn;
+        open_.read_only = open_.read_only && e.head.read_only;
+        std::move(e.head.ops.begin(), e.head.ops.end(), std::back_inserter(open_.ops));
+      }
+      if (!e.head_is_tail) {
+        Finalize(stitched_, open_);
+        open_ = std::move(e.tail);
+      }
+      waiting_.erase(it);
+      ++next_chunk_;
+    }
+  }
+
+  static void Finalize(Profile &profile, Fragment &fragment) {
+    if (!fragment.ops.empty()) {
+      profile.Add(fragment.read_only ? kReadTxn : kWriteTxn, fragment.ops);
+      fragment.ops.clear();
+    }
+  }
+
+  std::string const path_;
+  bool const binary_;
+  bool const jsonl_;
+  bool const hash_shards_;
+  int const num_threads_;
+  std::atomic<int64_t> invalid_lines_{0};
+
+  std::mutex queue_mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Chunk> chunks_;
+  bool closed_ = false;
+
+  std::mutex stitch_mutex_;
+  // ends of chunks waiting for an earlier chunk
+  std::map<size_t, ChunkEnds> waiting_;
+  size_t next_chunk_ = 0;
+  // the transaction the chunks stitched so far end with
+  Fragment open_;
+  Profile stitched_;
+};
+
+// The lines of the config at @param path by name, in file order.
+std::vector<std::pair<std::string, std::string>> ReadConfigLines(std::string const &path) {
+  std::vector<std::pair<std::string, std::string>> lines;
+  std::ifstream in(path);
+  std::regex name("\"name\":\\s*\"([^\"]*)\"");
+  std::smatch match;
+  for (std::string line; std::getline(in, line); ) {
+    if (std::regex_search(line, match, name)) {
+      lines.emplace_back(match.str(1), line);
+    }
+  }
+  return lines;
+}
+} // namespace
+
+void RunCharacterize(utils::Properties &props) {
+  std::string path = props.GetProperty(TRACE_PATH);
+  std::string output = props.GetProperty(OUTPUT, path + ".json");
+
+  int64_t start_nanos = utils::CurrentTimeNanos();
+  Characterizer characterizer(props, path);
+  Profile profile = characterizer.Run();
+  double runtime = (utils::CurrentTimeNanos() - start_nanos) / 1e9;
+
+  auto const &requests = profile.Requests();
+  std::cout << "Characterized " << requests[kRead] + requests[kWrite] + requests[kReadTxn]
+            + requests[kWriteTxn] << " requests of " << path << " in " << runtime << " sec: "
+            << requests[kRead] << " reads, " << requests[kWrite] << " writes, "
+            << requests[kReadTxn] << " read transactions, " << requests[kWriteTxn]
+            << " write transactions" << std::endl;
+
+  std::vector<std::pair<std::string, std::string>> base;
+  if (props.ContainsKey("config_path")) {
+    base = ReadConfigLines(props["config_path"]);
+  }
+  auto base_line = [&base](std::string const &name) -> std::string const * {
+    auto it = std::find_if(base.begin(), base.end(), [&name](auto const &l) { return l.first == name; });
+    return it == base.end() ? nullptr : &it->second;
+  };
+
+  std::ofstream out(output);
+  if (!out) {
+    throw std::invalid_argument("Cannot write " + output);
+  }
+  std::vector<std::string> derived, defaulted;
+  for (auto const &line : profile.ConfigLines()) {
+    std::string const *fallback = line.has_data ? nullptr : base_line(line.name);
+    out << (fallback ? *fallback : line.line) << '\n';
+    (line.has_data ? derived : defaulted).push_back(line.name);
+  }
+  for (auto const &[name, line] : base) {
+    if (std::find(derived.begin(), derived.end(), name) == derived.end()
+        && std::find(defaulted.begin(), defaulted.end(), name) == defaulted.end()) {
+      out << line << '\n';
+    }
+  }
+  std::cout << "Wrote " << output << " with " << derived.size() << " lines from the trace";
+  if (!base.empty()) {
+    std::cout << ", the rest from " << props["config_path"];
+  }
+  std::cout << std::endl;
+  for (auto const &name : defaulted) {
+    std::cout << "The trace has no data for " << name
+              << (base_line(name) ? ", copied it from the base config" : ", gave it equal weights")
+              << std::endl;
+  }
+}
+
+} // benchmark
@@ -0,0 +1,25 @@
+#ifndef CHARACTERIZE_H_
+#define CHARACTERIZE_H_
+
+#include "properties.h"
+
+namespace benchmark {
+
+///
+/// Derives a workload config from a request trace: a trace recorded with
+/// -record, or a CSV or JSON Lines trace as read by TraceFileWorkload. Writes
+/// the operations, transaction sizes, operation types, edge types and shard
+/// lines that TraceGeneratorWorkload draws requests from, in the format
+/// ConfigParser reads, to characterize.output (default: the trace's path
+/// with .json appended). Other lines, and lines the trace has no data for,
+/// are copied from the config given with -c, if any.
+///
+/// The trace is read sequentially in large chunks and parsed on
+/// characterize.threads threads (default: all cores). At most two chunks per
+/// thread are in memory at once, so memory does not grow with the trace.
+///
+void RunCharacterize(utils::Properties &props);
+
+} // benchmark
+
+#endif // CHARACTERIZE_H_
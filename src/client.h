@@ -4,6 +4,9 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "db.h"
 #include "workload.h"
 #include "utils.h"
@@ -40,6 +43,9 @@ inline ClientThreadInfo ClientThread(benchmark::DB *db, benchmark::Workload *wl,
   while (true) {
     timer.Start();
     bool succeeded = wl->DoRequest(*db);
+    if (!succeeded && wl->Exhausted()) {
+      break;
+    }
     oks += succeeded;
     failed_ops += !succeeded;
     int64_t time_left = nanos_per_op - timer.End();
@@ -65,6 +71,62 @@ inline ClientThreadInfo ClientThread(benchmark::DB *db, benchmark::Workload *wl,
   return {oks, overtime_ops, failed_ops};
 }
 
+// Keeps up to max_in_flight requests outstanding against db from a single thread,
+// issuing a new one as soon as a completion frees a slot. Only useful with drivers
+// that override DB::ExecuteAsync; otherwise every request completes inline.
+inline ClientThreadInfo AsyncClientThread(benchmark::DB *db, benchmark::Workload *wl,
+                                          const double exp_len, const int cpu,
+                                          const int max_in_flight, bool cleanup_db,
+                                          CountDownLatch *latch) {
+
+  using namespace std::chrono;
+  if (utils::PinThisThreadToCpu(cpu) != 0) {
+    throw std::runtime_error("Error pinning thread to cpu");
+  }
+  time_point<system_clock> start = system_clock::now();
+
+  std::atomic<int> oks{0};
+  std::atomic<int> failed_ops{0};
+  std::atomic<bool> exhausted{false};
+  int in_flight = 0;
+  std::mutex mutex;
+  std::condition_variable slot_free;
+  auto done = [&](bool succeeded) {
+    if (succeeded) {
+      oks++;
+    } else if (wl->Exhausted()) {
+      exhausted = true;
+    } else {
+      failed_ops++;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    in_flight--;
+    slot_free.notify_one();
+  };
+
+  while (duration<double>(system_clock::now() - start).count() <= exp_len && !exhausted) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      slot_free.wait(lock, [&] { return in_flight < max_in_flight; });
+      in_flight++;
+    }
+    wl->DoRequestAsync(*db, done);
+  }
+
+  // drain before the counters and callback go out of scope
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    slot_free.wait(lock, [&] { return in_flight == 0; });
+  }
+
+  if (cleanup_db) {
+    db->Cleanup();
+  }
+
+  latch->CountDown();
+  return {oks, 0, failed_ops};
+}
+
 } // benchmark
 
 #endif // CLIENT_H_
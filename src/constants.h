@@ -28,6 +28,15 @@ namespace benchmark {
     // Defines the number of bytes stored in the value of each object/association.
     constexpr int VALUE_SIZE_BYTES = 150;
 
+    // Default number of edges returned by an edge_range_read or edge_time_read,
+    // overridden by the range_read_limit property.
+    constexpr int RANGE_READ_LIMIT = 10;
+
+    // Chance that an edge of a graph-shaped load (a config with an edge_degrees
+    // line) points at an existing object rather than a new one; overridden by
+    // the preferential_attachment property.
+    constexpr double PREFERENTIAL_ATTACHMENT = 0.5;
+
     // Initial backoff limit for a failed operation or transaction; grows exponentially.
     constexpr int INITIAL_BACKOFF_LIMIT_MICROS = 2000;
   }
@@ -2,10 +2,12 @@
 #define DB_H_
 
 #include "properties.h"
+#include "edge.h"
 
 #include <vector>
 #include <string>
 #include <iostream>
+#include <functional>
 
 namespace benchmark {
 
@@ -18,6 +20,9 @@ enum class Operation {
   DELETE,
   READTRANSACTION,
   WRITETRANSACTION,
+  RANGEREAD,
+  COUNTREAD,
+  TIMERANGEREAD,
   MAXOPTYPE,
 };
 
@@ -49,6 +54,8 @@ inline std::string DataTableToStr(DataTable table) {
 /// Database interface layer.
 /// per-thread DB instance.
 ///
+class Measurements;
+
 class DB {
  public:
 
@@ -86,9 +93,18 @@ class DB {
     }
 
     DataTable table;
-    std::vector<Field> key; // 1 int for objects, 3 (id1, id2, type) for edge
+    // 1 int for objects, 3 (id1, id2, type) for edge; only id1 for RANGEREAD,
+    // and (id1, type) for COUNTREAD and TIMERANGEREAD
+    std::vector<Field> key;
     TimestampValue time_and_value;
     Operation operation;
+    int limit = 0; // RANGEREAD and TIMERANGEREAD
+    int64_t min_timestamp = 0; // TIMERANGEREAD, inclusive
+    int64_t max_timestamp = 0; // TIMERANGEREAD, inclusive
+    // Set by the driver on an INSERT that succeeds: false if no row was written,
+    // as for an edge insert that GetIncompatibleKeys blocks. Drivers that cannot
+    // tell leave it true.
+    mutable bool written = true;
   };
   
 
@@ -157,7 +173,33 @@ class DB {
                         TimestampValue const & value) = 0;
 
 
-  /// Execute a single operation (READ, INSERT, UPDATE, DELETE) TODO: maybe add SCAN here?
+  /// Reads the edges leaving @param id1, ordered by (id2, type), up to @param limit
+  /// of them. The timestamp/value pairs are appended to @param buffer.
+  /// Like TAO's assoc_range, but over every type.
+  virtual Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+    return Status::kNotImplemented;
+  }
+
+
+  /// Counts the edges leaving @param id1 with @param type into @param count.
+  /// Like TAO's assoc_count.
+  virtual Status CountRead(int64_t id1, int64_t type, int64_t &count) {
+    return Status::kNotImplemented;
+  }
+
+
+  /// Reads the edges leaving @param id1 with @param type whose timestamp is in
+  /// [@param min_timestamp, @param max_timestamp], newest first, up to @param limit
+  /// of them. Like TAO's assoc_time_range.
+  virtual Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                               int64_t max_timestamp, int limit,
+                               std::vector<TimestampValue> &buffer) {
+    return Status::kNotImplemented;
+  }
+
+
+  /// Execute a single operation (READ, INSERT, UPDATE, DELETE, and the edge
+  /// queries RANGEREAD, COUNTREAD and TIMERANGEREAD) TODO: maybe add SCAN here?
   /// @param operation DB_operation struct containing table, key, value, and operation type
   /// @param read_buffer - append read result here if applicable
   virtual Status Execute(const DB_Operation &operation,
@@ -171,6 +213,37 @@ class DB {
                                     bool read_only) = 0;
 
 
+  /// Reads every (id1, id2, type) key of @param table with up to @param num_threads
+  /// threads of the driver's own, passing each key to @param sink together with the
+  /// index of the thread that read it, so callers can fill one buffer per thread
+  /// without locking. Drivers without a native parallel scan return kNotImplemented
+  /// and callers fall back to paginated BatchRead.
+  virtual Status ParallelBatchRead(DataTable table, int num_threads,
+                                   std::function<void(int, std::vector<Field> &&)> const &sink) {
+    return Status::kNotImplemented;
+  }
+
+
+  /// Asynchronous variants of Execute and ExecuteTransaction.
+  /// @param callback is invoked exactly once with the result, possibly on another thread.
+  /// @param operation(s) and @param read_buffer must stay alive until @param callback
+  /// has run, as the driver may set their written flags.
+  /// The default implementations complete synchronously on the calling thread; drivers
+  /// with a non-blocking client override them to keep many requests in flight.
+  virtual void ExecuteAsync(const DB_Operation &operation,
+                            std::vector<TimestampValue> &read_buffer,
+                            std::function<void(Status)> callback) {
+    callback(Execute(operation, read_buffer));
+  }
+
+  virtual void ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                                       std::vector<TimestampValue> &read_buffer,
+                                       bool read_only,
+                                       std::function<void(Status)> callback) {
+    callback(ExecuteTransaction(operations, read_buffer, read_only));
+  }
+
+
   /// Insert records in @param table for @param keys with @param values
   /// Each element of @param keys is a key vector, formatted as in the other operations
   /// @param values is a vector of TimestampValue pairs
@@ -202,8 +275,14 @@ class DB {
   void SetProps(utils::Properties *props) {
     props_ = props;
   }
+
+  void SetMeasurements(Measurements *measurements) {
+    measurements_ = measurements;
+  }
  protected:
   utils::Properties *props_;
+  // Lets drivers report their own metrics; may be null outside CreateDB.
+  Measurements *measurements_ = nullptr;
 };
 
 /**
@@ -212,6 +291,30 @@ class DB {
  **/
 std::vector<std::vector<DB::Field>> GetIncompatibleKeys(std::vector<DB::Field> const & key);
 
+/**
+ * Returns a SQL predicate over the edges table matching every key returned by
+ * GetIncompatibleKeys for an edge of @param type. @param id1 and @param id2 are
+ * pasted in as SQL text, so they may be placeholders (e.g. "$1") or literals.
+ **/
+std::string IncompatibleKeysPredicate(EdgeType type, std::string const & id1, std::string const & id2);
+
+/**
+ * True for the edge queries, RANGEREAD, COUNTREAD and TIMERANGEREAD, which read
+ * several edges of one id1 rather than a single row.
+ **/
+inline bool IsEdgeQuery(Operation op) {
+  return op == Operation::RANGEREAD || op == Operation::COUNTREAD
+      || op == Operation::TIMERANGEREAD;
+}
+
+/**
+ * Runs the edge query @param operation through the RangeRead, CountRead or
+ * TimeRangeRead method of @param db. A count is appended to @param buffer as a
+ * single entry whose timestamp holds it.
+ **/
+Status ExecuteEdgeQuery(DB &db, DB::DB_Operation const & operation,
+                        std::vector<DB::TimestampValue> &buffer);
+
 // Prints out results vector to stdout
 void PrintResults(std::vector<std::vector<DB::Field>> const & results);
 
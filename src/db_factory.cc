@@ -1,5 +1,7 @@
 #include "db_factory.h"
+#include "cache_db.h"
 #include "db_wrapper.h"
+#include "latency_db.h"
 
 namespace benchmark {
 
@@ -21,7 +23,15 @@ DB *DBFactory::CreateDB(utils::Properties *props, Measurements *measurements) {
   if (registry.find(db_name) != registry.end()) {
     DB *new_db = (*registry[db_name])();
     new_db->SetProps(props);
+    new_db->SetMeasurements(measurements);
     new_db->Init();
+    if (LatencyDB::Enabled(*props)) {
+      new_db = new LatencyDB(new_db, props);
+      new_db->SetMeasurements(measurements);
+    }
+    if (CacheDB::Enabled(*props)) {
+      new_db = new CacheDB(new_db, props, measurements);
+    }
     db = new DBWrapper(new_db, measurements);
   }
   return db;
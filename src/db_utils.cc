@@ -71,6 +71,55 @@ namespace benchmark {
     }
   }
 
+  std::string IncompatibleKeysPredicate(EdgeType type, std::string const & id1, std::string const & id2) {
+    // GetIncompatibleKeys only ever swaps id1/id2 and pins types, so two distinct
+    // sentinel ids are enough to tell which column each id lands in.
+    constexpr int64_t kId1 = 1;
+    constexpr int64_t kId2 = 2;
+    std::vector<std::vector<DB::Field>> keys = GetIncompatibleKeys(
+        {{"id1", kId1}, {"id2", kId2}, {"type", static_cast<int64_t>(type)}});
+    std::string predicate;
+    for (auto const & key : keys) {
+      if (!predicate.empty()) {
+        predicate += " OR ";
+      }
+      predicate += "(";
+      for (size_t i = 0; i < key.size(); ++i) {
+        if (i > 0) {
+          predicate += " AND ";
+        }
+        std::string value = key[i].name == "type" ? std::to_string(key[i].value)
+                                                  : (key[i].value == kId1 ? id1 : id2);
+        predicate += key[i].name + "=" + value;
+      }
+      predicate += ")";
+    }
+    return predicate;
+  }
+
+  Status ExecuteEdgeQuery(DB &db, DB::DB_Operation const & operation,
+                          std::vector<DB::TimestampValue> &buffer) {
+    assert(operation.table == DataTable::Edges);
+    int64_t id1 = operation.key[0].value;
+    switch (operation.operation) {
+      case Operation::RANGEREAD:
+        return db.RangeRead(id1, operation.limit, buffer);
+      case Operation::COUNTREAD: {
+        int64_t count = 0;
+        Status s = db.CountRead(id1, operation.key[1].value, count);
+        if (s == Status::kOK) {
+          buffer.emplace_back(count, "");
+        }
+        return s;
+      }
+      case Operation::TIMERANGEREAD:
+        return db.TimeRangeRead(id1, operation.key[1].value, operation.min_timestamp,
+                                operation.max_timestamp, operation.limit, buffer);
+      default:
+        return Status::kNotImplemented;
+    }
+  }
+
   void PrintResults(std::vector<DB::TimestampValue> const & results) {
     for (auto const & timeval : results) { 
       std::cout << "timestamp=" << timeval.timestamp << ", value=" 
@@ -15,7 +15,9 @@ namespace benchmark {
 class DBWrapper : public DB {
  public:
   DBWrapper(DB *db, Measurements *measurements) :
-    db_(db) , measurements_(measurements) {}
+    db_(db) {
+    SetMeasurements(measurements);
+  }
   ~DBWrapper() {
     delete db_;
   }
@@ -78,6 +80,36 @@ class DBWrapper : public DB {
     return s;
   }
 
+  void ExecuteAsync(const DB_Operation &operation,
+                    std::vector<TimestampValue> &read_buffer,
+                    std::function<void(Status)> callback) {
+    int64_t start = utils::CurrentTimeNanos();
+    Operation op = operation.operation;
+    Measurements *measurements = measurements_;
+    db_->ExecuteAsync(operation, read_buffer, [=](Status s) {
+      if (s == Status::kOK) {
+        measurements->Report(op, utils::CurrentTimeNanos() - start);
+      }
+      callback(s);
+    });
+  }
+
+  void ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                               std::vector<TimestampValue> &read_buffer,
+                               bool read_only,
+                               std::function<void(Status)> callback) {
+    assert(!operations.empty());
+    int64_t start = utils::CurrentTimeNanos();
+    Measurements *measurements = measurements_;
+    db_->ExecuteTransactionAsync(operations, read_buffer, read_only, [=](Status s) {
+      if (s == Status::kOK) {
+        measurements->Report(read_only ? Operation::READTRANSACTION : Operation::WRITETRANSACTION,
+                             utils::CurrentTimeNanos() - start);
+      }
+      callback(s);
+    });
+  }
+
   Status BatchInsert(DataTable table, 
                      const std::vector<std::vector<Field>> &keys, 
                      const std::vector<TimestampValue> &values) 
@@ -94,9 +126,14 @@ class DBWrapper : public DB {
     return db_->BatchRead(table, floor, ceil, n, key_buffer);
   }
 
+  Status ParallelBatchRead(DataTable table, int num_threads,
+                           std::function<void(int, std::vector<Field> &&)> const &sink)
+  {
+    return db_->ParallelBatchRead(table, num_threads, sink);
+  }
+
  private:
   DB *db_;
-  Measurements *measurements_;
   utils::Timer<uint64_t, std::nano> timer_;
 };
 
@@ -1,5 +1,6 @@
 
 #pragma once
+#include <cstdint>
 #include <string>
 
 namespace benchmark {
@@ -36,6 +37,11 @@ namespace benchmark {
     }
   }
 
+  // shard is first 7 bits of id
+  inline int GetShardFromKey(int64_t id) {
+    return id >> 57;
+  }
+
   struct Edge {
     Edge(int64_t p_key, int64_t r_key, EdgeType t)
       : primary_key(p_key)
@@ -0,0 +1,56 @@
+#include "key_generator.h"
+#include "timer.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace benchmark {
+
+  namespace {
+    // 2024-01-01T00:00:00Z, in microseconds since the Unix epoch
+    constexpr int64_t kEpochMicros = 1704067200LL * 1000000;
+  }
+
+  KeyGenerator::KeyGenerator(int node_id, bool scramble)
+      : node_bits_(static_cast<uint64_t>(node_id) << kSequenceBits)
+      , scramble_(scramble)
+  {
+    if (node_id < 0 || node_id >= (1 << kNodeBits)) {
+      throw std::invalid_argument("key_node_id must be in [0, " + std::to_string(1 << kNodeBits) + ")");
+    }
+  }
+
+  int64_t KeyGenerator::operator()(int shard) const {
+    uint64_t bits = node_bits_ | NextSequence();
+    if (scramble_) {
+      bits = Scramble(bits);
+    }
+    return (static_cast<int64_t>(shard) << 57) | static_cast<int64_t>(bits);
+  }
+
+  uint64_t KeyGenerator::NextSequence() {
+    static std::atomic<uint64_t> next_block {
+      static_cast<uint64_t>(utils::CurrentTimeNanos() / 1000 - kEpochMicros) * kKeysPerMicrosecond};
+    thread_local uint64_t next = 0;
+    thread_local uint64_t end = 0;
+    if (next == end) {
+      next = next_block.fetch_add(kBlockKeys, std::memory_order_relaxed);
+      end = next + kBlockKeys;
+    }
+    return next++ & ((uint64_t{1} << kSequenceBits) - 1);
+  }
+
+  // The finalizer of splitmix64 on 57 bits: xor-shifts to the right and
+  // multiplications by odd constants modulo 2^57 can each be undone, so
+  // distinct keys stay distinct.
+  uint64_t KeyGenerator::Scramble(uint64_t bits) {
+    constexpr uint64_t kMask = (uint64_t{1} << 57) - 1;
+    bits ^= bits >> 30;
+    bits = (bits * 0xBF58476D1CE4E5B9ULL) & kMask;
+    bits ^= bits >> 27;
+    bits = (bits * 0x94D049BB133111EBULL) & kMask;
+    bits ^= bits >> 31;
+    return bits;
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace benchmark {
+
+  // Makes the keys of new objects: the 7-bit shard that GetShardFromKey reads,
+  // then a node id and a sequence number in the low 57 bits. Keys are unique
+  // across the threads of a process and across processes with different node
+  // ids, e.g. clients on several hosts.
+  //
+  // Each thread takes sequence numbers from a block of its own, claimed from a
+  // process-wide counter, so making a key takes no lock and no clock read. The
+  // counter starts at kKeysPerMicrosecond keys per microsecond since 2024 at
+  // process start, so a later run on the same node id starts above the keys of
+  // earlier ones, unless one of them made keys faster than that on average.
+  //
+  // With scramble, the low 57 bits are mixed by a bijection, so that new keys
+  // spread over their shard's key range like hashes instead of ascending.
+  class KeyGenerator {
+  public:
+    static constexpr int kNodeBits = 6;
+
+    // Throws std::invalid_argument unless 0 <= node_id < 2^kNodeBits.
+    KeyGenerator(int node_id, bool scramble);
+
+    int64_t operator()(int shard) const;
+
+  private:
+    static constexpr int kSequenceBits = 57 - kNodeBits;
+    static constexpr uint64_t kKeysPerMicrosecond = 2;
+    static constexpr uint64_t kBlockKeys = 1 << 12;
+
+    static uint64_t NextSequence();
+
+    static uint64_t Scramble(uint64_t bits);
+
+    uint64_t const node_bits_;
+    bool const scramble_;
+  };
+}
@@ -0,0 +1,119 @@
+#include "key_popularity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace benchmark {
+
+  namespace {
+    // log1p(x) / x, accurate near 0
+    inline double Helper1(double x) {
+      return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+
+    // expm1(x) / x, accurate near 0
+    inline double Helper2(double x) {
+      return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+    }
+
+    // 64-bit FNV-1a over the bytes of val, as YCSB's scrambled zipfian uses
+    inline uint64_t FnvHash64(uint64_t val) {
+      uint64_t hash = 0xCBF29CE484222325ULL;
+      for (int i = 0; i < 8; ++i) {
+        hash ^= val & 0xff;
+        hash *= 1099511628211ULL;
+        val >>= 8;
+      }
+      return hash;
+    }
+  }
+
+  KeyPopularity KeyPopularity::FromConfig(ConfigParser const & config) {
+    KeyPopularity popularity;
+    auto line = config.fields.find("key_popularity");
+    if (line == config.fields.end()) {
+      return popularity;
+    }
+    ConfigParser::LineObject const & obj = line->second;
+    std::string const & model = obj.types.empty() ? "" : obj.types[0];
+    if (model == "uniform") {
+      popularity.model = Model::kUniform;
+    } else if (model == "zipfian" && obj.weights.size() == 1 && obj.weights[0] > 0) {
+      popularity.model = Model::kZipfian;
+      popularity.exponent = obj.weights[0];
+    } else if (model == "hot_set" && obj.weights.size() == 2
+               && obj.weights[0] > 0 && obj.weights[0] < 1
+               && obj.weights[1] >= 0 && obj.weights[1] <= 1) {
+      popularity.model = Model::kHotSet;
+      popularity.hot_fraction = obj.weights[0];
+      popularity.hot_probability = obj.weights[1];
+    } else {
+      throw std::invalid_argument("Invalid key_popularity line: expects uniform, zipfian with "
+                                  "an exponent > 0, or hot_set with a fraction and a probability");
+    }
+    return popularity;
+  }
+
+  KeySampler::KeySampler(KeyPopularity const & popularity, size_t num_keys)
+      : popularity_(popularity)
+      , num_keys_(num_keys)
+      , num_hot_keys_(std::clamp<size_t>(popularity.hot_fraction * num_keys, 1, std::max<size_t>(1, num_keys)))
+  {
+    if (num_keys_ == 0) {
+      throw std::invalid_argument("KeySampler needs at least one key");
+    }
+    if (popularity_.model == KeyPopularity::Model::kZipfian) {
+      h_integral_x1_ = HIntegral(1.5) - 1;
+      h_integral_n_ = HIntegral(num_keys_ + 0.5);
+      s_ = 2 - HIntegralInverse(HIntegral(2.5) - H(2));
+    }
+  }
+
+  size_t KeySampler::operator()(std::mt19937 & gen) const {
+    switch (popularity_.model) {
+      case KeyPopularity::Model::kZipfian:
+        return Scramble(SampleZipfianRank(gen));
+      case KeyPopularity::Model::kHotSet: {
+        // when every key is hot, there is no cold range to pick from
+        bool hot = num_hot_keys_ >= num_keys_
+                   || std::bernoulli_distribution(popularity_.hot_probability)(gen);
+        size_t rank = hot ? std::uniform_int_distribution<size_t>(0, num_hot_keys_ - 1)(gen)
+                          : std::uniform_int_distribution<size_t>(num_hot_keys_, num_keys_ - 1)(gen);
+        return Scramble(rank);
+      }
+      default:
+        return std::uniform_int_distribution<size_t>(0, num_keys_ - 1)(gen);
+    }
+  }
+
+  size_t KeySampler::SampleZipfianRank(std::mt19937 & gen) const {
+    std::uniform_real_distribution<double> unif(0, 1);
+    while (true) {
+      double u = h_integral_n_ + unif(gen) * (h_integral_x1_ - h_integral_n_);
+      double x = HIntegralInverse(u);
+      double k = std::clamp(std::floor(x + 0.5), 1.0, static_cast<double>(num_keys_));
+      if (k - x <= s_ || u >= HIntegral(k + 0.5) - H(k)) {
+        return static_cast<size_t>(k) - 1;
+      }
+    }
+  }
+
+  double KeySampler::H(double x) const {
+    return std::exp(-popularity_.exponent * std::log(x));
+  }
+
+  double KeySampler::HIntegral(double x) const {
+    double log_x = std::log(x);
+    return Helper2((1 - popularity_.exponent) * log_x) * log_x;
+  }
+
+  double KeySampler::HIntegralInverse(double x) const {
+    double t = std::max(-1.0, x * (1 - popularity_.exponent));
+    return std::exp(Helper1(t) * x);
+  }
+
+  size_t KeySampler::Scramble(size_t rank) const {
+    return FnvHash64(rank) % num_keys_;
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "parse_config.h"
+#include <cstdint>
+#include <random>
+
+namespace benchmark {
+
+  // How popular each key of a shard is, from the config's optional
+  // key_popularity line. Its single value names the model and its weights are
+  // the model's parameters:
+  //   {"name": "key_popularity", "values": ["zipfian"], "weights": [0.99]}
+  //     the i-th most popular key is picked in proportion to 1 / i^0.99
+  //   {"name": "key_popularity", "values": ["hot_set"], "weights": [0.01, 0.9]}
+  //     1% of the keys get 90% of the picks
+  // Without the line, every key is equally popular.
+  struct KeyPopularity {
+    enum class Model { kUniform, kZipfian, kHotSet };
+
+    static KeyPopularity FromConfig(ConfigParser const & config);
+
+    Model model = Model::kUniform;
+    double exponent = 0;
+    double hot_fraction = 0;
+    double hot_probability = 0;
+  };
+
+  // Picks an index into a shard's edges in O(1) time and space, whatever the
+  // shard's size. Popularity ranks are scattered over the indices by hashing,
+  // so the popular keys are not the smallest ones.
+  class KeySampler {
+  public:
+    KeySampler(KeyPopularity const & popularity, size_t num_keys);
+
+    size_t operator()(std::mt19937 & gen) const;
+
+  private:
+    // A rank in [0, num_keys), by rejection-inversion (Hörmann and Derflinger,
+    // "Rejection-inversion to generate variates from monotone discrete
+    // distributions"), which needs no table and no normalizing sum.
+    size_t SampleZipfianRank(std::mt19937 & gen) const;
+
+    double H(double x) const;
+    double HIntegral(double x) const;
+    double HIntegralInverse(double x) const;
+
+    size_t Scramble(size_t rank) const;
+
+    KeyPopularity popularity_;
+    size_t num_keys_;
+    size_t num_hot_keys_;
+    double h_integral_x1_;
+    double h_integral_n_;
+    double s_;
+  };
+}
@@ -0,0 +1,273 @@
+#include "latency_db.h"
+#include "parse_config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  const std::string INJECT = "latency.inject";
+  const std::string CONFIG = "latency.config";
+  const std::string WORKERS = "latency.workers";
+  const std::string READ_LATENCY = "read_operation_latency";
+  const std::string WRITE_LATENCY = "write_operation_latency";
+  const std::string WRITE_TXN_LATENCY = "write_txn_latency";
+}
+
+namespace benchmark {
+
+///
+/// Runs tasks once their due time has passed. A timer thread only moves due
+/// tasks to a pool of worker threads, which run them, so a task that blocks
+/// (an inner driver without async execution runs the request inline) neither
+/// holds up other requests nor delays later tasks past their due time. Tasks
+/// that are still queued on destruction run at their due time before it returns.
+///
+class DelayQueue {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit DelayQueue(int num_workers) : stopping_(false), timer_(&DelayQueue::RunTimer, this) {
+    for (int i = 0; i < num_workers; ++i) {
+      workers_.emplace_back(&DelayQueue::RunWorker, this);
+    }
+  }
+
+  ~DelayQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    timer_cv_.notify_one();
+    timer_.join();
+    ready_cv_.notify_all();
+    for (std::thread &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Schedule(Clock::time_point due, std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace(due, std::move(task));
+    }
+    timer_cv_.notify_one();
+  }
+
+ private:
+  void RunTimer() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (tasks_.empty()) {
+        if (stopping_) {
+          return;
+        }
+        timer_cv_.wait(lock);
+        continue;
+      }
+      auto next = tasks_.begin();
+      if (next->first > Clock::now()) {
+        timer_cv_.wait_until(lock, next->first);
+        continue;
+      }
+      auto now = Clock::now();
+      size_t moved = 0;
+      for (auto due = tasks_.begin(); due != tasks_.end() && due->first <= now; ++moved) {
+        ready_.push_back(std::move(due->second));
+        due = tasks_.erase(due);
+      }
+      if (moved == 1) {
+        ready_cv_.notify_one();
+      } else {
+        ready_cv_.notify_all();
+      }
+    }
+  }
+
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (ready_.empty()) {
+        // the timer has stopped once stopping_ is set and no task is left
+        if (stopping_ && tasks_.empty()) {
+          return;
+        }
+        ready_cv_.wait(lock);
+        continue;
+      }
+      std::function<void()> task = std::move(ready_.front());
+      ready_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::multimap<Clock::time_point, std::function<void()>> tasks_;
+  std::deque<std::function<void()>> ready_;
+  std::mutex mutex_;
+  std::condition_variable timer_cv_;
+  std::condition_variable ready_cv_;
+  bool stopping_;
+  std::thread timer_;
+  std::vector<std::thread> workers_;
+};
+
+namespace {
+  std::mutex delay_queue_mutex;
+  std::weak_ptr<DelayQueue> shared_delay_queue;
+
+  // @param num_workers only counts for the first LatencyDB of the process.
+  std::shared_ptr<DelayQueue> SharedDelayQueue(int num_workers) {
+    std::lock_guard<std::mutex> lock(delay_queue_mutex);
+    std::shared_ptr<DelayQueue> queue = shared_delay_queue.lock();
+    if (!queue) {
+      queue = std::make_shared<DelayQueue>(num_workers);
+      shared_delay_queue = queue;
+    }
+    return queue;
+  }
+
+  std::unique_ptr<LatencyDistribution> LoadDistribution(ConfigParser &config,
+                                                        std::string const &name) {
+    auto it = config.fields.find(name);
+    if (it == config.fields.end()) {
+      throw std::invalid_argument("Latency config has no " + name + " line");
+    }
+    return std::make_unique<LatencyDistribution>(it->second.weights, it->second.vals);
+  }
+}
+
+LatencyDistribution::LatencyDistribution(std::vector<double> const &weights,
+                                         std::vector<int> const &bounds)
+    : buckets_(weights.begin(), weights.end()) {
+  if (!bounds.empty() && bounds.size() != weights.size()) {
+    throw std::invalid_argument("Latency values and weights differ in length");
+  }
+  for (size_t i = 0; i < weights.size(); ++i) {
+    if (bounds.empty()) {
+      lower_.push_back(i * 1000);
+      upper_.push_back((i + 1) * 1000);
+    } else {
+      lower_.push_back(i == 0 ? 0 : bounds[i - 1]);
+      upper_.push_back(bounds[i]);
+    }
+    if (upper_.back() < lower_.back()) {
+      throw std::invalid_argument("Latency values must be increasing");
+    }
+  }
+}
+
+int64_t LatencyDistribution::SampleMicros(std::mt19937_64 &rng) {
+  if (lower_.empty()) {
+    return 0;
+  }
+  int bucket = buckets_(rng);
+  if (upper_[bucket] == lower_[bucket]) {
+    return lower_[bucket];
+  }
+  return std::uniform_int_distribution<int64_t>(lower_[bucket], upper_[bucket] - 1)(rng);
+}
+
+bool LatencyDB::Enabled(utils::Properties const &props) {
+  return props.GetProperty(INJECT, "none") != "none";
+}
+
+LatencyDB::LatencyDB(DB *db, utils::Properties *props)
+    : db_(db)
+    , rng_(std::random_device{}())
+    , delay_queue_(SharedDelayQueue(std::max(1, std::stoi(props->GetProperty(
+          WORKERS, std::to_string(std::thread::hardware_concurrency())))))) {
+  SetProps(props);
+  std::string mode = props->GetProperty(INJECT);
+  if (mode == "before") {
+    mode_ = Mode::kBefore;
+  } else if (mode == "instead") {
+    mode_ = Mode::kInstead;
+  } else {
+    throw std::invalid_argument("Unknown " + INJECT + " mode: " + mode);
+  }
+  ConfigParser config(props->GetProperty(CONFIG, props->GetProperty("config_path")));
+  read_latency_ = LoadDistribution(config, READ_LATENCY);
+  write_latency_ = LoadDistribution(config, WRITE_LATENCY);
+  write_txn_latency_ = LoadDistribution(config, WRITE_TXN_LATENCY);
+}
+
+LatencyDB::~LatencyDB() {
+  delete db_;
+}
+
+int64_t LatencyDB::SampleMicros(LatencyDistribution &distribution) {
+  return distribution.SampleMicros(rng_);
+}
+
+// The edge queries are reads.
+LatencyDistribution &LatencyDB::DistributionFor(Operation op) {
+  return op == Operation::READ || IsEdgeQuery(op) ? *read_latency_ : *write_latency_;
+}
+
+// Read-only transactions have no latency line of their own and use the one
+// for reads.
+Status LatencyDB::Execute(const DB_Operation &operation,
+                          std::vector<TimestampValue> &read_buffer,
+                          bool txn_op) {
+  LatencyDistribution &distribution = DistributionFor(operation.operation);
+  std::this_thread::sleep_for(std::chrono::microseconds(SampleMicros(distribution)));
+  if (mode_ == Mode::kInstead) {
+    return Status::kOK;
+  }
+  return db_->Execute(operation, read_buffer, txn_op);
+}
+
+Status LatencyDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                                     std::vector<TimestampValue> &read_buffer,
+                                     bool read_only) {
+  LatencyDistribution &distribution = read_only ? *read_latency_ : *write_txn_latency_;
+  std::this_thread::sleep_for(std::chrono::microseconds(SampleMicros(distribution)));
+  if (mode_ == Mode::kInstead) {
+    return Status::kOK;
+  }
+  return db_->ExecuteTransaction(operations, read_buffer, read_only);
+}
+
+void LatencyDB::ExecuteAsync(const DB_Operation &operation,
+                             std::vector<TimestampValue> &read_buffer,
+                             std::function<void(Status)> callback) {
+  LatencyDistribution &distribution = DistributionFor(operation.operation);
+  auto due = DelayQueue::Clock::now() + std::chrono::microseconds(SampleMicros(distribution));
+  if (mode_ == Mode::kInstead) {
+    delay_queue_->Schedule(due, [callback] { callback(Status::kOK); });
+    return;
+  }
+  DB *db = db_;
+  DB_Operation const *op = &operation;
+  std::vector<TimestampValue> *buffer = &read_buffer;
+  delay_queue_->Schedule(due, [db, op, buffer, callback] {
+    db->ExecuteAsync(*op, *buffer, callback);
+  });
+}
+
+void LatencyDB::ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                                        std::vector<TimestampValue> &read_buffer,
+                                        bool read_only,
+                                        std::function<void(Status)> callback) {
+  LatencyDistribution &distribution = read_only ? *read_latency_ : *write_txn_latency_;
+  auto due = DelayQueue::Clock::now() + std::chrono::microseconds(SampleMicros(distribution));
+  if (mode_ == Mode::kInstead) {
+    delay_queue_->Schedule(due, [callback] { callback(Status::kOK); });
+    return;
+  }
+  DB *db = db_;
+  std::vector<DB_Operation> const *ops = &operations;
+  std::vector<TimestampValue> *buffer = &read_buffer;
+  delay_queue_->Schedule(due, [db, ops, buffer, read_only, callback] {
+    db->ExecuteTransactionAsync(*ops, *buffer, read_only, callback);
+  });
+}
+
+} // benchmark
@@ -0,0 +1,153 @@
+#ifndef LATENCY_DB_H_
+#define LATENCY_DB_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "db.h"
+#include "properties.h"
+
+namespace benchmark {
+
+class DelayQueue;
+
+///
+/// Latency histogram from a *_latency config line. Bucket i is picked with
+/// the line's i-th weight and a delay is drawn uniformly from within it.
+///
+class LatencyDistribution {
+ public:
+  /// @param bounds upper bucket bounds in microseconds, one per weight; bucket
+  /// i spans [bounds[i-1], bounds[i]) and bucket 0 starts at 0. Empty means
+  /// bucket i spans [i, i+1) milliseconds.
+  LatencyDistribution(std::vector<double> const &weights, std::vector<int> const &bounds);
+
+  int64_t SampleMicros(std::mt19937_64 &rng);
+
+ private:
+  std::discrete_distribution<> buckets_;
+  std::vector<int64_t> lower_;
+  std::vector<int64_t> upper_;
+};
+
+///
+/// Wrapper that delays every Execute and ExecuteTransaction by a latency drawn
+/// from the read_operation_latency, write_operation_latency and
+/// write_txn_latency lines of a config file. It either forwards afterwards
+/// ("before") or skips the inner driver and succeeds ("instead").
+///
+/// The async variants do not block the calling thread: the request waits in
+/// a process-wide timer queue and is forwarded, or completed, by one of its
+/// latency.workers worker threads (default: one per core) once its delay has
+/// passed.
+///
+class LatencyDB : public DB {
+ public:
+  enum class Mode { kBefore, kInstead };
+
+  /// Takes ownership of @param db, which must already be initialized.
+  LatencyDB(DB *db, utils::Properties *props);
+  ~LatencyDB();
+
+  /// Whether @param props asks for injected latency (latency.inject).
+  static bool Enabled(utils::Properties const &props);
+
+  void Init() {
+    db_->Init();
+  }
+
+  void Cleanup() {
+    db_->Cleanup();
+  }
+
+  Status Read(DataTable table, const std::vector<Field> &key,
+              std::vector<TimestampValue> &buffer) {
+    return db_->Read(table, key, buffer);
+  }
+
+  Status Scan(DataTable table, const std::vector<Field> &key, int n,
+              std::vector<TimestampValue> &buffer) {
+    return db_->Scan(table, key, n, buffer);
+  }
+
+  Status Update(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+    return db_->Update(table, key, value);
+  }
+
+  Status Insert(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+    return db_->Insert(table, key, value);
+  }
+
+  Status Delete(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+    return db_->Delete(table, key, value);
+  }
+
+  Status RangeRead(int64_t id1, int limit, std::vector<TimestampValue> &buffer) {
+    return db_->RangeRead(id1, limit, buffer);
+  }
+
+  Status CountRead(int64_t id1, int64_t type, int64_t &count) {
+    return db_->CountRead(id1, type, count);
+  }
+
+  Status TimeRangeRead(int64_t id1, int64_t type, int64_t min_timestamp,
+                       int64_t max_timestamp, int limit,
+                       std::vector<TimestampValue> &buffer) {
+    return db_->TimeRangeRead(id1, type, min_timestamp, max_timestamp, limit, buffer);
+  }
+
+  Status Execute(const DB_Operation &operation,
+                 std::vector<TimestampValue> &read_buffer,
+                 bool txn_op = false);
+
+  Status ExecuteTransaction(const std::vector<DB_Operation> &operations,
+                            std::vector<TimestampValue> &read_buffer,
+                            bool read_only);
+
+  void ExecuteAsync(const DB_Operation &operation,
+                    std::vector<TimestampValue> &read_buffer,
+                    std::function<void(Status)> callback);
+
+  void ExecuteTransactionAsync(const std::vector<DB_Operation> &operations,
+                               std::vector<TimestampValue> &read_buffer,
+                               bool read_only,
+                               std::function<void(Status)> callback);
+
+  Status BatchInsert(DataTable table,
+                     const std::vector<std::vector<Field>> &keys,
+                     const std::vector<TimestampValue> &values) {
+    return db_->BatchInsert(table, keys, values);
+  }
+
+  Status BatchRead(DataTable table,
+                   const std::vector<Field> &floor,
+                   const std::vector<Field> &ceil,
+                   int n,
+                   std::vector<std::vector<Field>> &key_buffer) {
+    return db_->BatchRead(table, floor, ceil, n, key_buffer);
+  }
+
+  Status ParallelBatchRead(DataTable table, int num_threads,
+                           std::function<void(int, std::vector<Field> &&)> const &sink) {
+    return db_->ParallelBatchRead(table, num_threads, sink);
+  }
+
+ private:
+  int64_t SampleMicros(LatencyDistribution &distribution);
+
+  LatencyDistribution &DistributionFor(Operation op);
+
+  DB *db_;
+  Mode mode_;
+  std::mt19937_64 rng_;
+  std::unique_ptr<LatencyDistribution> read_latency_;
+  std::unique_ptr<LatencyDistribution> write_latency_;
+  std::unique_ptr<LatencyDistribution> write_txn_latency_;
+  std::shared_ptr<DelayQueue> delay_queue_;
+};
+
+} // benchmark
+
+#endif // LATENCY_DB_H_
@@ -0,0 +1,131 @@
+#include "live_key_pool.h"
+#include "constants.h"
+
+#include <stdexcept>
+
+namespace benchmark {
+
+  LiveKeyPool::Shard::~Shard() {
+    for (auto & chunk : chunks) {
+      delete chunk.load();
+    }
+  }
+
+  LiveKeyPool::ShardSamplers::ShardSamplers(LiveKeyPool const & pool, KeyPopularity const & popularity)
+      : samplers_(pool.shards_.size())
+  {
+    for (size_t i = 0; i < pool.shards_.size(); ++i) {
+      size_t base_size = pool.BaseSize(*pool.shards_[i]);
+      if (base_size > 0) {
+        samplers_[i].emplace(popularity, base_size);
+      }
+    }
+  }
+
+  LiveKeyPool::LiveKeyPool(std::unordered_map<int, std::vector<Edge>> const & base_edges)
+  {
+    for (int i = 0; i < constants::NUM_SHARDS; ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+    for (auto const & [shard_id, edges] : base_edges) {
+      if (shard_id < 0 || shard_id >= constants::NUM_SHARDS) {
+        throw std::runtime_error("Key pool edge outside of the shards");
+      }
+      Shard & shard = *shards_[shard_id];
+      shard.base = &edges;
+      size_t words = (edges.size() + 63) / 64;
+      shard.base_deleted = std::make_unique<std::atomic<uint64_t>[]>(words);
+      for (size_t w = 0; w < words; ++w) {
+        shard.base_deleted[w].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool LiveKeyPool::HasEdges(int shard) const {
+    return shard >= 0 && shard < constants::NUM_SHARDS
+        && (BaseSize(*shards_[shard]) > 0
+            || shards_[shard]->num_appended.load(std::memory_order_acquire) > 0);
+  }
+
+  LiveKeyPool::Ref LiveKeyPool::Sample(int shard_id, ShardSamplers const & samplers,
+                                       std::mt19937 & gen) const {
+    Shard const & shard = *shards_[shard_id];
+    size_t base_size = BaseSize(shard);
+    size_t num_appended = shard.num_appended.load(std::memory_order_acquire);
+    Ref ref{shard_id, 0};
+    for (int attempt = 0; attempt < kSampleAttempts; ++attempt) {
+      // base and appended edges are picked in proportion to their numbers
+      ref.index = num_appended == 0 ? 0
+          : std::uniform_int_distribution<size_t>(0, base_size + num_appended - 1)(gen);
+      if (ref.index < base_size) {
+        ref.index = (*samplers.samplers_[shard_id])(gen);
+      }
+      if (!IsDeleted(shard, ref.index)) {
+        break;
+      }
+    }
+    return ref;
+  }
+
+  Edge const & LiveKeyPool::Get(Ref const & ref) const {
+    Shard const & shard = *shards_[ref.shard];
+    size_t base_size = BaseSize(shard);
+    if (ref.index < base_size) {
+      return (*shard.base)[ref.index];
+    }
+    size_t i = ref.index - base_size;
+    return shard.chunks[i / kChunkEdges].load(std::memory_order_acquire)->edges[i % kChunkEdges];
+  }
+
+  void LiveKeyPool::Append(Edge const & edge) {
+    int shard_id = GetShardFromKey(edge.primary_key);
+    if (shard_id < 0 || shard_id >= constants::NUM_SHARDS) {
+      return;
+    }
+    Shard & shard = *shards_[shard_id];
+    // a new chunk is allocated and zeroed before taking the lock, so other
+    // appends to the shard do not wait for it; freed after the lock if unused
+    std::unique_ptr<Chunk> spare;
+    size_t n = shard.num_appended.load(std::memory_order_acquire);
+    if (n < kMaxChunks * kChunkEdges
+        && shard.chunks[n / kChunkEdges].load(std::memory_order_acquire) == nullptr) {
+      spare = std::make_unique<Chunk>();
+    }
+    std::lock_guard<std::mutex> lock(shard.append_mutex);
+    n = shard.num_appended.load(std::memory_order_relaxed);
+    if (n == kMaxChunks * kChunkEdges) {
+      return;
+    }
+    std::atomic<Chunk *> & chunk = shard.chunks[n / kChunkEdges];
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+      // only without a spare if other appends filled a chunk since the check above
+      chunk.store(spare ? spare.release() : new Chunk(), std::memory_order_release);
+    }
+    chunk.load(std::memory_order_relaxed)->edges[n % kChunkEdges] = edge;
+    // publishes the edge to samplers
+    shard.num_appended.store(n + 1, std::memory_order_release);
+  }
+
+  void LiveKeyPool::Remove(Ref const & ref) {
+    uint64_t mask;
+    DeletedWord(*shards_[ref.shard], ref.index, mask).fetch_or(mask, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> & LiveKeyPool::DeletedWord(Shard const & shard, size_t index,
+                                                   uint64_t & mask) const {
+    size_t base_size = BaseSize(shard);
+    if (index < base_size) {
+      mask = uint64_t(1) << (index % 64);
+      return shard.base_deleted[index / 64];
+    }
+    size_t i = (index - base_size) % kChunkEdges;
+    mask = uint64_t(1) << (i % 64);
+    Chunk *chunk = shard.chunks[(index - base_size) / kChunkEdges].load(std::memory_order_acquire);
+    return chunk->deleted[i / 64];
+  }
+
+  bool LiveKeyPool::IsDeleted(Shard const & shard, size_t index) const {
+    uint64_t mask;
+    return DeletedWord(shard, index, mask).load(std::memory_order_relaxed) & mask;
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "edge.h"
+#include "key_popularity.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace benchmark {
+
+  // LiveKeyPool is the run-phase key pool as it changes during a run. Edges
+  // are sampled from the batch-read edges of each shard plus the edges that
+  // client threads have inserted since, skipping edges they have deleted.
+  //
+  // The pool can be shared by several workloads (the tenants of a run), each
+  // sampling batch-read edges by a popularity of its own (ShardSamplers).
+  //
+  // Sampling and deleting take no locks. Each shard has an append buffer of
+  // fixed-size chunks, which are never moved or freed, so readers can index
+  // it while an insert adds to it under the shard's mutex. Deleted edges are
+  // marked in bitmaps that are set atomically.
+  class LiveKeyPool {
+  public:
+    // An edge of the pool: index is into the shard's batch-read edges,
+    // followed by its appended ones.
+    struct Ref {
+      int shard = -1;
+      size_t index = 0;
+    };
+
+    // Samples the batch-read edges of each shard of a pool by a popularity;
+    // appended edges are sampled uniformly.
+    class ShardSamplers {
+    public:
+      ShardSamplers(LiveKeyPool const & pool, KeyPopularity const & popularity);
+
+    private:
+      friend class LiveKeyPool;
+      std::vector<std::optional<KeySampler>> samplers_;
+    };
+
+    // @param base_edges must outlive the pool.
+    explicit LiveKeyPool(std::unordered_map<int, std::vector<Edge>> const & base_edges);
+
+    LiveKeyPool(LiveKeyPool const &) = delete;
+    LiveKeyPool &operator=(LiveKeyPool const &) = delete;
+
+    bool HasEdges(int shard) const;
+
+    // A random edge of @param shard, which must have edges, picked by
+    // @param samplers, made for this pool. A few tries are made to avoid
+    // deleted edges before one is returned anyway.
+    Ref Sample(int shard, ShardSamplers const & samplers, std::mt19937 & gen) const;
+
+    Edge const & Get(Ref const & ref) const;
+
+    // Adds an inserted edge; dropped if its shard's buffer is full.
+    void Append(Edge const & edge);
+
+    // Marks an edge deleted.
+    void Remove(Ref const & ref);
+
+  private:
+    static constexpr size_t kChunkEdges = 1 << 16;
+    static constexpr size_t kMaxChunks = 1 << 12;
+    static constexpr int kSampleAttempts = 8;
+
+    struct Chunk {
+      std::array<Edge, kChunkEdges> edges;
+      std::array<std::atomic<uint64_t>, kChunkEdges / 64> deleted;
+    };
+
+    struct Shard {
+      std::vector<Edge> const *base = nullptr;
+      std::unique_ptr<std::atomic<uint64_t>[]> base_deleted;
+      std::mutex append_mutex;
+      std::atomic<size_t> num_appended{0};
+      std::array<std::atomic<Chunk *>, kMaxChunks> chunks{};
+
+      ~Shard();
+    };
+
+    size_t BaseSize(Shard const & shard) const {
+      return shard.base ? shard.base->size() : 0;
+    }
+
+    // The bitmap word holding @param index's deleted bit, which is set in @param mask.
+    std::atomic<uint64_t> & DeletedWord(Shard const & shard, size_t index, uint64_t & mask) const;
+
+    bool IsDeleted(Shard const & shard, size_t index) const;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+  };
+}
@@ -1,5 +1,6 @@
 #include "measurements.h"
 
+#include <algorithm>
 #include <atomic>
 #include <fstream>
 #include <limits>
@@ -18,12 +19,19 @@ const char *kOperationString[static_cast<int>(Operation::MAXOPTYPE)] {
   "READMODIFYWRITE",
   "DELETE",
   "READTRANSACTION",
-  "WRITETRANSACTION"
+  "WRITETRANSACTION",
+  "RANGEREAD",
+  "COUNTREAD",
+  "TIMERANGEREAD"
 };
 
-Measurements::Measurements() : count_{}, latency_sum_{}, latency_max_{} {
+Measurements::Measurements() : Measurements(nullptr) {
+}
+
+Measurements::Measurements(Measurements *total)
+    : total_(total), count_{}, latency_sum_{}, latency_max_{} {
   std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
+  for (int i = 0; total_ == nullptr && i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
     latencies_[i].reserve(31000000);
   }
 }
@@ -37,11 +45,40 @@ void Measurements::Report(Operation op, uint64_t latency) {
   uint64_t prev_max = latency_max_[static_cast<int>(op)].load(std::memory_order_relaxed);
   while (prev_max < latency
          && !latency_max_[static_cast<int>(op)].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
+  if (total_ != nullptr) {
+    total_->Report(op, latency);
+    return;
+  }
   vector_lock.lock();
   latencies_[static_cast<int>(op)].emplace_back(latency);
   vector_lock.unlock();
 }
 
+void Metric::Report(uint64_t value) {
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t prev_min = min_.load(std::memory_order_relaxed);
+  while (prev_min > value && !min_.compare_exchange_weak(prev_min, value, std::memory_order_relaxed));
+  uint64_t prev_max = max_.load(std::memory_order_relaxed);
+  while (prev_max < value && !max_.compare_exchange_weak(prev_max, value, std::memory_order_relaxed));
+  if (total_ != nullptr) {
+    total_->Report(value);
+  }
+}
+
+void Measurements::ReportMetric(std::string const &name, uint64_t value) {
+  GetMetric(name)->Report(value);
+}
+
+Metric *Measurements::GetMetric(std::string const &name) {
+  std::lock_guard<std::mutex> lock(metrics_lock_);
+  auto [it, inserted] = metrics_.try_emplace(name);
+  if (inserted && total_ != nullptr) {
+    it->second.total_ = total_->GetMetric(name);
+  }
+  return &it->second;
+}
+
 std::string Measurements::GetStatusMsg() {
   std::ostringstream msg_stream;
   msg_stream.precision(2);
@@ -84,6 +121,49 @@ std::string Measurements::GetStatusMsg() {
                    ? write_total_latency / write_cnt
                    : 0) / 1000.0
                << "]";
+  std::lock_guard<std::mutex> lock(metrics_lock_);
+  for (auto const & [name, metric] : metrics_) {
+    uint64_t count = metric.count_.load(std::memory_order_relaxed);
+    if (count == 0) {
+      continue;
+    }
+    msg_stream << " [" << name << ":"
+               << " Count=" << count
+               << " Max=" << metric.max_.load(std::memory_order_relaxed) / 1000.0
+               << " Min=" << metric.min_.load(std::memory_order_relaxed) / 1000.0
+               << " Avg=" << static_cast<double>(metric.sum_.load(std::memory_order_relaxed)) / count / 1000.0
+               << "]";
+  }
+  return std::to_string(total_cnt) + msg_stream.str();
+}
+
+Measurements::Totals Measurements::GetTotals() {
+  Totals totals;
+  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
+    totals.count[i] = count_[i].load(std::memory_order_relaxed);
+    totals.latency_sum[i] = latency_sum_[i].load(std::memory_order_relaxed);
+  }
+  return totals;
+}
+
+std::string Measurements::GetIntervalMsg(Totals const &from, Totals const &to) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " operations;";
+  uint64_t total_cnt = 0;
+  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); i++) {
+    bool reset = to.count[i] < from.count[i];
+    uint64_t cnt = reset ? to.count[i] : to.count[i] - from.count[i];
+    uint64_t sum = reset ? to.latency_sum[i] : to.latency_sum[i] - from.latency_sum[i];
+    if (cnt == 0) {
+      continue;
+    }
+    msg_stream << " [" << kOperationString[i] << ":"
+               << " Count=" << cnt
+               << " Avg=" << static_cast<double>(sum) / cnt / 1000.0
+               << "]";
+    total_cnt += cnt;
+  }
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
@@ -112,6 +192,14 @@ void Measurements::Reset() {
     latencies_[i].clear();
   }
   vector_lock.unlock();
+  // series stay, as drivers hold on to them
+  std::lock_guard<std::mutex> lock(metrics_lock_);
+  for (auto & [name, metric] : metrics_) {
+    metric.count_ = 0;
+    metric.sum_ = 0;
+    metric.min_ = std::numeric_limits<uint64_t>::max();
+    metric.max_ = 0;
+  }
 }
 
 uint64_t Measurements::GetTotalNumOps() {
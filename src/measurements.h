@@ -5,14 +5,41 @@
 #include "workload.h"
 
 #include <atomic>
+#include <limits>
+#include <map>
 #include <mutex>
+#include <string>
 
 namespace benchmark {
 
+// A driver-specific series such as cache hits, whose samples (in nanoseconds)
+// are added with atomics, so reporting one takes no lock.
+class Metric {
+ public:
+  void Report(uint64_t value);
+
+ private:
+  friend class Measurements;
+  Metric *total_ = nullptr; // the same series of the total measurements
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> min_{std::numeric_limits<uint64_t>::max()};
+  std::atomic<uint64_t> max_{0};
+};
+
 class Measurements {
  public:
   Measurements();
+  // Measurements of one tenant of a run, which also reports to total; only
+  // total keeps each latency for WriteLatencies.
+  explicit Measurements(Measurements *total);
   void Report(Operation op, uint64_t latency);
+  // Records a sample (in nanoseconds) of a driver-specific series such as
+  // session-pool waits; shown after the operations in GetStatusMsg.
+  void ReportMetric(std::string const &name, uint64_t value);
+  // The series @param name, created on first use; it lives as long as the
+  // measurements, so hot paths can look it up once and Report to it.
+  Metric *GetMetric(std::string const &name);
   uint64_t GetCount(Operation op) {
     return count_[static_cast<int>(op)].load(std::memory_order_relaxed);
   }
@@ -23,16 +50,29 @@ class Measurements {
         : 0.0;
   }
   std::string GetStatusMsg();
+  // Operation counts and latency sums so far, to report the operations between
+  // two points of an experiment with GetIntervalMsg.
+  struct Totals {
+    uint64_t count[static_cast<int>(Operation::MAXOPTYPE)] = {};
+    uint64_t latency_sum[static_cast<int>(Operation::MAXOPTYPE)] = {};
+  };
+  Totals GetTotals();
+  // Like GetStatusMsg, for the operations between from and to; if measurements
+  // were Reset in between, only those since the Reset.
+  static std::string GetIntervalMsg(Totals const &from, Totals const &to);
   std::string WriteLatencies();
   void Reset();
   uint64_t GetTotalNumOps();
  private:
+  Measurements *const total_;
   std::atomic<uint32_t> count_[static_cast<int>(Operation::MAXOPTYPE)];
   std::atomic<uint64_t> latency_sum_[static_cast<int>(Operation::MAXOPTYPE)];
   std::atomic<uint64_t> latency_min_[static_cast<int>(Operation::MAXOPTYPE)];
   std::atomic<uint64_t> latency_max_[static_cast<int>(Operation::MAXOPTYPE)];
   std::mutex vector_lock;
   std::vector<uint64_t> latencies_[static_cast<int>(Operation::MAXOPTYPE)];
+  std::mutex metrics_lock_;
+  std::map<std::string, Metric> metrics_;
   std::map<int, std::string> mapOfOps = {
         {0,"Insert"},
         {1,"Read"},
@@ -42,7 +82,10 @@ class Measurements {
         {5,"Delete"},
         {6,"ReadTxn"},
         {7,"WriteTxn"},
-        {8,"Max"},
+        {8,"RangeRead"},
+        {9,"CountRead"},
+        {10,"TimeRangeRead"},
+        {11,"Max"},
   };
 };
 
@@ -1,14 +1,19 @@
 #include "parse_config.h"
 
 namespace {
-  const std::unordered_set<std::string> HAVE_VALS {"write_txn_sizes", "read_txn_sizes"};
+  const std::unordered_set<std::string> HAVE_VALS {"write_txn_sizes", "read_txn_sizes",
+        "edge_degrees"};
   const std::unordered_set<std::string> HAVE_TYPES {"edge_types", "read_operation_types",
         "write_operation_types",
         "read_txn_operation_types", "errors", "txn_errors", "operation_predicates", 
-        "txn_predicates", "txn_predicate_counts", "read_tiers", "write_txn_operation_types"};
+        "txn_predicates", "txn_predicate_counts", "read_tiers", "write_txn_operation_types",
+        "key_popularity", "phases"};
   const std::unordered_set<std::string> HAVE_NEITHER {"read_operation_latency",                
         "write_operation_latency", "operations",
         "write_txn_latency", "primary_shards", "remote_shards"};
+  // latency lines may give bucket bounds in microseconds as values (see LatencyDB)
+  const std::unordered_set<std::string> MAY_HAVE_VALS {"read_operation_latency",
+        "write_operation_latency", "write_txn_latency"};
 }
 
 namespace benchmark {
@@ -24,6 +29,17 @@ namespace benchmark {
     // TODO: check that all the desired fields are present
   }
 
+  void ConfigParser::Override(std::string const & filepath) {
+    std::ifstream infile {filepath};
+    if (!infile) {
+      throw std::invalid_argument("Cannot open config file " + filepath);
+    }
+    for (std::string line; std::getline(infile, line); ) {
+      LineObject obj {line};
+      fields.insert_or_assign(obj.name, std::move(obj));
+    }
+  }
+
   // print out all line objects for debugging purposes
   void ConfigParser::printOut() const {
     for (auto const& [key, val] : fields) {
@@ -46,6 +62,8 @@ namespace benchmark {
       types = parseList<std::string>(matches.str(2), [] (std::string & s) { return s; });
     } else if (HAVE_NEITHER.find(this->name) == HAVE_NEITHER.end()) {
       throw std::invalid_argument("Invalid name read from json: " + this->name);
+    } else if (MAY_HAVE_VALS.find(this->name) != MAY_HAVE_VALS.end() && matches[2].matched) {
+      vals = parseList<int>(matches.str(2), [] (std::string & s) { return std::stoi(s); });
     }
     weights = parseList<double>(matches.str(3), [] (std::string & s) { return std::stod(s); });
     distribution = std::discrete_distribution<>(weights.begin(), weights.end());
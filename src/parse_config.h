@@ -18,6 +18,8 @@ namespace benchmark {
     public:
 
       ConfigParser(std::string const & configFilepath);
+      // replaces the lines that the config file at filepath also has
+      void Override(std::string const & filepath);
       void printOut() const; // for testing
 
       struct LineObject {
@@ -0,0 +1,230 @@
+#include "replay.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "db_factory.h"
+#include "measurements.h"
+#include "timer.h"
+#include "trace.h"
+
+namespace benchmark {
+
+namespace {
+const std::string TRACE_PATH = "replay_path";
+const std::string THREADS = "replay.threads";
+const std::string THREADS_DEFAULT = "1";
+const std::string TIMED = "replay.timed";
+// requests read ahead of the replay threads, over all streams
+const size_t READ_AHEAD = 1 << 18;
+
+// The requests read ahead for each recorded stream. A replay thread takes the
+// stream whose next request is due first, issues that request and then gives
+// the stream back, so each stream's requests run one at a time and in order,
+// but no thread is tied to a stream. Timed, a stream is only taken once its
+// next request is due, at its recorded time after start_nanos.
+class StreamQueues {
+ public:
+  StreamQueues(bool timed, int64_t start_nanos, int64_t first_time_nanos)
+      : timed_(timed), offset_nanos_(start_nanos - first_time_nanos) {}
+
+  // Waits while READ_AHEAD requests are buffered.
+  void Push(uint32_t stream, TraceRequest &&request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return size_ < READ_AHEAD; });
+    Stream &s = streams_[stream];
+    s.requests.push_back(std::move(request));
+    ++size_;
+    if (!s.busy && s.requests.size() == 1) {
+      ready_.emplace(s.requests.front().time_nanos, stream);
+      not_empty_.notify_one();
+    }
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  // Takes the next request of the stream due first, which is the caller's
+  // until Release. False once the queues are closed and drained.
+  bool Pop(uint32_t &stream, TraceRequest &request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (!ready_.empty()) {
+        int64_t wait = timed_ ? ready_.begin()->first + offset_nanos_ - utils::CurrentTimeNanos() : 0;
+        if (wait <= 0) {
+          break;
+        }
+        not_empty_.wait_for(lock, std::chrono::nanoseconds(wait));
+      } else if (closed_ && size_ == 0) {
+        return false;
+      } else {
+        not_empty_.wait(lock);
+      }
+    }
+    stream = ready_.begin()->second;
+    ready_.erase(ready_.begin());
+    Stream &s = streams_[stream];
+    s.busy = true;
+    request = std::move(s.requests.front());
+    s.requests.pop_front();
+    --size_;
+    not_full_.notify_one();
+    return true;
+  }
+
+  void Release(uint32_t stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stream &s = streams_[stream];
+    s.busy = false;
+    if (!s.requests.empty()) {
+      ready_.emplace(s.requests.front().time_nanos, stream);
+    }
+    // also wakes the threads waiting for the end once the last stream is released
+    not_empty_.notify_all();
+  }
+
+ private:
+  struct Stream {
+    std::deque<TraceRequest> requests;
+    bool busy = false; // taken by a replay thread
+  };
+
+  bool const timed_;
+  int64_t const offset_nanos_; // from recorded to replay time
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::unordered_map<uint32_t, Stream> streams_;
+  // the streams with requests that no thread has taken, by their next request's time
+  std::set<std::pair<int64_t, uint32_t>> ready_;
+  size_t size_ = 0;
+  bool closed_ = false;
+};
+
+struct Totals {
+  int64_t requests = 0;
+  int64_t failed = 0;
+  int64_t same_outcome = 0;
+};
+
+// Gives the request's operations current timestamps (see TraceRequest).
+inline void Retime(TraceRequest &request, int64_t now) {
+  for (auto &op : request.operations) {
+    op.time_and_value.timestamp = now;
+    if (op.operation == Operation::TIMERANGEREAD) {
+      op.max_timestamp = now;
+      op.min_timestamp = op.min_timestamp < 0 ? now + op.min_timestamp : 0;
+    }
+  }
+}
+
+Totals ReplayThread(DB *db, StreamQueues *queues) {
+  Totals totals;
+  uint32_t stream;
+  TraceRequest request;
+  std::vector<DB::TimestampValue> read_buffer;
+  while (queues->Pop(stream, request)) {
+    Retime(request, utils::CurrentTimeNanos());
+    read_buffer.clear();
+    Status s;
+    switch (request.kind) {
+      case TraceRequest::Kind::kOperation:
+        s = db->Execute(request.operations[0], read_buffer);
+        break;
+      case TraceRequest::Kind::kReadTransaction:
+        s = db->ExecuteTransaction(request.operations, read_buffer, true);
+        break;
+      default:
+        s = db->ExecuteTransaction(request.operations, read_buffer, false);
+        break;
+    }
+    queues->Release(stream);
+    ++totals.requests;
+    totals.failed += s != Status::kOK;
+    totals.same_outcome += s == request.status;
+  }
+  return totals;
+}
+} // namespace
+
+void RunReplay(utils::Properties &props) {
+  const int num_threads = std::stoi(props.GetProperty(THREADS, THREADS_DEFAULT));
+  const bool timed = utils::StrToBool(props.GetProperty(TIMED, "true"));
+  props.SetProperty("max_concurrent_connections", std::to_string(num_threads));
+
+  TraceReader reader(props.GetProperty(TRACE_PATH));
+  uint32_t stream;
+  TraceRequest request;
+  if (!reader.Next(stream, request)) {
+    std::cout << "The trace holds no requests" << std::endl;
+    return;
+  }
+  // recorded times are replayed relative to the first request
+  int64_t first_time_nanos = request.time_nanos;
+
+  Measurements measurements;
+  std::vector<DB *> dbs;
+  for (int i = 0; i < num_threads; ++i) {
+    DB *db = DBFactory::CreateDB(&props, &measurements);
+    if (db == nullptr) {
+      std::cerr << "Unknown database name " << props["dbname"] << std::endl;
+      exit(1);
+    }
+    dbs.push_back(db);
+  }
+
+  int64_t start_nanos = utils::CurrentTimeNanos();
+  StreamQueues queues(timed, start_nanos, first_time_nanos);
+  std::vector<std::future<Totals>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::async(std::launch::async, ReplayThread, dbs[i], &queues));
+  }
+
+  uint32_t num_streams = 0;
+  do {
+    if (stream + 1 > num_streams && num_streams <= static_cast<uint32_t>(num_threads)
+        && stream + 1 > static_cast<uint32_t>(num_threads)) {
+      std::cerr << "Warning: the trace has more recorded threads than replay.threads (" << num_threads
+                << "), so requests due at once may be issued late" << std::endl;
+    }
+    num_streams = std::max(num_streams, stream + 1);
+    queues.Push(stream, std::move(request));
+  } while (reader.Next(stream, request));
+  queues.Close();
+
+  Totals totals;
+  for (auto &thread : threads) {
+    Totals t = thread.get();
+    totals.requests += t.requests;
+    totals.failed += t.failed;
+    totals.same_outcome += t.same_outcome;
+  }
+  double runtime = (utils::CurrentTimeNanos() - start_nanos) / 1e9;
+
+  std::cout << "Replayed " << totals.requests << " requests of " << num_streams
+            << " recorded threads on " << num_threads << " threads" << std::endl;
+  std::cout << "Total runtime (sec): " << runtime << std::endl;
+  std::cout << "Throughput: " << totals.requests / runtime << std::endl;
+  std::cout << "Number of failed requests: " << totals.failed << std::endl;
+  std::cout << "Requests with the recorded outcome: " << totals.same_outcome << std::endl;
+  std::cout << measurements.GetStatusMsg() << std::endl;
+
+  for (DB *db : dbs) {
+    db->Cleanup();
+    delete db;
+  }
+}
+
+} // benchmark
@@ -0,0 +1,22 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "properties.h"
+
+namespace benchmark {
+
+///
+/// Re-issues the requests of a trace recorded with -record against the
+/// configured database. The requests are read ahead into a buffer per recorded
+/// stream (one per recording thread). Each of replay.threads threads issues
+/// the next request of whichever stream is due first, so a stream's requests
+/// run one at a time in their recorded order: at their recorded times when
+/// replay.timed is true (the default), otherwise as fast as they can. Reports
+/// the usual latency measurements and how many requests got the same outcome
+/// as when they were recorded.
+///
+void RunReplay(utils::Properties &props);
+
+} // benchmark
+
+#endif // REPLAY_H_
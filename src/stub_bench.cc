@@ -0,0 +1,184 @@
+#include "stub_bench.h"
+
+#include <ctime>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "db_factory.h"
+#include "edge.h"
+#include "measurements.h"
+#include "timer.h"
+#include "wire_stub.h"
+
+namespace benchmark {
+
+namespace {
+const std::string OPS = "stub_bench.ops";
+const std::string OPS_DEFAULT = "10000";
+const std::string TXN_SIZE = "stub_bench.txn_size";
+const std::string TXN_SIZE_DEFAULT = "4";
+
+inline int64_t CpuNanos(clockid_t clock) {
+  timespec ts;
+  clock_gettime(clock, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+using Request = std::function<Status(DB &, std::mt19937_64 &)>;
+
+struct Totals {
+  int64_t ops = 0;
+  int64_t failed = 0;
+  int64_t wall_ns = 0;
+  int64_t thread_cpu_ns = 0;
+};
+
+inline std::vector<DB::Field> ObjectKey(std::mt19937_64 &rng) {
+  return {{"id", static_cast<int64_t>(rng() >> 1)}};
+}
+
+inline std::vector<DB::Field> EdgeKey(std::mt19937_64 &rng, EdgeType type) {
+  return {{"id1", static_cast<int64_t>(rng() >> 1)},
+          {"id2", static_cast<int64_t>(rng() >> 1)},
+          {"type", static_cast<int64_t>(type)}};
+}
+
+inline std::vector<DB::Field> Key(DataTable table, std::mt19937_64 &rng) {
+  return table == DataTable::Objects ? ObjectKey(rng) : EdgeKey(rng, EdgeType::Other);
+}
+
+// The operations measured, in the order they are run.
+std::vector<std::pair<std::string, Request>> Requests(int txn_size) {
+  std::string value(constants::VALUE_SIZE_BYTES, 'x');
+  auto single = [value](DataTable table, Operation operation) -> Request {
+    return [=](DB &db, std::mt19937_64 &rng) {
+      std::vector<DB::TimestampValue> buffer;
+      std::vector<DB::Field> key = table == DataTable::Edges && operation == Operation::INSERT
+          ? EdgeKey(rng, static_cast<EdgeType>(rng() % 4))
+          : Key(table, rng);
+      return db.Execute({table, key, {utils::CurrentTimeNanos(), value}, operation}, buffer);
+    };
+  };
+  auto transaction = [=](bool read_only) -> Request {
+    return [=](DB &db, std::mt19937_64 &rng) {
+      std::vector<DB::DB_Operation> operations;
+      for (int i = 0; i < txn_size; ++i) {
+        DataTable table = i % 2 == 0 ? DataTable::Objects : DataTable::Edges;
+        operations.emplace_back(table, Key(table, rng),
+                                DB::TimestampValue{utils::CurrentTimeNanos(), value},
+                                read_only ? Operation::READ : Operation::UPDATE);
+      }
+      std::vector<DB::TimestampValue> buffer;
+      return db.ExecuteTransaction(operations, buffer, read_only);
+    };
+  };
+  return {
+    {"read object", single(DataTable::Objects, Operation::READ)},
+    {"read edge", single(DataTable::Edges, Operation::READ)},
+    {"insert object", single(DataTable::Objects, Operation::INSERT)},
+    {"insert edge", single(DataTable::Edges, Operation::INSERT)},
+    {"update object", single(DataTable::Objects, Operation::UPDATE)},
+    {"update edge", single(DataTable::Edges, Operation::UPDATE)},
+    {"delete edge", single(DataTable::Edges, Operation::DELETE)},
+    {"read transaction", transaction(true)},
+    {"write transaction", transaction(false)},
+  };
+}
+
+Totals RunRequests(DB *db, Request const &request, int ops, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  Totals totals;
+  int64_t cpu_start = CpuNanos(CLOCK_THREAD_CPUTIME_ID);
+  int64_t start = utils::CurrentTimeNanos();
+  for (int i = 0; i < ops; ++i) {
+    Status s = request(*db, rng);
+    // reads of random keys miss on drivers that store data
+    if (s != Status::kOK && s != Status::kNotFound) {
+      ++totals.failed;
+    }
+  }
+  totals.ops = ops;
+  totals.wall_ns = utils::CurrentTimeNanos() - start;
+  totals.thread_cpu_ns = CpuNanos(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+  return totals;
+}
+} // namespace
+
+void RunStubBench(utils::Properties &props) {
+  const std::string dbname = props.GetProperty("dbname", "test");
+  const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
+  const int ops = std::stoi(props.GetProperty(OPS, OPS_DEFAULT));
+  const int txn_size = std::stoi(props.GetProperty(TXN_SIZE, TXN_SIZE_DEFAULT));
+  props.SetProperty("max_concurrent_connections", std::to_string(num_threads));
+
+  std::unique_ptr<WireStub> stub;
+  WireStub::Protocol protocol;
+  if (WireStub::DriverProtocol(dbname, protocol)) {
+    stub = std::make_unique<WireStub>(protocol, props);
+    stub->Redirect(dbname, props);
+    std::cout << "Stub server listening on 127.0.0.1:" << stub->Port() << std::endl;
+  } else {
+    std::cout << dbname << " speaks neither wire protocol; running it as configured" << std::endl;
+  }
+
+  Measurements measurements;
+  std::vector<DB *> dbs;
+  for (int i = 0; i < num_threads; ++i) {
+    DB *db = DBFactory::CreateDB(&props, &measurements);
+    if (db == nullptr) {
+      std::cerr << "Unknown database name " << dbname << std::endl;
+      exit(1);
+    }
+    dbs.push_back(db);
+  }
+
+  std::cout << std::left << std::setw(20) << "operation" << std::right
+            << std::setw(10) << "ops" << std::setw(10) << "failed"
+            << std::setw(14) << "latency_us" << std::setw(16) << "thread_cpu_us"
+            << std::setw(16) << "driver_cpu_us" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  uint64_t seed = 0;
+  for (auto const &named : Requests(txn_size)) {
+    int64_t process_cpu_start = CpuNanos(CLOCK_PROCESS_CPUTIME_ID);
+    int64_t stub_cpu_start = stub ? stub->CpuNanos() : 0;
+    std::vector<std::future<Totals>> threads;
+    for (DB *db : dbs) {
+      threads.push_back(std::async(std::launch::async, RunRequests, db,
+                                   std::cref(named.second), ops, ++seed));
+    }
+    Totals totals;
+    for (auto &thread : threads) {
+      Totals t = thread.get();
+      totals.ops += t.ops;
+      totals.failed += t.failed;
+      totals.wall_ns += t.wall_ns;
+      totals.thread_cpu_ns += t.thread_cpu_ns;
+    }
+    int64_t driver_cpu_ns = CpuNanos(CLOCK_PROCESS_CPUTIME_ID) - process_cpu_start
+                            - ((stub ? stub->CpuNanos() : 0) - stub_cpu_start);
+    double per_op_us = 1000.0 * std::max<int64_t>(totals.ops, 1);
+    std::cout << std::left << std::setw(20) << named.first << std::right
+              << std::setw(10) << totals.ops << std::setw(10) << totals.failed
+              << std::setw(14) << totals.wall_ns / per_op_us
+              << std::setw(16) << totals.thread_cpu_ns / per_op_us
+              << std::setw(16) << driver_cpu_ns / per_op_us << std::endl;
+  }
+  std::cout << measurements.GetStatusMsg() << std::endl;
+
+  // disconnect before the stub goes away
+  for (DB *db : dbs) {
+    db->Cleanup();
+    delete db;
+  }
+}
+
+} // benchmark
@@ -0,0 +1,22 @@
+#ifndef STUB_BENCH_H_
+#define STUB_BENCH_H_
+
+#include "properties.h"
+
+namespace benchmark {
+
+///
+/// Measures what each operation costs the driver itself. A driver speaking
+/// the PostgreSQL or MySQL protocol is pointed at an in-process WireStub,
+/// which answers every query with a canned result; other drivers run as
+/// configured. Each kind of operation is then run stub_bench.ops times on
+/// each of threadcount threads, on random keys, and for each kind the mean
+/// latency and the CPU time per operation are printed: on the calling
+/// threads, and in the whole process less the stub's own threads (which also
+/// counts helper threads such as the MySQL event loop).
+///
+void RunStubBench(utils::Properties &props);
+
+} // benchmark
+
+#endif // STUB_BENCH_H_
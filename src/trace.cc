@@ -0,0 +1,242 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#include "timer.h"
+
+namespace benchmark {
+
+namespace {
+const char MAGIC[] = "TAOTRACE";
+const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+const uint8_t VERSION = 1;
+// a thread's buffer is written out once it grows past this
+const size_t BLOCK_SIZE = 64 * 1024;
+
+std::atomic<uint64_t> next_generation{1};
+
+inline void PutVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline uint64_t GetVarint(std::string const &in, size_t &offset) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (offset >= in.size()) {
+      throw std::runtime_error("Truncated trace block");
+    }
+    uint8_t byte = in[offset++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Invalid varint in trace");
+}
+
+inline uint8_t GetByte(std::string const &in, size_t &offset) {
+  if (offset >= in.size()) {
+    throw std::runtime_error("Truncated trace block");
+  }
+  return in[offset++];
+}
+
+inline void PutUint32(std::ostream &out, uint32_t value) {
+  char bytes[4];
+  for (int i = 0; i < 4; ++i) {
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  }
+  out.write(bytes, 4);
+}
+
+inline bool GetUint32(std::istream &in, uint32_t &value) {
+  unsigned char bytes[4];
+  if (!in.read(reinterpret_cast<char *>(bytes), 4)) {
+    return false;
+  }
+  value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+  return true;
+}
+
+// key field names, which the trace leaves out, by table and number of fields
+inline std::vector<std::string> const &KeyNames(DataTable table, size_t num_fields) {
+  static const std::vector<std::string> object_names = {"id"};
+  static const std::vector<std::string> edge_names = {"id1", "id2", "type"};
+  static const std::vector<std::string> edge_query_names = {"id1", "type"};
+  if (table == DataTable::Objects) {
+    return object_names;
+  }
+  return num_fields == 2 ? edge_query_names : edge_names;
+}
+} // namespace
+
+TraceRecorder::TraceRecorder(std::string const &path)
+    : start_nanos_(utils::CurrentTimeNanos())
+    , generation_(next_generation++)
+    , out_(path, std::ios::binary | std::ios::trunc) {
+  if (!out_) {
+    throw std::runtime_error("Cannot open trace file " + path);
+  }
+  out_.write(MAGIC, MAGIC_SIZE);
+  out_.put(static_cast<char>(VERSION));
+}
+
+TraceRecorder::~TraceRecorder() {
+  Flush();
+}
+
+TraceRecorder::Stream &TraceRecorder::ThisThreadStream() {
+  thread_local Stream *stream = nullptr;
+  thread_local uint64_t stream_generation = 0;
+  if (stream == nullptr || stream_generation != generation_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.push_back(std::make_unique<Stream>());
+    stream = streams_.back().get();
+    stream->id = next_stream_id_++;
+    stream_generation = generation_;
+  }
+  return *stream;
+}
+
+void TraceRecorder::Record(TraceRequest::Kind kind, DB::DB_Operation const *operations,
+                           size_t num_operations, Status status, int64_t start_nanos) {
+  Stream &stream = ThisThreadStream();
+  std::string &out = stream.buffer;
+  int64_t time = std::max<int64_t>(start_nanos - start_nanos_, stream.last_time);
+  PutVarint(out, time - stream.last_time);
+  stream.last_time = time;
+  out.push_back(static_cast<char>(kind));
+  out.push_back(static_cast<char>(status));
+  PutVarint(out, num_operations);
+  for (size_t i = 0; i < num_operations; ++i) {
+    DB::DB_Operation const &op = operations[i];
+    out.push_back(static_cast<char>(op.operation));
+    out.push_back(static_cast<char>(op.table));
+    PutVarint(out, op.key.size());
+    for (auto const &field : op.key) {
+      PutVarint(out, static_cast<uint64_t>(field.value));
+    }
+    PutVarint(out, op.time_and_value.value.size());
+    if (op.operation == Operation::RANGEREAD || op.operation == Operation::TIMERANGEREAD) {
+      PutVarint(out, op.limit);
+    }
+    if (op.operation == Operation::TIMERANGEREAD) {
+      PutVarint(out, op.min_timestamp == 0 ? 0 : op.max_timestamp - op.min_timestamp);
+    }
+  }
+  if (out.size() >= BLOCK_SIZE) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WriteBlock(stream);
+  }
+}
+
+void TraceRecorder::WriteBlock(Stream &stream) {
+  if (stream.buffer.empty()) {
+    return;
+  }
+  PutUint32(out_, stream.id);
+  PutUint32(out_, stream.buffer.size());
+  out_.write(stream.buffer.data(), stream.buffer.size());
+  stream.buffer.clear();
+}
+
+void TraceRecorder::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &stream : streams_) {
+    WriteBlock(*stream);
+  }
+  streams_.clear();
+  generation_ = next_generation++;
+  out_.flush();
+}
+
+TraceReader::TraceReader(std::string const &path)
+    : in_(path, std::ios::binary) {
+  char magic[MAGIC_SIZE];
+  if (!in_ || !in_.read(magic, MAGIC_SIZE) || std::memcmp(magic, MAGIC, MAGIC_SIZE) != 0) {
+    throw std::runtime_error("Not a trace file: " + path);
+  }
+  if (in_.get() != VERSION) {
+    throw std::runtime_error("Unsupported trace version in " + path);
+  }
+}
+
+bool TraceReader::IsTrace(std::string const &path) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[MAGIC_SIZE];
+  return in.read(magic, MAGIC_SIZE) && std::memcmp(magic, MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool TraceReader::NextBlock(uint32_t &stream, std::string &block) {
+  uint32_t length;
+  if (!GetUint32(in_, stream)) {
+    return false;
+  }
+  if (!GetUint32(in_, length)) {
+    throw std::runtime_error("Truncated trace block header");
+  }
+  block.resize(length);
+  if (length > 0 && !in_.read(&block[0], length)) {
+    throw std::runtime_error("Truncated trace block");
+  }
+  return true;
+}
+
+bool TraceReader::ReadBlock() {
+  offset_ = 0;
+  return NextBlock(stream_, block_);
+}
+
+bool TraceReader::Next(uint32_t &stream, TraceRequest &request) {
+  while (offset_ >= block_.size()) {
+    if (!ReadBlock()) {
+      return false;
+    }
+  }
+  stream = stream_;
+  DecodeRequest(block_, offset_, request);
+  int64_t &last_time = last_time_[stream];
+  last_time += request.time_nanos;
+  request.time_nanos = last_time;
+  return true;
+}
+
+void TraceReader::DecodeRequest(std::string const &block, size_t &offset, TraceRequest &request) {
+  request.time_nanos = GetVarint(block, offset);
+  request.kind = static_cast<TraceRequest::Kind>(GetByte(block, offset));
+  request.status = static_cast<Status>(GetByte(block, offset));
+  request.operations.clear();
+  size_t num_operations = GetVarint(block, offset);
+  for (size_t i = 0; i < num_operations; ++i) {
+    auto operation = static_cast<Operation>(GetByte(block, offset));
+    auto table = static_cast<DataTable>(GetByte(block, offset));
+    size_t num_fields = GetVarint(block, offset);
+    auto const &names = KeyNames(table, num_fields);
+    if (num_fields > names.size()) {
+      throw std::runtime_error("Invalid key in trace");
+    }
+    std::vector<DB::Field> key;
+    for (size_t f = 0; f < num_fields; ++f) {
+      key.emplace_back(names[f], static_cast<int64_t>(GetVarint(block, offset)));
+    }
+    size_t value_size = GetVarint(block, offset);
+    request.operations.emplace_back(table, std::move(key),
+                                    DB::TimestampValue(0, std::string(value_size, 'x')), operation);
+    DB::DB_Operation &op = request.operations.back();
+    if (operation == Operation::RANGEREAD || operation == Operation::TIMERANGEREAD) {
+      op.limit = GetVarint(block, offset);
+    }
+    if (operation == Operation::TIMERANGEREAD) {
+      op.min_timestamp = -static_cast<int64_t>(GetVarint(block, offset));
+    }
+  }
+}
+
+} // benchmark
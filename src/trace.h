@@ -0,0 +1,125 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db.h"
+
+namespace benchmark {
+
+///
+/// One request as a client thread issued it: a single operation or a
+/// transaction, and what the database answered.
+///
+/// As read back, operation times are relative to the request: values carry
+/// timestamp 0 and filler of the recorded length, and a TIMERANGEREAD has
+/// max_timestamp 0 and min_timestamp minus its window, or 0 if unbounded.
+///
+struct TraceRequest {
+  enum class Kind : uint8_t { kOperation, kReadTransaction, kWriteTransaction };
+
+  int64_t time_nanos = 0; // issue time, since the recording started
+  Kind kind = Kind::kOperation;
+  Status status = Status::kOK;
+  std::vector<DB::DB_Operation> operations;
+};
+
+///
+/// Writes the requests of a run to a binary trace file, for -replay.
+///
+/// Each recording thread appends to a buffer of its own, so recording takes
+/// no lock until the buffer fills and is written out as one block. A block is
+/// tagged with the id of its thread's stream; a stream's requests are in the
+/// order the thread issued them.
+///
+/// The file starts with the magic "TAOTRACE" and a version byte, followed by
+/// blocks of (stream id, payload length, payload), both as 4-byte
+/// little-endian integers. A payload is a run of requests, and every integer
+/// in it is a LEB128 varint:
+///   time since the stream's previous request, kind byte, status byte,
+///   number of operations, then per operation: operation byte, table byte,
+///   number of key fields, the key values, the value's length, and for
+///   RANGEREAD and TIMERANGEREAD the limit, and for TIMERANGEREAD the length
+///   of the time window (0 for unbounded).
+/// Values are not recorded, only their length, and the window is kept
+/// relative, so a replay writes current timestamps and reads recent edges.
+///
+class TraceRecorder {
+ public:
+  explicit TraceRecorder(std::string const &path);
+  ~TraceRecorder();
+
+  TraceRecorder(TraceRecorder const &) = delete;
+  TraceRecorder &operator=(TraceRecorder const &) = delete;
+
+  /// Records the @param num_operations operations of a request issued at
+  /// @param start_nanos (CurrentTimeNanos()) that finished with @param status.
+  void Record(TraceRequest::Kind kind, DB::DB_Operation const *operations,
+              size_t num_operations, Status status, int64_t start_nanos);
+
+  /// Writes out every thread's buffer. Threads that record afterwards start
+  /// new streams. Only call when no thread is recording.
+  void Flush();
+
+ private:
+  struct Stream {
+    uint32_t id;
+    int64_t last_time = 0;
+    std::string buffer;
+  };
+
+  Stream &ThisThreadStream();
+
+  void WriteBlock(Stream &stream);
+
+  int64_t const start_nanos_;
+  // tells a thread's cached stream apart from one of an earlier recorder or flush
+  uint64_t generation_;
+
+  std::mutex mutex_;
+  std::ofstream out_;
+  uint32_t next_stream_id_ = 0;
+  std::vector<std::unique_ptr<Stream>> streams_;
+};
+
+///
+/// Reads the requests of a trace written by TraceRecorder, in file order:
+/// each stream's requests in order, interleaved block by block.
+///
+class TraceReader {
+ public:
+  explicit TraceReader(std::string const &path);
+
+  /// Whether the file at @param path starts like a trace.
+  static bool IsTrace(std::string const &path);
+
+  /// Reads the next request and the stream it belongs to; false at the end.
+  bool Next(uint32_t &stream, TraceRequest &request);
+
+  /// Reads the next block of requests instead, to decode with DecodeRequest;
+  /// false at the end. Do not mix with Next.
+  bool NextBlock(uint32_t &stream, std::string &block);
+
+  /// Decodes the request at @param offset in @param block and moves offset
+  /// past it. Its time_nanos is since the previous request of its stream.
+  static void DecodeRequest(std::string const &block, size_t &offset, TraceRequest &request);
+
+ private:
+  bool ReadBlock();
+
+  std::ifstream in_;
+  uint32_t stream_ = 0;
+  std::string block_;
+  size_t offset_ = 0;
+  std::unordered_map<uint32_t, int64_t> last_time_;
+};
+
+} // benchmark
+
+#endif // TRACE_H_
@@ -0,0 +1,233 @@
+#include "trace_file_workload.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "constants.h"
+#include "timer.h"
+#include "utils.h"
+
+namespace benchmark {
+
+namespace {
+const std::string DEFAULT_QUEUE_DEPTH = "65536";
+// the reader's file buffer, so the trace is read in large sequential chunks
+const size_t READ_BUFFER_BYTES = 1 << 20;
+
+// whether this thread's last DoRequest found the trace at its end
+thread_local bool out_of_requests = false;
+} // namespace
+
+TraceFileWorkload::TraceFileWorkload(utils::Properties const &p)
+    : path_(p.GetProperty("trace.path"))
+    , jsonl_(TraceRowParser::IsJsonl(p, path_))
+    , loop_(p.GetProperty("trace.loop", "true") == "true")
+    , range_read_limit_(std::stoi(p.GetProperty("range_read_limit",
+                                                std::to_string(constants::RANGE_READ_LIMIT))))
+    , time_read_window_nanos_(std::stoll(p.GetProperty("time_read_window_seconds", "0")) * 1000000000)
+    , queue_depth_(std::stoul(p.GetProperty("trace.queue_depth", DEFAULT_QUEUE_DEPTH))) {
+  if (queue_depth_ == 0) {
+    throw std::invalid_argument("trace.queue_depth must be positive");
+  }
+
+  std::ifstream in(path_);
+  if (!in) {
+    throw std::invalid_argument("Cannot open trace " + path_);
+  }
+  if (!jsonl_) {
+    std::getline(in, header_);
+    // fail here rather than on the reader thread
+    TraceRowParser(jsonl_, header_, range_read_limit_);
+  }
+  reader_ = std::thread(&TraceFileWorkload::ReadTrace, this);
+}
+
+TraceFileWorkload::~TraceFileWorkload() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  space_cv_.notify_all();
+  reader_.join();
+  std::unordered_set<Pending *> pending;
+  for (auto const &[id, queue] : by_id_) {
+    pending.insert(queue.begin(), queue.end());
+  }
+  for (Pending *request : pending) {
+    delete request;
+  }
+}
+
+bool TraceFileWorkload::Push(Request &request) {
+  auto pending = std::make_unique<Pending>();
+  for (DB::DB_Operation const &op : request.operations) {
+    pending->ids.push_back(op.key[0].value);
+    if (op.table == DataTable::Edges && op.key.size() == 3) {
+      pending->ids.push_back(op.key[1].value);
+    }
+  }
+  std::sort(pending->ids.begin(), pending->ids.end());
+  pending->ids.erase(std::unique(pending->ids.begin(), pending->ids.end()), pending->ids.end());
+  pending->request = std::move(request);
+  request = Request();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  space_cv_.wait(lock, [this] { return num_pending_ < queue_depth_ || stop_; });
+  if (stop_) {
+    return false;
+  }
+  for (int64_t id : pending->ids) {
+    std::deque<Pending *> &queue = by_id_[id];
+    pending->num_blocked_ids += !queue.empty();
+    queue.push_back(pending.get());
+  }
+  ++num_pending_;
+  if (pending->num_blocked_ids == 0) {
+    ready_.push_back(pending.get());
+    ready_cv_.notify_one();
+  }
+  pending.release();
+  return true;
+}
+
+void TraceFileWorkload::ReadTrace() {
+  std::vector<char> buffer(READ_BUFFER_BYTES);
+  TraceRowParser parser(jsonl_, header_, range_read_limit_);
+  bool first_pass = true;
+  do {
+    std::ifstream in;
+    in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    in.open(path_);
+    std::string line;
+    size_t line_number = 0;
+    if (!jsonl_) {
+      std::getline(in, line);
+      ++line_number;
+    }
+    int64_t num_requests = 0;
+    Request request;
+    std::string txn; // of the transaction in request
+    while (!stop_.load(std::memory_order_relaxed) && std::getline(in, line)) {
+      ++line_number;
+      try {
+        std::string row_txn;
+        std::optional<DB::DB_Operation> op = parser.Parse(line, row_txn);
+        if (!op) {
+          continue;
+        }
+        if (!request.operations.empty() && (row_txn.empty() || row_txn != txn)) {
+          if (!Push(request)) {
+            return;
+          }
+          ++num_requests;
+        }
+        txn = std::move(row_txn);
+        request.is_transaction = !txn.empty();
+        request.read_only = request.read_only && IsReadOperation(op->operation);
+        request.operations.push_back(std::move(*op));
+      } catch (std::exception const &e) {
+        if (first_pass) {
+          std::cerr << "Skipping line " << line_number << " of " << path_ << ": " << e.what()
+                    << std::endl;
+        }
+      }
+    }
+    if (!request.operations.empty()) {
+      if (!Push(request)) {
+        return;
+      }
+      ++num_requests;
+    }
+    if (num_requests == 0) {
+      break;
+    }
+    first_pass = false;
+  } while (loop_ && !stop_.load(std::memory_order_relaxed));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  ready_cv_.notify_all();
+}
+
+Status TraceFileWorkload::Execute(DB &db, Request &request) {
+  int64_t now = utils::CurrentTimeNanos();
+  for (auto &op : request.operations) {
+    op.time_and_value.timestamp = now;
+    if (op.operation == Operation::TIMERANGEREAD) {
+      // a window of 0 reaches back to the first edge
+      op.max_timestamp = now;
+      op.min_timestamp = time_read_window_nanos_ > 0 ? now - time_read_window_nanos_ : 0;
+    }
+  }
+  std::vector<DB::TimestampValue> read_buffer;
+  int64_t backoff_limit = constants::INITIAL_BACKOFF_LIMIT_MICROS;
+  while (true) {
+    Status s = request.is_transaction
+        ? db.ExecuteTransaction(request.operations, read_buffer, request.read_only)
+        : db.Execute(request.operations[0], read_buffer);
+    if (s != Status::kContentionError) {
+      return s;
+    }
+    read_buffer.clear();
+    std::uniform_int_distribution<> unif(0, backoff_limit);
+    std::this_thread::sleep_for(std::chrono::microseconds(unif(rnd::gen)));
+    backoff_limit = std::max(backoff_limit * 2, backoff_limit); // don't overflow
+  }
+}
+
+void TraceFileWorkload::Finish(Pending *pending) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int64_t id : pending->ids) {
+      auto queue = by_id_.find(id);
+      queue->second.pop_front();
+      if (queue->second.empty()) {
+        by_id_.erase(queue);
+      } else if (--queue->second.front()->num_blocked_ids == 0) {
+        ready_.push_back(queue->second.front());
+        ready_cv_.notify_one();
+      }
+    }
+    --num_pending_;
+    if (done_ && num_pending_ == 0) {
+      ready_cv_.notify_all();
+    }
+  }
+  space_cv_.notify_one();
+  delete pending;
+}
+
+bool TraceFileWorkload::DoRequest(DB &db) {
+  Pending *pending;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait(lock, [this] { return !ready_.empty() || (done_ && num_pending_ == 0); });
+    out_of_requests = ready_.empty();
+    if (out_of_requests) {
+      if (!exhausted_reported_) {
+        exhausted_reported_ = true;
+        std::cout << "Reached the end of trace " << path_ << std::endl;
+      }
+      return false;
+    }
+    pending = ready_.front();
+    ready_.pop_front();
+  }
+  Status s = Execute(db, pending->request);
+  Finish(pending);
+  return s == Status::kOK;
+}
+
+bool TraceFileWorkload::Exhausted() const {
+  return out_of_requests;
+}
+
+} // benchmark
@@ -0,0 +1,104 @@
+#ifndef TRACE_FILE_WORKLOAD_H_
+#define TRACE_FILE_WORKLOAD_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "db.h"
+#include "properties.h"
+#include "trace_row_parser.h"
+#include "workload.h"
+
+namespace benchmark {
+
+///
+/// Drives the run phase from a request trace on disk instead of the config's
+/// distributions (trace.path). The trace is CSV with a header row, or JSON
+/// Lines when the file name ends in .jsonl (or trace.format=jsonl), with the
+/// fields:
+///   op          an operation type of the config, e.g. obj_read, edge_add,
+///               edge_range_read (required)
+///   id1         the object id, or the edge's id1 (required)
+///   id2, type   the edge's id2 and type (default 0)
+///   txn         consecutive requests with the same non-empty txn form one
+///               transaction, read-only if all of them are reads
+///   value_size  bytes written by inserts and updates (default 150)
+///   limit       edges returned by range and time-range reads
+///               (default range_read_limit)
+///
+/// A reader thread parses the file up to trace.queue_depth requests ahead of
+/// the client threads. A request waits until every earlier request that shares
+/// one of its ids (each operation's id1, and an edge's id2) has finished, so
+/// requests on the same object run one at a time in trace order while requests
+/// on other objects run in parallel. Client threads with nothing to run wait
+/// for the next request to become ready. The trace starts over at its end
+/// unless trace.loop=false, after which the client threads stop.
+///
+class TraceFileWorkload : public Workload {
+ public:
+  explicit TraceFileWorkload(utils::Properties const &p);
+  ~TraceFileWorkload();
+
+  void Init(DB &db) override {}
+
+  bool DoRequest(DB &db) override;
+
+  bool Exhausted() const override;
+
+ private:
+  struct Request {
+    std::vector<DB::DB_Operation> operations;
+    bool is_transaction = false;
+    bool read_only = true;
+  };
+
+  // A request read ahead of the client threads.
+  struct Pending {
+    Request request;
+    std::vector<int64_t> ids; // sorted and distinct
+    // the ids that earlier requests are still pending on
+    int num_blocked_ids = 0;
+  };
+
+  void ReadTrace();
+
+  bool Push(Request &request);
+
+  Status Execute(DB &db, Request &request);
+
+  // Lets the requests that waited for pending run, and deletes it.
+  void Finish(Pending *pending);
+
+  std::string const path_;
+  bool const jsonl_;
+  bool const loop_;
+  int const range_read_limit_;
+  int64_t const time_read_window_nanos_;
+  std::string header_; // of a CSV trace
+
+  size_t const queue_depth_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_cv_; // client threads wait for ready_ or the trace's end
+  std::condition_variable space_cv_; // the reader waits for fewer than queue_depth_ pending
+  // the pending requests on each id, in trace order, of which the first is
+  // ready or running; a request is pending from Push until Finish deletes it
+  std::unordered_map<int64_t, std::deque<Pending *>> by_id_;
+  std::deque<Pending *> ready_;
+  size_t num_pending_ = 0;
+  bool done_ = false; // the reader has pushed its last request
+  bool exhausted_reported_ = false;
+  std::atomic<bool> stop_{false};
+  std::thread reader_;
+};
+
+} // benchmark
+
+#endif // TRACE_FILE_WORKLOAD_H_
@@ -0,0 +1,195 @@
+#include "trace_row_parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "constants.h"
+#include "utils.h"
+
+namespace benchmark {
+
+namespace {
+const std::unordered_map<std::string, int> FIELD_NAMES = {
+  {"op", 0}, {"id1", 1}, {"id2", 2}, {"type", 3}, {"txn", 4}, {"value_size", 5}, {"limit", 6},
+};
+
+struct OperationType {
+  std::string name;
+  DataTable table;
+  Operation operation;
+};
+
+const std::vector<OperationType> OPERATION_TYPES = {
+  {"obj_read", DataTable::Objects, Operation::READ},
+  {"obj_add", DataTable::Objects, Operation::INSERT},
+  {"obj_update", DataTable::Objects, Operation::UPDATE},
+  {"obj_delete", DataTable::Objects, Operation::DELETE},
+  {"edge_point_read", DataTable::Edges, Operation::READ},
+  {"edge_range_read", DataTable::Edges, Operation::RANGEREAD},
+  {"edge_count_read", DataTable::Edges, Operation::COUNTREAD},
+  {"edge_time_read", DataTable::Edges, Operation::TIMERANGEREAD},
+  {"edge_add", DataTable::Edges, Operation::INSERT},
+  {"edge_update", DataTable::Edges, Operation::UPDATE},
+  {"edge_delete", DataTable::Edges, Operation::DELETE},
+};
+
+inline bool EndsWith(std::string const &s, std::string const &suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+inline int64_t ToInt(std::string const &s, int64_t default_value) {
+  return s.empty() ? default_value : std::stoll(s);
+}
+} // namespace
+
+bool TraceRowParser::IsJsonl(utils::Properties const &p, std::string const &path) {
+  return p.GetProperty("trace.format", EndsWith(path, ".jsonl") ? "jsonl" : "csv") == "jsonl";
+}
+
+TraceRowParser::TraceRowParser(bool jsonl, std::string const &header, int range_read_limit)
+    : jsonl_(jsonl)
+    , range_read_limit_(range_read_limit)
+    , row_(kNumFields) {
+  if (jsonl_) {
+    return;
+  }
+  std::istringstream columns(header);
+  bool has_op = false, has_id1 = false;
+  for (std::string column; std::getline(columns, column, ','); ) {
+    auto field = FIELD_NAMES.find(utils::Trim(column));
+    columns_.push_back(field == FIELD_NAMES.end() ? kNumFields : static_cast<Field>(field->second));
+    has_op |= columns_.back() == kOp;
+    has_id1 |= columns_.back() == kId1;
+  }
+  if (!has_op || !has_id1) {
+    throw std::invalid_argument("trace needs op and id1 columns");
+  }
+}
+
+// Fills row_ from a flat JSON object of strings and numbers.
+void TraceRowParser::SplitJson(std::string const &line) {
+  size_t i = line.find('{');
+  if (i == std::string::npos) {
+    throw std::invalid_argument("expected a JSON object");
+  }
+  auto skip_space = [&] {
+    while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) {
+      ++i;
+    }
+  };
+  auto read_string = [&] {
+    size_t end = line.find('"', ++i);
+    if (end == std::string::npos) {
+      throw std::invalid_argument("unterminated string");
+    }
+    std::string s = line.substr(i, end - i);
+    i = end + 1;
+    return s;
+  };
+  ++i;
+  while (true) {
+    skip_space();
+    if (i < line.size() && line[i] == '}') {
+      return;
+    }
+    if (i >= line.size() || line[i] != '"') {
+      throw std::invalid_argument("expected a field name");
+    }
+    std::string name = read_string();
+    skip_space();
+    if (i >= line.size() || line[i++] != ':') {
+      throw std::invalid_argument("expected ':' after " + name);
+    }
+    skip_space();
+    std::string value;
+    if (i < line.size() && line[i] == '"') {
+      value = read_string();
+    } else {
+      size_t end = line.find_first_of(",}", i);
+      if (end == std::string::npos) {
+        throw std::invalid_argument("unterminated object");
+      }
+      value = utils::Trim(line.substr(i, end - i));
+      i = end;
+    }
+    auto field = FIELD_NAMES.find(name);
+    if (field != FIELD_NAMES.end()) {
+      row_[field->second] = std::move(value);
+    }
+    skip_space();
+    if (i < line.size() && line[i] == ',') {
+      ++i;
+    }
+  }
+}
+
+std::optional<DB::DB_Operation> TraceRowParser::Parse(std::string const &line, std::string &txn) {
+  for (auto &field : row_) {
+    field.clear();
+  }
+  if (utils::Trim(line).empty()) {
+    return std::nullopt;
+  }
+  if (jsonl_) {
+    SplitJson(line);
+  } else {
+    size_t start = 0;
+    for (size_t column = 0; column < columns_.size() && start <= line.size(); ++column) {
+      size_t end = std::min(line.find(',', start), line.size());
+      if (columns_[column] != kNumFields) {
+        row_[columns_[column]] = utils::Trim(line.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+  }
+
+  auto type = std::find_if(OPERATION_TYPES.begin(), OPERATION_TYPES.end(),
+                           [this](OperationType const &t) { return t.name == row_[kOp]; });
+  if (type == OPERATION_TYPES.end()) {
+    throw std::invalid_argument("unknown op '" + row_[kOp] + "'");
+  }
+  if (row_[kId1].empty()) {
+    throw std::invalid_argument("missing id1");
+  }
+  DataTable table = type->table;
+  Operation operation = type->operation;
+  int64_t id1 = std::stoll(row_[kId1]);
+  int64_t id2 = ToInt(row_[kId2], 0);
+  int64_t edge_type = ToInt(row_[kType], 0);
+  std::string value;
+  if (operation == Operation::INSERT || operation == Operation::UPDATE) {
+    value.assign(ToInt(row_[kValueSize], constants::VALUE_SIZE_BYTES), 'x');
+  }
+
+  std::vector<DB::Field> key;
+  if (table == DataTable::Objects) {
+    key = {{"id", id1}};
+  } else if (operation == Operation::RANGEREAD) {
+    key = {{"id1", id1}};
+  } else if (operation == Operation::COUNTREAD || operation == Operation::TIMERANGEREAD) {
+    key = {{"id1", id1}, {"type", edge_type}};
+  } else {
+    key = {{"id1", id1}, {"id2", id2}, {"type", edge_type}};
+  }
+  DB::DB_Operation op{table, std::move(key), {0L, std::move(value)}, operation};
+  if (operation == Operation::RANGEREAD || operation == Operation::TIMERANGEREAD) {
+    op.limit = ToInt(row_[kLimit], range_read_limit_);
+  }
+  txn = std::move(row_[kTxn]);
+  return op;
+}
+
+std::string const &TraceRowParser::OperationTypeName(DB::DB_Operation const &op) {
+  for (auto const &type : OPERATION_TYPES) {
+    if (type.table == op.table && type.operation == op.operation) {
+      return type.name;
+    }
+  }
+  throw std::invalid_argument("Operation has no operation type");
+}
+
+} // benchmark
@@ -0,0 +1,58 @@
+#ifndef TRACE_ROW_PARSER_H_
+#define TRACE_ROW_PARSER_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "db.h"
+#include "properties.h"
+
+namespace benchmark {
+
+/// Whether a trace operation of type @param op only reads.
+inline bool IsReadOperation(Operation op) {
+  return op == Operation::READ || op == Operation::RANGEREAD || op == Operation::COUNTREAD
+      || op == Operation::TIMERANGEREAD;
+}
+
+///
+/// Parses the rows of a CSV or JSON Lines request trace, the format read by
+/// TraceFileWorkload: one operation per row, named by its operation type in
+/// the config (obj_read, edge_add, ...), with optional transaction ids.
+///
+class TraceRowParser {
+ public:
+  /// Whether the trace at @param path is JSON Lines rather than CSV, by its
+  /// name unless the trace.format property says.
+  static bool IsJsonl(utils::Properties const &p, std::string const &path);
+
+  /// For CSV, @param header is the trace's first line, which must name the
+  /// op and id1 columns; throws std::invalid_argument otherwise.
+  /// @param range_read_limit is the limit of range reads without one.
+  TraceRowParser(bool jsonl, std::string const &header, int range_read_limit);
+
+  /// Parses @param line, setting @param txn to its transaction id, or empty
+  /// if it is a request of its own. Empty for a blank line; throws
+  /// std::invalid_argument for an invalid one. Operations carry timestamp 0.
+  std::optional<DB::DB_Operation> Parse(std::string const &line, std::string &txn);
+
+  /// The config's name for the operation type of @param op, as in the op field.
+  static std::string const &OperationTypeName(DB::DB_Operation const &op);
+
+ private:
+  // Indexes of the trace's fields in row_.
+  enum Field { kOp, kId1, kId2, kType, kTxn, kValueSize, kLimit, kNumFields };
+
+  void SplitJson(std::string const &line);
+
+  bool const jsonl_;
+  int const range_read_limit_;
+  // the field in each CSV column, or kNumFields if unused
+  std::vector<Field> columns_;
+  std::vector<std::string> row_;
+};
+
+} // benchmark
+
+#endif // TRACE_ROW_PARSER_H_
@@ -0,0 +1,982 @@
+#include "wire_stub.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <map>
+
+#include "utils.h"
+
+namespace {
+const std::string PORT = "stub.port";
+const std::string DELAY_US = "stub.delay_us";
+const std::string ROWS = "stub.rows";
+const std::string VALUE_SIZE = "stub.value_size";
+
+inline int64_t ThreadCpuNanos() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Byte stream over a socket: buffered reads, and replies collected in out
+// until Flush, so a reply of many messages goes out in one write.
+class Connection {
+ public:
+  explicit Connection(int fd) : fd_(fd) {}
+
+  bool Read(char *data, size_t n) {
+    while (n > 0) {
+      if (begin_ == end_) {
+        ssize_t got = recv(fd_, buffer_, sizeof(buffer_), 0);
+        if (got <= 0) {
+          if (got < 0 && errno == EINTR) {
+            continue;
+          }
+          return false;
+        }
+        begin_ = 0;
+        end_ = got;
+      }
+      size_t chunk = std::min(n, end_ - begin_);
+      memcpy(data, buffer_ + begin_, chunk);
+      begin_ += chunk;
+      data += chunk;
+      n -= chunk;
+    }
+    return true;
+  }
+
+  bool Read(std::string &data, size_t n) {
+    data.resize(n);
+    return Read(&data[0], n);
+  }
+
+  bool Flush() {
+    size_t sent = 0;
+    while (sent < out.size()) {
+      ssize_t n = send(fd_, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      sent += n;
+    }
+    out.clear();
+    return true;
+  }
+
+  std::string out;
+
+ private:
+  int fd_;
+  char buffer_[16384];
+  size_t begin_ = 0;
+  size_t end_ = 0;
+};
+
+// The canned reply, shared by both protocols.
+struct Canned {
+  int64_t delay_us;
+  int rows;
+  std::string const &value;
+
+  void Delay() const {
+    if (delay_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    }
+  }
+};
+
+// What the stub needs to know about a statement to answer it.
+struct Statement {
+  enum Kind { kSelect, kBegin, kCommit, kRollback, kInsert, kUpdate, kDelete, kOther };
+
+  Kind kind = kOther;
+  std::string verb;                 // first keyword, upper-cased
+  std::vector<std::string> columns; // output columns of a SELECT
+  int params = 0;                   // number of ? or $n placeholders
+};
+
+inline bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Calls f(i, depth) for each character of sql outside quotes, where depth is
+// the parenthesis depth; stops early if f returns false.
+template <typename F>
+void ForEachUnquoted(std::string const &sql, F f) {
+  char quote = 0;
+  int depth = 0;
+  for (size_t i = 0; i < sql.size(); ++i) {
+    char c = sql[i];
+    if (quote) {
+      if (c == quote) {
+        quote = 0;
+      }
+      continue;
+    }
+    if (c == '\'' || c == '"' || c == '`') {
+      quote = c;
+      continue;
+    }
+    if (c == '(') {
+      ++depth;
+    } else if (c == ')') {
+      --depth;
+    }
+    if (!f(i, depth)) {
+      return;
+    }
+  }
+}
+
+// Splits sql into its semicolon-separated statements, dropping empty ones.
+std::vector<std::string> SplitStatements(std::string const &sql) {
+  std::vector<std::string> statements;
+  size_t start = 0;
+  auto add = [&](size_t end) {
+    std::string statement = benchmark::utils::Trim(sql.substr(start, end - start));
+    if (!statement.empty()) {
+      statements.push_back(statement);
+    }
+    start = end + 1;
+  };
+  ForEachUnquoted(sql, [&](size_t i, int) {
+    if (sql[i] == ';') {
+      add(i);
+    }
+    return true;
+  });
+  add(sql.size());
+  return statements;
+}
+
+// Name of a select-list item: the alias, or the column without its table.
+std::string ColumnName(std::string item) {
+  item = benchmark::utils::Trim(item);
+  size_t end = item.size();
+  while (end > 0 && !IsIdentifierChar(item[end - 1]) && item[end - 1] != '?') {
+    --end;
+  }
+  size_t begin = end;
+  while (begin > 0 && (IsIdentifierChar(item[begin - 1]) || item[begin - 1] == '?')) {
+    --begin;
+  }
+  return begin == end ? "?column?" : item.substr(begin, end - begin);
+}
+
+Statement Analyze(std::string const &sql) {
+  Statement statement;
+  size_t i = 0;
+  while (i < sql.size() && !IsIdentifierChar(sql[i])) {
+    ++i;
+  }
+  size_t verb_end = i;
+  while (verb_end < sql.size() && IsIdentifierChar(sql[verb_end])) {
+    statement.verb.push_back(std::toupper(static_cast<unsigned char>(sql[verb_end++])));
+  }
+  std::string const &verb = statement.verb;
+  if (verb == "SELECT") {
+    statement.kind = Statement::kSelect;
+  } else if (verb == "BEGIN" || verb == "START") {
+    statement.kind = Statement::kBegin;
+  } else if (verb == "COMMIT" || verb == "END") {
+    statement.kind = Statement::kCommit;
+  } else if (verb == "ROLLBACK" || verb == "ABORT") {
+    statement.kind = Statement::kRollback;
+  } else if (verb == "INSERT" || verb == "UPSERT" || verb == "REPLACE") {
+    statement.kind = Statement::kInsert;
+  } else if (verb == "UPDATE") {
+    statement.kind = Statement::kUpdate;
+  } else if (verb == "DELETE") {
+    statement.kind = Statement::kDelete;
+  }
+
+  int max_dollar = 0;
+  int question_marks = 0;
+  size_t from = std::string::npos;
+  std::vector<size_t> commas;
+  ForEachUnquoted(sql, [&](size_t j, int depth) {
+    char c = sql[j];
+    if (c == '?') {
+      ++question_marks;
+    } else if (c == '$') {
+      max_dollar = std::max(max_dollar, std::atoi(sql.c_str() + j + 1));
+    } else if (depth == 0 && j >= verb_end && from == std::string::npos) {
+      if (c == ',') {
+        commas.push_back(j);
+      } else if ((c == 'F' || c == 'f') && (j == 0 || !IsIdentifierChar(sql[j - 1])) &&
+                 strncasecmp(sql.c_str() + j, "FROM", 4) == 0 &&
+                 (j + 4 == sql.size() || !IsIdentifierChar(sql[j + 4]))) {
+        from = j;
+      }
+    }
+    return true;
+  });
+  statement.params = std::max(max_dollar, question_marks);
+
+  if (statement.kind == Statement::kSelect) {
+    size_t end = std::min(from, sql.size());
+    size_t start = verb_end;
+    for (size_t comma : commas) {
+      if (comma > end) {
+        break;
+      }
+      statement.columns.push_back(ColumnName(sql.substr(start, comma - start)));
+      start = comma + 1;
+    }
+    statement.columns.push_back(ColumnName(sql.substr(start, end - start)));
+  }
+  return statement;
+}
+
+inline bool IsTextColumn(std::string const &name) {
+  return strcasecmp(name.c_str(), "value") == 0;
+}
+
+inline void AppendBE16(std::string &out, uint16_t v) {
+  out.push_back(static_cast<char>(v >> 8));
+  out.push_back(static_cast<char>(v));
+}
+
+inline void AppendBE32(std::string &out, uint32_t v) {
+  AppendBE16(out, v >> 16);
+  AppendBE16(out, v);
+}
+
+inline uint32_t ReadBE32(char const *p) {
+  auto b = reinterpret_cast<unsigned char const *>(p);
+  return (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | b[3];
+}
+
+inline void AppendLE(std::string &out, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<char>(v >> (8 * i)));
+  }
+}
+
+inline uint32_t ReadLE(char const *p, int bytes) {
+  auto b = reinterpret_cast<unsigned char const *>(p);
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; --i) {
+    v = (v << 8) | b[i];
+  }
+  return v;
+}
+
+///
+/// PostgreSQL frontend/backend protocol 3.0: trust authentication, simple
+/// queries, and the extended protocol (Parse, Bind, Describe, Execute, Sync)
+/// that libpq uses for prepared statements. All results are in text format.
+///
+class PostgresSession {
+ public:
+  PostgresSession(Connection &conn, Canned const &canned) : conn_(conn), canned_(canned) {}
+
+  bool Start() {
+    std::string body;
+    while (true) {
+      char header[4];
+      if (!conn_.Read(header, 4)) {
+        return false;
+      }
+      uint32_t length = ReadBE32(header);
+      if (length < 8 || length > 10000 || !conn_.Read(body, length - 4)) {
+        return false;
+      }
+      uint32_t code = ReadBE32(body.data());
+      if (code == kSslRequest || code == kGssEncRequest) {
+        conn_.out = "N"; // no encryption; the client goes on in plain text
+        if (!conn_.Flush()) {
+          return false;
+        }
+        continue;
+      }
+      if (code != kProtocol3) {
+        return false; // cancel requests and older protocols
+      }
+      break;
+    }
+    Begin('R');
+    AppendBE32(out(), 0); // AuthenticationOk
+    End();
+    ParameterStatus("server_version", "13.0");
+    ParameterStatus("server_encoding", "UTF8");
+    ParameterStatus("client_encoding", "UTF8");
+    ParameterStatus("DateStyle", "ISO, MDY");
+    ParameterStatus("integer_datetimes", "on");
+    ParameterStatus("standard_conforming_strings", "on");
+    Begin('K');
+    AppendBE32(out(), static_cast<uint32_t>(getpid()));
+    AppendBE32(out(), 0);
+    End();
+    ReadyForQuery();
+    return conn_.Flush();
+  }
+
+  bool Step() {
+    char header[5];
+    std::string body;
+    if (!conn_.Read(header, 5) || !conn_.Read(body, ReadBE32(header + 1) - 4)) {
+      return false;
+    }
+    char type = header[0];
+    if (type == 'X') {
+      return false;
+    }
+    if (skip_until_sync_ && type != 'S') {
+      return true;
+    }
+    size_t pos = 0;
+    auto cstring = [&]() {
+      std::string s(body.c_str() + pos);
+      pos += s.size() + 1;
+      return s;
+    };
+    switch (type) {
+    case 'Q': {
+      canned_.Delay();
+      std::vector<std::string> sql = SplitStatements(cstring());
+      if (sql.empty()) {
+        Begin('I'); // EmptyQueryResponse
+        End();
+      }
+      for (auto const &text : sql) {
+        Statement statement = Analyze(text);
+        RowDescription(statement);
+        Rows(statement);
+      }
+      ReadyForQuery();
+      return conn_.Flush();
+    }
+    case 'P': {
+      std::string name = cstring();
+      statements_[name] = Analyze(cstring());
+      Begin('1'); // ParseComplete
+      End();
+      return true;
+    }
+    case 'B': {
+      std::string portal = cstring();
+      std::string name = cstring();
+      if (statements_.count(name) == 0) {
+        return Error("prepared statement \"" + name + "\" does not exist");
+      }
+      portals_[portal] = name;
+      Begin('2'); // BindComplete
+      End();
+      return true;
+    }
+    case 'D': {
+      char kind = body[pos++];
+      Statement const *statement = Find(kind, cstring());
+      if (statement == nullptr) {
+        return Error("unknown statement or portal");
+      }
+      if (kind == 'S') {
+        Begin('t'); // ParameterDescription
+        AppendBE16(out(), statement->params);
+        for (int i = 0; i < statement->params; ++i) {
+          AppendBE32(out(), kTextOid);
+        }
+        End();
+      }
+      RowDescription(*statement);
+      return true;
+    }
+    case 'E': {
+      Statement const *statement = Find('P', cstring());
+      if (statement == nullptr) {
+        return Error("portal does not exist");
+      }
+      canned_.Delay();
+      Rows(*statement);
+      return true;
+    }
+    case 'C':
+      Begin('3'); // CloseComplete
+      End();
+      return true;
+    case 'S':
+      skip_until_sync_ = false;
+      ReadyForQuery();
+      return conn_.Flush();
+    case 'H':
+      return conn_.Flush();
+    default:
+      return Error(std::string("unsupported message type ") + type);
+    }
+  }
+
+ private:
+  static constexpr uint32_t kProtocol3 = 196608;
+  static constexpr uint32_t kSslRequest = 80877103;
+  static constexpr uint32_t kGssEncRequest = 80877104;
+  static constexpr uint32_t kInt8Oid = 20;
+  static constexpr uint32_t kTextOid = 25;
+
+  std::string &out() {
+    return conn_.out;
+  }
+
+  void Begin(char type) {
+    out().push_back(type);
+    start_ = out().size();
+    out().append(4, '\0');
+  }
+
+  void End() {
+    uint32_t length = out().size() - start_;
+    for (int i = 0; i < 4; ++i) {
+      out()[start_ + i] = static_cast<char>(length >> (24 - 8 * i));
+    }
+  }
+
+  void ParameterStatus(char const *name, char const *value) {
+    Begin('S');
+    out().append(name).push_back('\0');
+    out().append(value).push_back('\0');
+    End();
+  }
+
+  void ReadyForQuery() {
+    Begin('Z');
+    out().push_back(transaction_status_);
+    End();
+  }
+
+  Statement const *Find(char kind, std::string const &name) const {
+    if (kind == 'P') {
+      auto portal = portals_.find(name);
+      if (portal == portals_.end()) {
+        return nullptr;
+      }
+      return &statements_.at(portal->second);
+    }
+    auto statement = statements_.find(name);
+    return statement == statements_.end() ? nullptr : &statement->second;
+  }
+
+  void RowDescription(Statement const &statement) {
+    if (statement.kind != Statement::kSelect) {
+      Begin('n'); // NoData
+      End();
+      return;
+    }
+    Begin('T');
+    AppendBE16(out(), statement.columns.size());
+    for (auto const &column : statement.columns) {
+      bool text = IsTextColumn(column);
+      out().append(column).push_back('\0');
+      AppendBE32(out(), 0); // table
+      AppendBE16(out(), 0); // attribute number
+      AppendBE32(out(), text ? kTextOid : kInt8Oid);
+      AppendBE16(out(), text ? 0xffff : 8);
+      AppendBE32(out(), 0xffffffff); // type modifier
+      AppendBE16(out(), 0);          // text format
+    }
+    End();
+  }
+
+  // The result rows, if any, and CommandComplete.
+  void Rows(Statement const &statement) {
+    std::string tag;
+    switch (statement.kind) {
+    case Statement::kSelect:
+      for (int row = 0; row < canned_.rows; ++row) {
+        Begin('D');
+        AppendBE16(out(), statement.columns.size());
+        for (auto const &column : statement.columns) {
+          std::string const &value = IsTextColumn(column) ? canned_.value : kInteger;
+          AppendBE32(out(), value.size());
+          out().append(value);
+        }
+        End();
+      }
+      tag = "SELECT " + std::to_string(canned_.rows);
+      break;
+    case Statement::kInsert:
+      tag = "INSERT 0 1";
+      break;
+    case Statement::kUpdate:
+    case Statement::kDelete:
+      tag = statement.verb + " 1";
+      break;
+    case Statement::kBegin:
+      transaction_status_ = 'T';
+      tag = "BEGIN";
+      break;
+    case Statement::kCommit:
+    case Statement::kRollback:
+      transaction_status_ = 'I';
+      tag = statement.kind == Statement::kCommit ? "COMMIT" : "ROLLBACK";
+      break;
+    default:
+      tag = statement.verb;
+    }
+    Begin('C');
+    out().append(tag).push_back('\0');
+    End();
+  }
+
+  // Reports an error; the extended protocol then skips messages up to Sync.
+  bool Error(std::string const &message) {
+    Begin('E');
+    out().append("SERROR").push_back('\0');
+    out().append("C0A000").push_back('\0');
+    out().append("M" + message).push_back('\0');
+    out().push_back('\0');
+    End();
+    skip_until_sync_ = true;
+    return true;
+  }
+
+  const std::string kInteger = "1";
+
+  Connection &conn_;
+  Canned const &canned_;
+  size_t start_ = 0;
+  char transaction_status_ = 'I';
+  bool skip_until_sync_ = false;
+  std::map<std::string, Statement> statements_;
+  std::map<std::string, std::string> portals_;
+};
+
+///
+/// MySQL client/server protocol 4.1: any login succeeds, COM_QUERY returns
+/// text result sets (one per statement of a multi-statement query), and
+/// COM_STMT_PREPARE / COM_STMT_EXECUTE return binary result sets. Integer
+/// columns are BIGINT and value is VARCHAR.
+///
+class MySqlSession {
+ public:
+  MySqlSession(Connection &conn, Canned const &canned) : conn_(conn), canned_(canned) {}
+
+  bool Start() {
+    std::string greeting;
+    greeting.push_back(10); // protocol version
+    greeting.append("8.0.0-taobench-stub").push_back('\0');
+    AppendLE(greeting, static_cast<uint32_t>(getpid()), 4); // connection id
+    greeting.append("abcdefgh").push_back('\0');            // scramble, part 1
+    AppendLE(greeting, kCapabilities & 0xffff, 2);
+    greeting.push_back(kUtf8);
+    AppendLE(greeting, Status(), 2);
+    AppendLE(greeting, kCapabilities >> 16, 2);
+    greeting.push_back(21); // scramble length
+    greeting.append(10, '\0');
+    greeting.append("ijklmnopqrst").push_back('\0'); // scramble, part 2
+    greeting.append("mysql_native_password").push_back('\0');
+    sequence_ = 0;
+    Send(greeting);
+    if (!conn_.Flush()) {
+      return false;
+    }
+    std::string response;
+    if (!ReadPacket(response)) {
+      return false;
+    }
+    // the credentials are not checked
+    Ok(0);
+    return conn_.Flush();
+  }
+
+  bool Step() {
+    std::string packet;
+    if (!ReadPacket(packet) || packet.empty()) {
+      return false;
+    }
+    switch (static_cast<unsigned char>(packet[0])) {
+    case kQuit:
+      return false;
+    case kQuery: {
+      canned_.Delay();
+      std::vector<std::string> sql = SplitStatements(packet.substr(1));
+      if (sql.empty()) {
+        Error(1065, "Query was empty");
+      }
+      for (size_t i = 0; i < sql.size(); ++i) {
+        Respond(Analyze(sql[i]), false, i + 1 < sql.size() ? kMoreResultsExist : 0);
+      }
+      break;
+    }
+    case kStmtPrepare: {
+      uint32_t id = next_statement_id_++;
+      Statement &statement = statements_[id] = Analyze(packet.substr(1));
+      std::string ok;
+      ok.push_back(0);
+      AppendLE(ok, id, 4);
+      AppendLE(ok, statement.columns.size(), 2);
+      AppendLE(ok, statement.params, 2);
+      ok.push_back(0);
+      AppendLE(ok, 0, 2); // warnings
+      Send(ok);
+      if (statement.params > 0) {
+        for (int i = 0; i < statement.params; ++i) {
+          ColumnDefinition("?", false);
+        }
+        Eof(0);
+      }
+      if (!statement.columns.empty()) {
+        for (auto const &column : statement.columns) {
+          ColumnDefinition(column, !IsTextColumn(column));
+        }
+        Eof(0);
+      }
+      break;
+    }
+    case kStmtExecute: {
+      auto statement = packet.size() >= 5 ? statements_.find(ReadLE(packet.data() + 1, 4))
+                                          : statements_.end();
+      if (statement == statements_.end()) {
+        Error(1243, "Unknown prepared statement handler");
+        break;
+      }
+      canned_.Delay();
+      Respond(statement->second, true, 0);
+      break;
+    }
+    case kStmtClose:
+      if (packet.size() >= 5) {
+        statements_.erase(ReadLE(packet.data() + 1, 4));
+      }
+      return true; // no reply
+    case kStmtSendLongData:
+      return true; // no reply
+    case kSetOption:
+      Eof(0);
+      break;
+    case kInitDb:
+    case kPing:
+    case kStmtReset:
+    case kResetConnection:
+      Ok(0);
+      break;
+    default:
+      Error(1047, "Unknown command");
+    }
+    return conn_.Flush();
+  }
+
+ private:
+  static constexpr uint32_t kCapabilities =
+      0x00000001 |  // CLIENT_LONG_PASSWORD
+      0x00000002 |  // CLIENT_FOUND_ROWS
+      0x00000004 |  // CLIENT_LONG_FLAG
+      0x00000008 |  // CLIENT_CONNECT_WITH_DB
+      0x00000200 |  // CLIENT_PROTOCOL_41
+      0x00002000 |  // CLIENT_TRANSACTIONS
+      0x00008000 |  // CLIENT_SECURE_CONNECTION
+      0x00010000 |  // CLIENT_MULTI_STATEMENTS
+      0x00020000 |  // CLIENT_MULTI_RESULTS
+      0x00040000 |  // CLIENT_PS_MULTI_RESULTS
+      0x00080000;   // CLIENT_PLUGIN_AUTH
+  static constexpr char kUtf8 = 33; // utf8_general_ci
+  static constexpr char kBinary = 63;
+  static constexpr uint16_t kInTransaction = 0x0001;
+  static constexpr uint16_t kAutocommit = 0x0002;
+  static constexpr uint16_t kMoreResultsExist = 0x0008;
+  static constexpr char kLongLong = 0x08;
+  static constexpr char kVarString = static_cast<char>(0xfd);
+
+  enum Command : unsigned char {
+    kQuit = 0x01,
+    kInitDb = 0x02,
+    kQuery = 0x03,
+    kPing = 0x0e,
+    kStmtPrepare = 0x16,
+    kStmtExecute = 0x17,
+    kStmtSendLongData = 0x18,
+    kStmtClose = 0x19,
+    kStmtReset = 0x1a,
+    kSetOption = 0x1b,
+    kResetConnection = 0x1f,
+  };
+
+  bool ReadPacket(std::string &payload) {
+    payload.clear();
+    while (true) {
+      char header[4];
+      std::string chunk;
+      if (!conn_.Read(header, 4)) {
+        return false;
+      }
+      uint32_t length = ReadLE(header, 3);
+      sequence_ = static_cast<uint8_t>(header[3]) + 1; // replies continue the sequence
+      if (!conn_.Read(chunk, length)) {
+        return false;
+      }
+      payload += chunk;
+      if (length < 0xffffff) {
+        return true;
+      }
+    }
+  }
+
+  void Send(std::string const &payload) {
+    AppendLE(conn_.out, payload.size(), 3);
+    conn_.out.push_back(static_cast<char>(sequence_++));
+    conn_.out.append(payload);
+  }
+
+  static void AppendLengthEncoded(std::string &out, uint64_t v) {
+    if (v < 251) {
+      out.push_back(static_cast<char>(v));
+    } else if (v < (1 << 16)) {
+      out.push_back(static_cast<char>(0xfc));
+      AppendLE(out, v, 2);
+    } else if (v < (1 << 24)) {
+      out.push_back(static_cast<char>(0xfd));
+      AppendLE(out, v, 3);
+    } else {
+      out.push_back(static_cast<char>(0xfe));
+      AppendLE(out, v, 8);
+    }
+  }
+
+  static void AppendLengthEncoded(std::string &out, std::string const &s) {
+    AppendLengthEncoded(out, s.size());
+    out.append(s);
+  }
+
+  uint16_t Status() const {
+    return kAutocommit | (in_transaction_ ? kInTransaction : 0);
+  }
+
+  void Ok(uint16_t flags) {
+    std::string ok;
+    ok.push_back(0);
+    AppendLengthEncoded(ok, 1); // affected rows
+    AppendLengthEncoded(ok, 0); // last insert id
+    AppendLE(ok, Status() | flags, 2);
+    AppendLE(ok, 0, 2); // warnings
+    Send(ok);
+  }
+
+  void Eof(uint16_t flags) {
+    std::string eof;
+    eof.push_back(static_cast<char>(0xfe));
+    AppendLE(eof, 0, 2); // warnings
+    AppendLE(eof, Status() | flags, 2);
+    Send(eof);
+  }
+
+  void Error(uint16_t code, std::string const &message) {
+    std::string error;
+    error.push_back(static_cast<char>(0xff));
+    AppendLE(error, code, 2);
+    error.append("#HY000").append(message);
+    Send(error);
+  }
+
+  void ColumnDefinition(std::string const &name, bool integer) {
+    std::string column;
+    AppendLengthEncoded(column, std::string("def"));
+    AppendLengthEncoded(column, std::string("taobench"));
+    AppendLengthEncoded(column, std::string());
+    AppendLengthEncoded(column, std::string());
+    AppendLengthEncoded(column, name);
+    AppendLengthEncoded(column, name);
+    column.push_back(0x0c);
+    AppendLE(column, integer ? kBinary : kUtf8, 2);
+    AppendLE(column, integer ? 20 : 65535, 4); // display length
+    column.push_back(integer ? kLongLong : kVarString);
+    AppendLE(column, integer ? 0x0001 : 0, 2); // NOT_NULL_FLAG
+    column.push_back(0);                       // decimals
+    AppendLE(column, 0, 2);
+    Send(column);
+  }
+
+  // Replies to one statement: a result set for a SELECT, else OK.
+  void Respond(Statement const &statement, bool binary, uint16_t flags) {
+    if (statement.kind == Statement::kBegin) {
+      in_transaction_ = true;
+    } else if (statement.kind == Statement::kCommit || statement.kind == Statement::kRollback) {
+      in_transaction_ = false;
+    }
+    if (statement.kind != Statement::kSelect) {
+      Ok(flags);
+      return;
+    }
+    std::string count;
+    AppendLengthEncoded(count, statement.columns.size());
+    Send(count);
+    for (auto const &column : statement.columns) {
+      ColumnDefinition(column, !IsTextColumn(column));
+    }
+    Eof(0);
+    for (int i = 0; i < canned_.rows; ++i) {
+      std::string row;
+      if (binary) {
+        row.push_back(0);
+        row.append((statement.columns.size() + 7 + 2) / 8, '\0'); // NULL bitmap
+      }
+      for (auto const &column : statement.columns) {
+        if (IsTextColumn(column)) {
+          AppendLengthEncoded(row, canned_.value);
+        } else if (binary) {
+          AppendLE(row, 1, 8);
+        } else {
+          AppendLengthEncoded(row, std::string("1"));
+        }
+      }
+      Send(row);
+    }
+    Eof(flags);
+  }
+
+  Connection &conn_;
+  Canned const &canned_;
+  uint8_t sequence_ = 0;
+  bool in_transaction_ = false;
+  uint32_t next_statement_id_ = 1;
+  std::map<uint32_t, Statement> statements_;
+};
+} // namespace
+
+namespace benchmark {
+
+WireStub::WireStub(Protocol protocol, utils::Properties const &props)
+    : protocol_(protocol),
+      delay_us_(std::stoll(props.GetProperty(DELAY_US, "0"))),
+      rows_(std::stoi(props.GetProperty(ROWS, "1"))),
+      value_(std::stoi(props.GetProperty(VALUE_SIZE, "150")), 'x') {
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    throw utils::Exception(std::string("stub socket: ") + strerror(errno));
+  }
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(std::stoi(props.GetProperty(PORT, "0")));
+  socklen_t length = sizeof(address);
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+      listen(listen_fd_, 128) < 0 ||
+      getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &length) < 0) {
+    std::string error = strerror(errno);
+    close(listen_fd_);
+    throw utils::Exception("stub listen: " + error);
+  }
+  port_ = ntohs(address.sin_port);
+  acceptor_ = std::thread(&WireStub::AcceptLoop, this);
+}
+
+WireStub::~WireStub() {
+  stopping_ = true;
+  shutdown(listen_fd_, SHUT_RDWR);
+  acceptor_.join();
+  close(listen_fd_);
+  std::vector<std::thread> connections;
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (int fd : connection_fds_) {
+      shutdown(fd, SHUT_RDWR);
+    }
+    connections.swap(connections_);
+  }
+  for (auto &connection : connections) {
+    connection.join();
+  }
+}
+
+bool WireStub::DriverProtocol(std::string const &dbname, Protocol &protocol) {
+  if (dbname == "crdb" || dbname == "yugabytedb" || dbname == "postgres") {
+    protocol = Protocol::kPostgres;
+    return true;
+  } else if (dbname == "mysql") {
+    protocol = Protocol::kMySql;
+    return true;
+  }
+  return false;
+}
+
+void WireStub::Redirect(std::string const &dbname, utils::Properties &props) const {
+  std::string port = std::to_string(port_);
+  if (dbname == "mysql") {
+    // an IP address, as "localhost" would mean the Unix socket
+    props.SetProperty("mysqldb.url", "127.0.0.1");
+    props.SetProperty("mysqldb.dbport", port);
+    props.SetProperty("mysqldb.dbname", "taobench");
+    props.SetProperty("mysqldb.username", "taobench");
+    props.SetProperty("mysqldb.password", "taobench");
+    return;
+  }
+  std::string connection = "host=127.0.0.1 port=" + port +
+                           " dbname=taobench user=taobench sslmode=disable";
+  if (dbname == "yugabytedb") {
+    props.SetProperty("yugabytedb.string", connection);
+  } else {
+    props.SetProperty(dbname + ".connectionstring", connection);
+  }
+}
+
+void WireStub::AcceptLoop() {
+  while (!stopping_) {
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (!stopping_) {
+        std::cerr << "stub accept: " << strerror(errno) << std::endl;
+      }
+      return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connection_fds_.push_back(fd);
+    connections_.emplace_back(&WireStub::Serve, this, fd);
+  }
+}
+
+void WireStub::Serve(int fd) {
+  int64_t cpu = ThreadCpuNanos();
+  auto account = [&]() {
+    int64_t now = ThreadCpuNanos();
+    cpu_nanos_ += now - cpu;
+    cpu = now;
+  };
+  auto run = [&](auto &&session) {
+    if (!session.Start()) {
+      return;
+    }
+    account();
+    while (!stopping_ && session.Step()) {
+      account();
+    }
+  };
+
+  Connection conn(fd);
+  Canned canned{delay_us_, rows_, value_};
+  if (protocol_ == Protocol::kPostgres) {
+    run(PostgresSession(conn, canned));
+  } else {
+    run(MySqlSession(conn, canned));
+  }
+  account();
+
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connection_fds_.erase(std::find(connection_fds_.begin(), connection_fds_.end(), fd));
+  }
+  close(fd);
+}
+
+} // benchmark
@@ -0,0 +1,81 @@
+#ifndef WIRE_STUB_H_
+#define WIRE_STUB_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "properties.h"
+
+namespace benchmark {
+
+///
+/// Loopback server speaking just enough of the PostgreSQL or MySQL wire
+/// protocol for the drivers to connect, prepare statements, run queries and
+/// transactions, and decode the results. It stores nothing: every login is
+/// accepted, every statement prepares, and every query is answered after
+/// stub.delay_us with a canned result. A SELECT returns stub.rows rows with an
+/// integer in every column except value, which holds stub.value_size bytes;
+/// other statements report one row affected.
+///
+/// With the server cost fixed, the time and CPU a driver spends per operation
+/// is its own: query building, parameter binding and result decoding.
+///
+/// Each connection is served by its own thread, whose CPU time is summed in
+/// CpuNanos() so it can be subtracted from the process total.
+///
+class WireStub {
+ public:
+  enum class Protocol { kPostgres, kMySql };
+
+  /// Listens on 127.0.0.1, on stub.port if set, else on a free port.
+  WireStub(Protocol protocol, utils::Properties const &props);
+  ~WireStub();
+
+  WireStub(WireStub const &) = delete;
+  WireStub &operator=(WireStub const &) = delete;
+
+  int Port() const {
+    return port_;
+  }
+
+  /// CPU time used so far by the threads serving connections.
+  int64_t CpuNanos() const {
+    return cpu_nanos_.load();
+  }
+
+  /// Sets @param protocol to the protocol driver @param dbname speaks, if it
+  /// speaks one the stub can serve.
+  static bool DriverProtocol(std::string const &dbname, Protocol &protocol);
+
+  /// Points the connection properties of driver @param dbname at this stub.
+  void Redirect(std::string const &dbname, utils::Properties &props) const;
+
+ private:
+  void AcceptLoop();
+
+  // Serves one connection until the client leaves or the stub stops.
+  void Serve(int fd);
+
+  Protocol protocol_;
+  int64_t delay_us_;
+  int rows_;
+  std::string value_;
+
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::atomic<int64_t> cpu_nanos_{0};
+  std::thread acceptor_;
+
+  std::mutex connections_mutex_;
+  std::vector<int> connection_fds_;
+  std::vector<std::thread> connections_;
+};
+
+} // benchmark
+
+#endif // WIRE_STUB_H_
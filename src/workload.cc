@@ -15,7 +15,7 @@
 namespace benchmark {
 
   // Each loader contains a map from primary shard to a list of edges;
-  // Returns the combined map
+  // Returns the combined map, sorted for the adjacency index
   inline std::unordered_map<int, std::vector<Edge>> CombineKeyMaps(std::vector<std::shared_ptr<WorkloadLoader>> const & loaders)
   {
     std::unordered_map<int, std::vector<Edge>> map;
@@ -27,15 +27,50 @@ namespace benchmark {
       }
       loader_map.clear();
     }
+    AdjacencyIndex::SortEdges(map);
     return map;
   }
   
   TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p,
           std::vector<std::shared_ptr<WorkloadLoader>> const & loaders)
+      : TraceGeneratorWorkload(p, std::make_shared<std::unordered_map<int, std::vector<Edge>> const>(
+                                      CombineKeyMaps(loaders)), // only used in run phase
+                               nullptr, nullptr)
+  {
+    if (!shard_to_edges->empty()) {
+      std::cout << "Adjacency index: " << adjacency_index->NumObjects() << " objects, "
+                << GetNumLoadedEdges() << " edges, "
+                << adjacency_index->MemoryBytes() / (1 << 20) << " MiB index + "
+                << GetNumLoadedEdges() * sizeof(Edge) / (1 << 20) << " MiB edges" << std::endl;
+    }
+  }
+
+  TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p,
+                                                 TraceGeneratorWorkload const & keys_from)
+      : TraceGeneratorWorkload(p, keys_from.shard_to_edges, keys_from.adjacency_index,
+                               keys_from.key_pool)
+  {
+  }
+
+  TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p,
+          std::shared_ptr<std::unordered_map<int, std::vector<Edge>> const> edges,
+          std::shared_ptr<AdjacencyIndex const> index,
+          std::shared_ptr<LiveKeyPool> pool)
       : config_parser(p.GetProperty("config_path"))
       , object_table(p.GetProperty("object_table"))
       , edge_table(p.GetProperty("edge_table"))
-      , shard_to_edges(CombineKeyMaps(loaders)) // only used in run phase
+      , shard_to_edges(std::move(edges))
+      , adjacency_index(index ? std::move(index) : std::make_shared<AdjacencyIndex const>(*shard_to_edges))
+      , key_pool(pool ? std::move(pool) : std::make_shared<LiveKeyPool>(*shard_to_edges))
+      , key_samplers(*key_pool, KeyPopularity::FromConfig(config_parser))
+      , range_read_limit(std::stoi(p.GetProperty("range_read_limit",
+                                                 std::to_string(constants::RANGE_READ_LIMIT))))
+      , time_read_window_nanos(std::stoll(p.GetProperty("time_read_window_seconds", "0")) * 1000000000)
+      , preferential_attachment(std::stod(p.GetProperty("preferential_attachment",
+                                          std::to_string(constants::PREFERENTIAL_ATTACHMENT))))
+      , neighborhood_read_txns(p.GetProperty("neighborhood_read_txns", "false") == "true")
+      , key_generator(std::stoi(p.GetProperty("key_node_id", "0")),
+                      p.GetProperty("key_scramble", "false") == "true")
   {
     // Check fields were loaded correctly from configs in debug mode.
     assert(config_parser.fields.find("write_txn_sizes") != config_parser.fields.end());
@@ -47,7 +82,10 @@ namespace benchmark {
     assert(config_parser.fields.find("read_operation_types") != config_parser.fields.end());
     assert(config_parser.fields.find("write_operation_types") != config_parser.fields.end());
     assert(config_parser.fields.find("read_txn_sizes") != config_parser.fields.end());
-    ResizeShardWeights(constants::NUM_SHARDS);
+    ResizeShardWeights(config_parser, constants::NUM_SHARDS);
+    phases = WorkloadPhases::FromConfig(
+        config_parser, p.GetProperty("config_path"), std::stoi(p.GetProperty("phase_steps", "1")),
+        [](ConfigParser & config) { ResizeShardWeights(config, constants::NUM_SHARDS); });
   }
 
   TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p)
@@ -59,6 +97,18 @@ namespace benchmark {
     // do nothing, initialization is done in constructor
   }
 
+  void TraceGeneratorWorkload::BeginExperiment(Measurements & measurements) {
+    if (phases) {
+      phases->Start(measurements);
+    }
+  }
+
+  void TraceGeneratorWorkload::EndExperiment() {
+    if (phases) {
+      phases->Stop();
+    }
+  }
+
   long TraceGeneratorWorkload::GetNumKeys(long num_requests) {
     ConfigParser::LineObject & obj = config_parser.fields["write_txn_sizes"];
     long num_keys = 0;
@@ -89,7 +139,7 @@ namespace benchmark {
 
   long TraceGeneratorWorkload::GetNumLoadedEdges() {
     long total_size = 0;
-    for (auto const & [key, value] : shard_to_edges) {
+    for (auto const & [key, value] : *shard_to_edges) {
       total_size += value.size();
     }
     return total_size;
@@ -110,42 +160,186 @@ namespace benchmark {
   }
 
   Status TraceGeneratorWorkload::DispatchRequest(DB &db) {
-    std::discrete_distribution<> op_dist = config_parser.fields["operations"].distribution;
+    std::discrete_distribution<> op_dist = Mix().fields["operations"].distribution;
     std::vector<DB::TimestampValue> read_buffer;
     switch (op_dist(rnd::gen)) {
-      case 0:
-        return db.Execute(GetReadOperation(false), read_buffer);
-      case 1:
-        return db.Execute(GetWriteOperation(false), read_buffer);
-      case 2:
-        return db.ExecuteTransaction(GetReadTransaction(), read_buffer, true);
-      case 3:
-        return db.ExecuteTransaction(GetWriteTransaction(), read_buffer, false);
+      case 0: {
+        DB::DB_Operation op = GetReadOperation(false);
+        int64_t start = recorder_ ? utils::CurrentTimeNanos() : 0;
+        Status s = db.Execute(op, read_buffer);
+        Record(TraceRequest::Kind::kOperation, &op, 1, s, start);
+        return s;
+      }
+      case 1: {
+        LiveKeyPool::Ref target;
+        DB::DB_Operation op = GetWriteOperation(false, target);
+        int64_t start = recorder_ ? utils::CurrentTimeNanos() : 0;
+        Status s = db.Execute(op, read_buffer);
+        Record(TraceRequest::Kind::kOperation, &op, 1, s, start);
+        if (s == Status::kOK) {
+          UpdateKeyPool(op, target);
+        }
+        return s;
+      }
+      case 2: {
+        std::vector<DB::DB_Operation> ops = GetReadTransaction();
+        int64_t start = recorder_ ? utils::CurrentTimeNanos() : 0;
+        Status s = db.ExecuteTransaction(ops, read_buffer, true);
+        Record(TraceRequest::Kind::kReadTransaction, ops.data(), ops.size(), s, start);
+        return s;
+      }
+      case 3: {
+        std::vector<LiveKeyPool::Ref> targets;
+        std::vector<DB::DB_Operation> ops = GetWriteTransaction(targets);
+        int64_t start = recorder_ ? utils::CurrentTimeNanos() : 0;
+        Status s = db.ExecuteTransaction(ops, read_buffer, false);
+        Record(TraceRequest::Kind::kWriteTransaction, ops.data(), ops.size(), s, start);
+        if (s == Status::kOK) {
+          for (size_t i = 0; i < ops.size(); ++i) {
+            UpdateKeyPool(ops[i], targets[i]);
+          }
+        }
+        return s;
+      }
       default:
         throw std::invalid_argument("Distribution result out of bounds");
     }
   }
 
+  // Contention errors are not retried here: backing off would stall the thread that
+  // keeps the other requests in flight, so they are counted as failed instead.
+  // Requests are recorded by the thread that completes them.
+  void TraceGeneratorWorkload::DoRequestAsync(DB &db, std::function<void(bool)> done) {
+    std::discrete_distribution<> op_dist = Mix().fields["operations"].distribution;
+    auto read_buffer = std::make_shared<std::vector<DB::TimestampValue>>();
+    int64_t start = recorder_ ? utils::CurrentTimeNanos() : 0;
+    switch (op_dist(rnd::gen)) {
+      case 0: {
+        auto op = std::make_shared<DB::DB_Operation>(GetReadOperation(false));
+        db.ExecuteAsync(*op, *read_buffer, [this, read_buffer, done, op, start](Status s) {
+          Record(TraceRequest::Kind::kOperation, op.get(), 1, s, start);
+          done(s == Status::kOK);
+        });
+        break;
+      }
+      case 1: {
+        LiveKeyPool::Ref target;
+        auto op = std::make_shared<DB::DB_Operation>(GetWriteOperation(false, target));
+        db.ExecuteAsync(*op, *read_buffer, [this, read_buffer, done, op, target, start](Status s) {
+          Record(TraceRequest::Kind::kOperation, op.get(), 1, s, start);
+          if (s == Status::kOK) {
+            UpdateKeyPool(*op, target);
+          }
+          done(s == Status::kOK);
+        });
+        break;
+      }
+      case 2: {
+        auto ops = std::make_shared<std::vector<DB::DB_Operation>>(GetReadTransaction());
+        db.ExecuteTransactionAsync(*ops, *read_buffer, true,
+                                   [this, read_buffer, done, ops, start](Status s) {
+          Record(TraceRequest::Kind::kReadTransaction, ops->data(), ops->size(), s, start);
+          done(s == Status::kOK);
+        });
+        break;
+      }
+      case 3: {
+        auto targets = std::make_shared<std::vector<LiveKeyPool::Ref>>();
+        auto ops = std::make_shared<std::vector<DB::DB_Operation>>(GetWriteTransaction(*targets));
+        db.ExecuteTransactionAsync(*ops, *read_buffer, false,
+                                   [this, read_buffer, done, ops, targets, start](Status s) {
+          Record(TraceRequest::Kind::kWriteTransaction, ops->data(), ops->size(), s, start);
+          if (s == Status::kOK) {
+            for (size_t i = 0; i < ops->size(); ++i) {
+              UpdateKeyPool((*ops)[i], (*targets)[i]);
+            }
+          }
+          done(s == Status::kOK);
+        });
+        break;
+      }
+      default:
+        throw std::invalid_argument("Distribution result out of bounds");
+    }
+  }
+
+  void TraceGeneratorWorkload::Record(TraceRequest::Kind kind, DB::DB_Operation const *ops,
+                                      size_t num_ops, Status status, int64_t start_nanos) {
+    if (recorder_) {
+      recorder_->Record(kind, ops, num_ops, status, start_nanos);
+    }
+  }
+
   // This function is used in the batch insert phase to generate an edge with new primary and remote keys.
+  // With an edge_degrees line in the config, the edges are shaped into a graph instead (LoadGraphRow).
   int TraceGeneratorWorkload::LoadRow(WorkloadLoader &loader, int write_batch_size) {
+    if (config_parser.fields.find("edge_degrees") != config_parser.fields.end()) {
+      return LoadGraphRow(loader, write_batch_size);
+    }
     std::uniform_int_distribution<> unif(0, constants::NUM_SHARDS-1);
     ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
     int primary_shard = unif(rnd::gen);
     int remote_shard = remote_shards.distribution(rnd::gen);
     int64_t primary_key = GenerateKey(primary_shard);
     int64_t remote_key = GenerateKey(remote_shard);
-    EdgeType edge_type = GetRandomEdgeType();
+    EdgeType edge_type = GetRandomEdgeType(config_parser);
     int64_t timestamp = utils::CurrentTimeNanos();
     std::string value = GetValue();
     return loader.WriteToBuffers(primary_shard, primary_key, remote_key, edge_type, timestamp, value, write_batch_size);
   }
 
-  void TraceGeneratorWorkload::ResizeShardWeights(int n_shards) {
+  // Loads the next edge of a graph with heavy-tailed out-degrees. Each new primary object is given
+  // an out-degree drawn from edge_degrees, and its edges are loaded one per call. An edge's remote
+  // key is, with probability preferential_attachment, an object this loader already loaded, chosen in
+  // proportion to its degree, and otherwise a new object on a remote shard.
+  // Objects are only attached to objects of the same loader, so threads stay independent, and the
+  // random choices come from the loader's own generator, so a seeded loader loads the same shape.
+  int TraceGeneratorWorkload::LoadGraphRow(WorkloadLoader &loader, int write_batch_size) {
+    WorkloadLoader::GraphState & graph = loader.graph;
+    bool new_primary = graph.edges_left == 0;
+    if (new_primary) {
+      ConfigParser::LineObject & degrees = config_parser.fields["edge_degrees"];
+      std::uniform_int_distribution<> unif(0, constants::NUM_SHARDS-1);
+      graph.source_shard = unif(graph.gen);
+      graph.source = GenerateKey(graph.source_shard);
+      graph.edges_left = std::max(1, degrees.vals[degrees.distribution(graph.gen)]);
+      graph.targets.clear();
+    }
+    // only an object with a single edge can have a unique one
+    EdgeType edge_type = GetRandomEdgeType(config_parser, graph.gen);
+    if (graph.edges_left > 1 || !new_primary) {
+      if (edge_type == EdgeType::Unique) {
+        edge_type = EdgeType::Other;
+      } else if (edge_type == EdgeType::UniqueAndBidirectional) {
+        edge_type = EdgeType::Bidirectional;
+      }
+    }
+    --graph.edges_left;
+
+    int64_t remote_key;
+    bool new_remote = !(std::bernoulli_distribution(preferential_attachment)(graph.gen)
+                        && loader.RandomLoadedEndpoint(graph.gen, remote_key)
+                        && remote_key != graph.source
+                        && graph.targets.insert(remote_key).second);
+    if (new_remote) {
+      ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
+      remote_key = GenerateKey(remote_shards.distribution(graph.gen));
+      graph.targets.insert(remote_key);
+    }
+    graph.endpoints.push_back(graph.source);
+    graph.endpoints.push_back(remote_key);
+    int64_t timestamp = utils::CurrentTimeNanos();
+    std::string value = GetValue();
+    return loader.WriteToBuffers(graph.source_shard, graph.source, remote_key, edge_type, timestamp,
+                                 value, write_batch_size, new_primary, new_remote);
+  }
+
+  void TraceGeneratorWorkload::ResizeShardWeights(ConfigParser & config, int n_shards) {
 
     // only resize if we need to shrink, otherwise just assume extra shards have weight 0 (?)
 
-    ConfigParser::LineObject & primary_shards = config_parser.fields["primary_shards"];
-    ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
+    ConfigParser::LineObject & primary_shards = config.fields["primary_shards"];
+    ConfigParser::LineObject & remote_shards = config.fields["remote_shards"];
 
     if (primary_shards.weights.size() > n_shards) {
       std::vector<double> primary_old_weights = std::move(primary_shards.weights);
@@ -178,42 +372,53 @@ namespace benchmark {
     }
   }
 
-  EdgeType TraceGeneratorWorkload::GetRandomEdgeType() {
-    ConfigParser::LineObject & obj = config_parser.fields["edge_types"];
-    return EdgeStringToType(obj.types[obj.distribution(rnd::gen)]);
+  EdgeType TraceGeneratorWorkload::GetRandomEdgeType(ConfigParser & config, std::mt19937 &gen) {
+    ConfigParser::LineObject & obj = config.fields["edge_types"];
+    return EdgeStringToType(obj.types[obj.distribution(gen)]);
   }
 
   int64_t TraceGeneratorWorkload::GenerateKey(int shard) {
-    int64_t timestamp = utils::CurrentTimeNanos();
-    int64_t seqnum = counter::key_count++;
-    // 64 bit int split into 7 bit shard, 17 thread-specific sequence number,
-    // and bottom 40 bits of timestamp
-    // this design is fairly arbitrary; intent is just to minimize duplicate keys across threads
-    return (((int64_t) shard) << 57) + ((seqnum & 0x1FFFF) << 40) +
-        (timestamp & 0xFFFFFFFFFF);
+    return key_generator(shard);
   }
 
   std::string TraceGeneratorWorkload::GetRandomReadOperationType(bool is_txn_op) {
-    ConfigParser::LineObject & obj = config_parser.fields[is_txn_op ? "read_txn_operation_types"
+    ConfigParser::LineObject & obj = Mix().fields[is_txn_op ? "read_txn_operation_types"
                                                                     : "read_operation_types"];
     return obj.types[obj.distribution(rnd::gen)];
   }
 
   std::string TraceGeneratorWorkload::GetRandomWriteOperationType(bool is_txn_op) {
-    ConfigParser::LineObject & obj = config_parser.fields[is_txn_op ? "write_txn_operation_types"
+    ConfigParser::LineObject & obj = Mix().fields[is_txn_op ? "write_txn_operation_types"
                                                                     : "write_operation_types"];
     return obj.types[obj.distribution(rnd::gen)];
   }
 
-  Edge const & TraceGeneratorWorkload::GetRandomEdge() {
-    ConfigParser::LineObject & obj = config_parser.fields["primary_shards"];
-    auto it = shard_to_edges.find(obj.distribution(rnd::gen));
-    while (it == shard_to_edges.end()) {
-      it = shard_to_edges.find(obj.distribution(rnd::gen));
+  Edge const & TraceGeneratorWorkload::GetRandomEdge(LiveKeyPool::Ref *ref) {
+    ConfigParser::LineObject & obj = Mix().fields["primary_shards"];
+    int shard = obj.distribution(rnd::gen);
+    while (!key_pool->HasEdges(shard)) {
+      shard = obj.distribution(rnd::gen);
     }
 
-    std::uniform_int_distribution<int> edge_selector(0, (it->second).size()-1);
-    return (it->second)[edge_selector(rnd::gen)];
+    // within the shard, edges are picked as popular as the config's key_popularity says
+    LiveKeyPool::Ref picked = key_pool->Sample(shard, key_samplers, rnd::gen);
+    if (ref != nullptr) {
+      *ref = picked;
+    }
+    return key_pool->Get(picked);
+  }
+
+  // Only called for acknowledged writes: inserted edges join the key pool, unless the
+  // driver wrote no row for them, and deleted ones leave it.
+  void TraceGeneratorWorkload::UpdateKeyPool(DB::DB_Operation const & op, LiveKeyPool::Ref const & target) {
+    if (op.table != DataTable::Edges) {
+      return;
+    }
+    if (op.operation == Operation::INSERT && op.written) {
+      key_pool->Append({op.key[0].value, op.key[1].value, static_cast<EdgeType>(op.key[2].value)});
+    } else if (op.operation == Operation::DELETE) {
+      key_pool->Remove(target);
+    }
   }
   
   std::string TraceGeneratorWorkload::GetValue() {
@@ -226,13 +431,33 @@ namespace benchmark {
   }
 
   DB::DB_Operation TraceGeneratorWorkload::GetReadOperation(bool is_txn_op) {
+    return GetReadOperation(is_txn_op, GetRandomEdge());
+  }
+
+  DB::DB_Operation TraceGeneratorWorkload::GetReadOperation(bool is_txn_op, Edge const & edge) {
     std::string operation_type = GetRandomReadOperationType(is_txn_op);
-    bool is_edge_op = operation_type.find("edge") != std::string::npos;
-    Edge const & edge = GetRandomEdge();
-    if (is_edge_op) {
+    int64_t type = static_cast<int64_t>(edge.type);
+    if (operation_type == "edge_range_read") {
+      DB::DB_Operation op{DataTable::Edges, {{"id1", edge.primary_key}}, {0L, ""}, Operation::RANGEREAD};
+      op.limit = range_read_limit;
+      return op;
+    } else if (operation_type == "edge_count_read") {
       return {DataTable::Edges,
-               {{"id1", edge.primary_key}, {"id2", edge.remote_key},
-                  {"type", static_cast<int64_t>(edge.type)}},
+               {{"id1", edge.primary_key}, {"type", type}},
+               {0L, ""},
+               Operation::COUNTREAD
+             };
+    } else if (operation_type == "edge_time_read") {
+      DB::DB_Operation op{DataTable::Edges, {{"id1", edge.primary_key}, {"type", type}},
+                          {0L, ""}, Operation::TIMERANGEREAD};
+      op.limit = range_read_limit;
+      // a window of 0 reaches back to the first edge
+      op.max_timestamp = utils::CurrentTimeNanos();
+      op.min_timestamp = time_read_window_nanos > 0 ? op.max_timestamp - time_read_window_nanos : 0;
+      return op;
+    } else if (operation_type.find("edge") != std::string::npos) {
+      return {DataTable::Edges,
+               {{"id1", edge.primary_key}, {"id2", edge.remote_key}, {"type", type}},
                {0L, ""},
                Operation::READ
              };
@@ -245,7 +470,7 @@ namespace benchmark {
     }
   }
 
-  DB::DB_Operation TraceGeneratorWorkload::GetWriteOperation(bool is_txn_op) {
+  DB::DB_Operation TraceGeneratorWorkload::GetWriteOperation(bool is_txn_op, LiveKeyPool::Ref & target) {
     std::string operation_type = GetRandomWriteOperationType(is_txn_op);
     bool is_edge_op = operation_type.find("edge") != std::string::npos;
     Operation db_op_type;
@@ -262,13 +487,14 @@ namespace benchmark {
 
     Edge edge;
     if (db_op_type != Operation::INSERT) {
-      edge = GetRandomEdge();
+      edge = GetRandomEdge(&target);
     } else {
-      ConfigParser::LineObject & primary_shards = config_parser.fields["primary_shards"];
-      ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
+      ConfigParser & mix = Mix();
+      ConfigParser::LineObject & primary_shards = mix.fields["primary_shards"];
+      ConfigParser::LineObject & remote_shards = mix.fields["remote_shards"];
       edge.primary_key = GenerateKey(primary_shards.distribution(rnd::gen));
       edge.remote_key = GenerateKey(remote_shards.distribution(rnd::gen));
-      edge.type = GetRandomEdgeType();
+      edge.type = GetRandomEdgeType(mix);
     }
     int64_t timestamp = utils::CurrentTimeNanos();
     std::string value = GetValue();
@@ -288,8 +514,11 @@ namespace benchmark {
   }
 
   std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetReadTransaction() {
-    ConfigParser::LineObject & obj = config_parser.fields["read_txn_sizes"];
+    ConfigParser::LineObject & obj = Mix().fields["read_txn_sizes"];
     int transaction_size = obj.vals[obj.distribution(rnd::gen)];
+    if (neighborhood_read_txns) {
+      return GetNeighborhoodReadTransaction(transaction_size);
+    }
     std::vector<DB::DB_Operation> ops;
     for (int i = 0; i < transaction_size; ++i) {
       ops.push_back(GetReadOperation(true));
@@ -297,12 +526,39 @@ namespace benchmark {
     return ops;
   }
 
-  std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetWriteTransaction() {
-    ConfigParser::LineObject & obj = config_parser.fields["write_txn_sizes"];
+  // Reads around one object, the way TAO fetches an association list and then the objects
+  // it points to: every operation after the first is on a random edge leaving the id1 of the
+  // first edge, and object reads read that edge's remote object. Edges inserted during the run
+  // are not in the adjacency index, so around one of those the other operations read random edges.
+  std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetNeighborhoodReadTransaction(int transaction_size) {
+    Edge const & first = GetRandomEdge();
+    AdjacencyIndex::EdgeRange neighbors = adjacency_index->EdgesOf(first.primary_key);
+    std::vector<DB::DB_Operation> ops;
+    ops.push_back(GetReadOperation(true, first));
+    if (neighbors.empty()) {
+      for (int i = 1; i < transaction_size; ++i) {
+        ops.push_back(GetReadOperation(true));
+      }
+      return ops;
+    }
+    std::uniform_int_distribution<size_t> neighbor_selector(0, neighbors.size() - 1);
+    for (int i = 1; i < transaction_size; ++i) {
+      Edge const & edge = neighbors[neighbor_selector(rnd::gen)];
+      ops.push_back(GetReadOperation(true, edge));
+      if (ops.back().table == DataTable::Objects) {
+        ops.back().key[0].value = edge.remote_key;
+      }
+    }
+    return ops;
+  }
+
+  std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetWriteTransaction(std::vector<LiveKeyPool::Ref> & targets) {
+    ConfigParser::LineObject & obj = Mix().fields["write_txn_sizes"];
     int transaction_size = obj.vals[obj.distribution(rnd::gen)];
     std::vector<DB::DB_Operation> ops;
+    targets.resize(transaction_size);
     for (int i = 0; i < transaction_size; ++i) {
-      ops.push_back(GetWriteOperation(true));
+      ops.push_back(GetWriteOperation(true, targets[i]));
     }
     return ops;
   }
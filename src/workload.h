@@ -7,6 +7,8 @@
 #include <ctime>
 #include <climits>
 #include <thread>
+#include <functional>
+#include <memory>
 #include "db.h"
 #include "timer.h"
 #include "properties.h"
@@ -14,6 +16,12 @@
 #include "parse_config.h"
 #include "workload_loader.h"
 #include "edge.h"
+#include "adjacency_index.h"
+#include "key_generator.h"
+#include "key_popularity.h"
+#include "live_key_pool.h"
+#include "trace.h"
+#include "workload_phases.h"
 
 namespace benchmark {
 namespace rnd {
@@ -22,9 +30,7 @@ namespace rnd {
         CHAR_BIT, unsigned char> byte_engine;
 }
 
-namespace counter {
-  thread_local static uint32_t key_count(std::uniform_int_distribution<>(0)(rnd::gen));
-}
+class Measurements;
 
 class Workload {
  public:
@@ -36,6 +42,21 @@ class Workload {
 
   // Carries out a WorkloadOperation on db.
   virtual bool DoRequest(DB &db) = 0;
+
+  // Asynchronous variant of DoRequest; done is called with the outcome once the
+  // request completes, possibly on another thread. Runs DoRequest inline by default.
+  virtual void DoRequestAsync(DB &db, std::function<void(bool)> done) {
+    done(DoRequest(db));
+  }
+
+  // Whether the last DoRequest on this thread found no requests left and issued
+  // none, e.g. at the end of a trace; the client thread then stops.
+  virtual bool Exhausted() const { return false; }
+
+  // Called as each experiment starts, with the measurements its requests are
+  // reported to, and again once its client threads have finished.
+  virtual void BeginExperiment(Measurements &measurements) {}
+  virtual void EndExperiment() {}
 };
 
 class TraceGeneratorWorkload : public Workload {
@@ -48,14 +69,29 @@ public:
   TraceGeneratorWorkload(const utils::Properties &p,
                          std::vector<std::shared_ptr<WorkloadLoader>> const & loaders);
 
+  // Another tenant of the run phase: draws from the config of p, with its own key
+  // popularity, from the key pool of keys_from, whose inserts and deletes it shares.
+  TraceGeneratorWorkload(const utils::Properties &p, TraceGeneratorWorkload const & keys_from);
+
   void Init(DB &db) override;
 
   bool DoRequest(DB &db) override;
 
+  void DoRequestAsync(DB &db, std::function<void(bool)> done) override;
+
+  // Runs the config's phases, if any, over the experiment.
+  void BeginExperiment(Measurements &measurements) override;
+
+  void EndExperiment() override;
+
   long GetNumKeys(long num_reqs);
 
   long GetNumLoadedEdges();
 
+  // Requests are recorded to @param recorder, if not null, which must outlive
+  // the requests.
+  void SetRecorder(TraceRecorder *recorder) { recorder_ = recorder; }
+
 private:
 
   // Deprecated
@@ -75,34 +111,75 @@ public:
 
 private:
 
+  TraceGeneratorWorkload(const utils::Properties &p,
+                         std::shared_ptr<std::unordered_map<int, std::vector<Edge>> const> edges,
+                         std::shared_ptr<AdjacencyIndex const> index,
+                         std::shared_ptr<LiveKeyPool> pool);
+
   Status DispatchRequest(DB &db);
 
+  void Record(TraceRequest::Kind kind, DB::DB_Operation const *ops, size_t num_ops,
+              Status status, int64_t start_nanos);
+
   int64_t GenerateKey(int shard);
 
-  void ResizeShardWeights(int num_shards);
+  int LoadGraphRow(WorkloadLoader &loader, int write_batch_size);
+
+  static void ResizeShardWeights(ConfigParser & config, int num_shards);
 
-  EdgeType GetRandomEdgeType();
+  // The config of the current phase, from which the run phase draws requests
+  ConfigParser & Mix() { return phases ? phases->Current() : config_parser; }
+
+  EdgeType GetRandomEdgeType(ConfigParser & config, std::mt19937 &gen = rnd::gen);
 
   std::string GetRandomReadOperationType(bool is_txn_op);
 
   std::string GetRandomWriteOperationType(bool is_txn_op);
 
-  Edge const & GetRandomEdge();
+  // @param ref, if given, is set to where the edge is in the key pool
+  Edge const & GetRandomEdge(LiveKeyPool::Ref *ref = nullptr);
+
+  void UpdateKeyPool(DB::DB_Operation const & op, LiveKeyPool::Ref const & target);
 
   std::string GetValue();
 
   DB::DB_Operation GetReadOperation(bool is_txn_op);
 
-  DB::DB_Operation GetWriteOperation(bool is_txn_op);
+  DB::DB_Operation GetReadOperation(bool is_txn_op, Edge const & edge);
+
+  // @param target is set to the key pool edge an update or delete writes
+  DB::DB_Operation GetWriteOperation(bool is_txn_op, LiveKeyPool::Ref & target);
 
   std::vector<DB::DB_Operation> GetReadTransaction();
 
-  std::vector<DB::DB_Operation> GetWriteTransaction();
+  std::vector<DB::DB_Operation> GetNeighborhoodReadTransaction(int transaction_size);
+
+  std::vector<DB::DB_Operation> GetWriteTransaction(std::vector<LiveKeyPool::Ref> & targets);
 
   ConfigParser config_parser;
+  // null without a phases line in the config
+  std::unique_ptr<WorkloadPhases> phases;
   std::string const object_table;
   std::string const edge_table;
-  std::unordered_map<int, std::vector<Edge>> const shard_to_edges;
+  // shared by the tenants of a run
+  std::shared_ptr<std::unordered_map<int, std::vector<Edge>> const> const shard_to_edges;
+  // edges of each id1 in shard_to_edges
+  std::shared_ptr<AdjacencyIndex const> const adjacency_index;
+  // shard_to_edges with the edges inserted and deleted since, shared by the tenants of a run
+  std::shared_ptr<LiveKeyPool> const key_pool;
+  // picks key_pool's edges as popular as the config's key_popularity says
+  LiveKeyPool::ShardSamplers const key_samplers;
+  // edges returned by an edge_range_read or edge_time_read
+  int const range_read_limit;
+  // how far back an edge_time_read looks; 0 for no lower bound
+  int64_t const time_read_window_nanos;
+  // chance a graph-shaped load attaches an edge to an existing object
+  double const preferential_attachment;
+  // read transactions read the neighborhood of one object
+  bool const neighborhood_read_txns;
+  // keys of new objects
+  KeyGenerator const key_generator;
+  TraceRecorder *recorder_ = nullptr;
 };
 
 } // benchmark
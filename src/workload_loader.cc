@@ -19,16 +19,22 @@ namespace benchmark {
                                      EdgeType edge_type,
                                      int64_t timestamp,
                                      std::string const & value,
-                                     int write_batch_size)
+                                     int write_batch_size,
+                                     bool new_primary,
+                                     bool new_remote)
   {
     int failed_ops = 0;
     shard_to_edges[primary_shard].emplace_back(primary_key, remote_key, edge_type);
     edge_value_buffer.emplace_back(timestamp, value);
     edge_key_buffer.push_back({{"id1", primary_key}, {"id2", remote_key}, {"type", static_cast<int64_t>(edge_type)}});
-    object_key_buffer.push_back({{"id", primary_key}});
-    object_key_buffer.push_back({{"id", remote_key}});
-    object_value_buffer.emplace_back(timestamp, value);
-    object_value_buffer.emplace_back(timestamp, value);
+    if (new_primary) {
+      object_key_buffer.push_back({{"id", primary_key}});
+      object_value_buffer.emplace_back(timestamp, value);
+    }
+    if (new_remote) {
+      object_key_buffer.push_back({{"id", remote_key}});
+      object_value_buffer.emplace_back(timestamp, value);
+    }
     if (edge_value_buffer.size() > write_batch_size) {
       failed_ops += FlushEdgeBuffer();
     }
@@ -38,6 +44,15 @@ namespace benchmark {
     return failed_ops;
   }
 
+  bool WorkloadLoader::RandomLoadedEndpoint(std::mt19937 &gen, int64_t &key) const {
+    std::vector<int64_t> const & endpoints = graph.endpoints;
+    if (endpoints.empty()) {
+      return false;
+    }
+    key = endpoints[std::uniform_int_distribution<size_t>(0, endpoints.size() - 1)(gen)];
+    return true;
+  }
+
   bool WorkloadLoader::FlushEdgeBuffer() {
     bool failed = db_.BatchInsert(DataTable::Edges, edge_key_buffer, edge_value_buffer) != Status::kOK;
     edge_key_buffer.clear();
@@ -58,9 +73,13 @@ namespace benchmark {
     return failed;
   }
 
-  // shard is first 7 bits of id
-  inline int GetShardFromKey(int64_t id) {
-    return id >> 57;
+  void WorkloadLoader::AddReadEdge(std::vector<DB::Field> const & key) {
+    assert(key.size() == 3);
+    assert(key[0].name == "id1");
+    assert(key[1].name == "id2");
+    assert(key[2].name == "type");
+    shard_to_edges[GetShardFromKey(key[0].value)].emplace_back(
+        key[0].value, key[1].value, static_cast<EdgeType>(key[2].value));
   }
 
   int WorkloadLoader::BatchRead(int read_batch_size) {
@@ -94,12 +113,7 @@ namespace benchmark {
       }
       num_read_by_thread += read_buffer.size();
       for (auto const & row : read_buffer) {
-        assert(row.size() == 3);
-        assert(row[0].name == "id1");
-        assert(row[1].name == "id2");
-        assert(row[2].name == "type");
-        shard_to_edges[GetShardFromKey(row[0].value)].emplace_back(
-            row[0].value, row[1].value, static_cast<EdgeType>(row[2].value));
+        AddReadEdge(row);
       }
       if (read_buffer.empty()) {
         break;
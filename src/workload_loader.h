@@ -2,7 +2,9 @@
 
 #include "db.h"
 #include "edge.h"
+#include <random>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace benchmark {
 
@@ -18,13 +20,17 @@ namespace benchmark {
                    int64_t start_key = 0, 
                    int64_t end_key = 0);
 
+    // Buffers an edge, and an object for each endpoint flagged as new; an
+    // object already loaded must not be inserted twice.
     int WriteToBuffers(int primary_shard,
                        int64_t primary_key,
                        int64_t remote_key,
                        EdgeType edge_type,
                        int64_t timestamp,
                        std::string const & value,
-                       int write_batch_size);
+                       int write_batch_size,
+                       bool new_primary = true,
+                       bool new_remote = true);
 
     bool FlushEdgeBuffer();
 
@@ -32,9 +38,32 @@ namespace benchmark {
 
     int BatchRead(int read_batch_size);
 
+    // Adds an edge key read from the DB to shard_to_edges.
+    void AddReadEdge(std::vector<DB::Field> const & key);
+
+    // Sets @param key to an endpoint of a graph edge loaded so far, chosen
+    // uniformly among all endpoints, so an object is picked in proportion to its
+    // degree. Returns false if nothing was loaded yet.
+    bool RandomLoadedEndpoint(std::mt19937 &gen, int64_t &key) const;
+
     // This is a map of all the edges from a batch read.
     std::unordered_map<int, std::vector<Edge>> shard_to_edges;
 
+    // State of a graph-shaped batch insert (see TraceGeneratorWorkload::LoadRow).
+    // Each loader runs on its own thread, so none of it is shared.
+    struct GraphState {
+      std::mt19937 gen{std::random_device{}()};
+      // object whose edges are being loaded, and how many it still gets
+      int64_t source = 0;
+      int source_shard = 0;
+      int edges_left = 0;
+      // remote keys of source so far, so no edge is loaded twice
+      std::unordered_set<int64_t> targets;
+      // both endpoints of every edge loaded so far, to sample from in O(1)
+      std::vector<int64_t> endpoints;
+    };
+    GraphState graph;
+
   private:
     DB &db_;
     int64_t start_key, end_key;
@@ -0,0 +1,151 @@
+#include "workload_phases.h"
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "measurements.h"
+
+namespace benchmark {
+
+namespace {
+std::string ResolvePath(std::string const &path, std::string const &config_path) {
+  size_t slash = config_path.rfind('/');
+  if (path.empty() || path[0] == '/' || slash == std::string::npos) {
+    return path;
+  }
+  return config_path.substr(0, slash + 1) + path;
+}
+
+std::vector<double> Normalized(std::vector<double> weights) {
+  double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+  if (total > 0) {
+    for (double &weight : weights) {
+      weight /= total;
+    }
+  }
+  return weights;
+}
+
+// Moves the weights of @param line the fraction @param f of the way to those of
+// @param to, if both draw from the same values.
+void Blend(ConfigParser::LineObject &line, ConfigParser::LineObject const &to, double f) {
+  if (line.types != to.types || line.vals != to.vals || line.weights.size() != to.weights.size()) {
+    return;
+  }
+  std::vector<double> from_weights = Normalized(line.weights);
+  std::vector<double> to_weights = Normalized(to.weights);
+  for (size_t i = 0; i < line.weights.size(); ++i) {
+    line.weights[i] = (1 - f) * from_weights[i] + f * to_weights[i];
+  }
+  line.distribution = std::discrete_distribution<>(line.weights.begin(), line.weights.end());
+}
+} // namespace
+
+std::unique_ptr<WorkloadPhases> WorkloadPhases::FromConfig(
+    ConfigParser const &config, std::string const &config_path, int steps,
+    std::function<void(ConfigParser &)> const &prepare) {
+  auto line = config.fields.find("phases");
+  if (line == config.fields.end()) {
+    return nullptr;
+  }
+  std::vector<std::string> const &names = line->second.types;
+  std::vector<double> const &seconds = line->second.weights;
+  if (names.empty() || names.size() != seconds.size()) {
+    throw std::invalid_argument("phases needs a length in seconds for each phase config");
+  }
+  for (double length : seconds) {
+    if (length <= 0) {
+      throw std::invalid_argument("phases must be longer than 0 seconds");
+    }
+  }
+  if (steps < 1) {
+    throw std::invalid_argument("phase_steps must be at least 1");
+  }
+
+  std::unique_ptr<WorkloadPhases> phases{new WorkloadPhases(names, seconds, steps)};
+  std::vector<ConfigParser> phase_configs;
+  for (std::string const &name : names) {
+    phase_configs.push_back(config);
+    phase_configs.back().Override(ResolvePath(name, config_path));
+    prepare(phase_configs.back());
+  }
+  for (size_t i = 0; i < phase_configs.size(); ++i) {
+    ConfigParser const &next = phase_configs[(i + 1) % phase_configs.size()];
+    for (int step = 0; step < steps; ++step) {
+      auto mix = std::make_unique<ConfigParser>(phase_configs[i]);
+      if (step > 0) {
+        for (auto &[name, mix_line] : mix->fields) {
+          auto next_line = next.fields.find(name);
+          if (next_line != next.fields.end()) {
+            Blend(mix_line, next_line->second, static_cast<double>(step) / steps);
+          }
+        }
+      }
+      phases->mixes_.push_back(std::move(mix));
+    }
+  }
+  return phases;
+}
+
+WorkloadPhases::WorkloadPhases(std::vector<std::string> names, std::vector<double> seconds, int steps)
+    : names_(std::move(names))
+    , seconds_(std::move(seconds))
+    , steps_(steps) {
+}
+
+WorkloadPhases::~WorkloadPhases() {
+  Stop();
+}
+
+void WorkloadPhases::Start(Measurements &measurements) {
+  Stop();
+  stop_ = false;
+  current_.store(0, std::memory_order_release);
+  driver_ = std::thread(&WorkloadPhases::Run, this, std::ref(measurements));
+}
+
+void WorkloadPhases::Stop() {
+  if (!driver_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  driver_.join();
+}
+
+void WorkloadPhases::Run(Measurements &measurements) {
+  using clock = std::chrono::steady_clock;
+  clock::time_point phase_start = clock::now();
+  Measurements::Totals phase_totals = measurements.GetTotals();
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (size_t phase = 0; ; phase = (phase + 1) % names_.size()) {
+    std::cout << "Starting phase " << phase + 1 << "/" << names_.size() << " (" << names_[phase]
+              << ")" << std::endl;
+    auto length = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(seconds_[phase]));
+    bool stopped = false;
+    for (int step = 0; step < steps_ && !stopped; ++step) {
+      current_.store(phase * steps_ + step, std::memory_order_release);
+      stopped = stop_cv_.wait_until(lock, phase_start + length * (step + 1) / steps_,
+                                    [this] { return stop_; });
+    }
+    clock::time_point phase_end = stopped ? clock::now() : phase_start + length;
+    Measurements::Totals totals = measurements.GetTotals();
+    std::cout << "Phase " << phase + 1 << "/" << names_.size() << " (" << names_[phase] << "), "
+              << std::chrono::duration<double>(phase_end - phase_start).count() << " sec: "
+              << Measurements::GetIntervalMsg(phase_totals, totals) << std::endl;
+    if (stopped) {
+      return;
+    }
+    phase_start = phase_end;
+    phase_totals = totals;
+  }
+}
+
+} // benchmark
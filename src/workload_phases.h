@@ -0,0 +1,80 @@
+#ifndef WORKLOAD_PHASES_H_
+#define WORKLOAD_PHASES_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parse_config.h"
+
+namespace benchmark {
+
+class Measurements;
+
+///
+/// The phases of a workload whose config has a phases line, e.g.
+///   {"name": "phases", "values": ["peak.json", "night.json"], "weights": [600, 1200]}
+/// Each value is a config file whose lines replace the workload config's
+/// during one phase, relative to the workload config unless absolute, and its
+/// weight is the phase's length in seconds. Each experiment runs the phases in
+/// order from its start, starting over after the last.
+///
+/// With steps > 1, each phase moves from its own weights to the next phase's
+/// in that many equal steps, e.g. to follow a diurnal curve through hourly
+/// phases. A line whose values differ between the two phases switches at the
+/// boundary instead.
+///
+/// The config of every step (a mix) is built up front and never changed, so
+/// switching mixes is an atomic store that client threads see on their next
+/// draw, without locking or pausing them.
+///
+class WorkloadPhases {
+ public:
+  /// Null if @param config, read from @param config_path, has no phases line.
+  /// @param prepare is applied to each phase's config before mixes are built.
+  /// Throws std::invalid_argument for an invalid phases line.
+  static std::unique_ptr<WorkloadPhases> FromConfig(
+      ConfigParser const &config, std::string const &config_path, int steps,
+      std::function<void(ConfigParser &)> const &prepare);
+
+  ~WorkloadPhases();
+
+  /// The config to draw requests from now.
+  ConfigParser &Current() {
+    return *mixes_[current_.load(std::memory_order_acquire)];
+  }
+
+  /// Restarts from the first phase, switching mixes on a thread of its own.
+  /// As each phase ends, prints its operations as reported to
+  /// @param measurements.
+  void Start(Measurements &measurements);
+
+  /// Stops switching, printing the operations of the phase in progress.
+  void Stop();
+
+ private:
+  WorkloadPhases(std::vector<std::string> names, std::vector<double> seconds, int steps);
+
+  void Run(Measurements &measurements);
+
+  std::vector<std::string> const names_;
+  std::vector<double> const seconds_;
+  int const steps_;
+  // steps_ mixes for each phase, in order
+  std::vector<std::unique_ptr<ConfigParser>> mixes_;
+  std::atomic<size_t> current_{0};
+
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_ = false;
+  std::thread driver_;
+};
+
+} // benchmark
+
+#endif // WORKLOAD_PHASES_H_